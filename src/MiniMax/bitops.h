@@ -18,4 +18,38 @@ static inline int CTZ64(uint64_t x)
 }
 #endif
 
+/* Cell index of the lowest set bit of a non-zero cell mask. */
+static inline int lowestCell(uint64_t cells)
+{
+#ifdef HAS_CTZ64
+    return CTZ64(cells);
+#else
+    int cell = 0;
+    while (!(cells & 1))
+    {
+        cells >>= 1;
+        cell++;
+    }
+    return cell;
+#endif
+}
+
+/* Portable population count for 64-bit integers */
+#if defined(__GNUC__) || defined(__clang__)
+#define POPCOUNT64(x) __builtin_popcountll(x)
+#elif defined(_MSC_VER) && defined(_WIN64)
+#define POPCOUNT64(x) ((int)__popcnt64(x))
+#else
+static inline int POPCOUNT64(uint64_t x)
+{
+    int count = 0;
+    while (x)
+    {
+        x &= x - 1;
+        count++;
+    }
+    return count;
+}
+#endif
+
 #endif
@@ -0,0 +1,110 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/*
+ * Portable read-only file mapping
+ * -------------------------------
+ * Maps a whole file into memory for the tablebase and the opening book, so
+ * lookups read the page cache in place and processes that open the same
+ * file share one copy:
+ *  - CreateFileMapping/MapViewOfFile on Windows
+ *  - mmap(PROT_READ, MAP_SHARED) elsewhere; translation units including
+ *    this header must define _POSIX_C_SOURCE (200112L or later) before any
+ *    system header
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef struct
+{
+    const void *data; /* NULL while nothing is mapped */
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+/* Unmap the file. Safe to call on a zeroed or already closed MappedFile. */
+static inline void mapped_file_close(MappedFile *map)
+{
+#ifdef _WIN32
+    if (map->data != NULL)
+        UnmapViewOfFile(map->data);
+    if (map->mapping != NULL)
+        CloseHandle(map->mapping);
+    if (map->file != NULL && map->file != INVALID_HANDLE_VALUE)
+        CloseHandle(map->file);
+    map->file = NULL;
+    map->mapping = NULL;
+#else
+    if (map->data != NULL)
+        munmap((void *)(uintptr_t)map->data, map->size);
+#endif
+    map->data = NULL;
+    map->size = 0;
+}
+
+/*
+ * Map path read-only; files shorter than min_size are rejected.
+ * Returns 0 on success, -1 on error (map is left closed).
+ */
+static inline int mapped_file_open(MappedFile *map, const char *path, size_t min_size)
+{
+    map->data = NULL;
+    map->size = 0;
+#ifdef _WIN32
+    map->mapping = NULL;
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if (map->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(map->file, &size) ||
+        size.QuadPart < (LONGLONG)min_size || size.QuadPart == 0)
+    {
+        mapped_file_close(map);
+        return -1;
+    }
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (map->mapping != NULL)
+        map->data = MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (map->data == NULL)
+    {
+        mapped_file_close(map);
+        return -1;
+    }
+    map->size = (size_t)size.QuadPart;
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)min_size || info.st_size == 0)
+    {
+        close(fd);
+        return -1;
+    }
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); /* The mapping keeps the file referenced */
+    if (data == MAP_FAILED)
+        return -1;
+    map->data = data;
+    map->size = (size_t)info.st_size;
+    return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,602 @@
+/*
+ * Monte Carlo Tree Search
+ * -----------------------
+ * See mcts.h for the API.
+ *
+ * Each playout descends the tree from the root by UCB1, expands the leaf it
+ * reaches once it has been visited MCTS_EXPAND_VISITS times, finishes the game
+ * with random moves and adds the result to every node on the path. A node's
+ * statistics are kept for the side that moved into it, so a parent picks the
+ * child with the best average for itself.
+ *
+ * Move generation follows the minimax engine: a side that can complete a
+ * line has won, a single opponent threat leaves only the block, two threats
+ * lose, and a position without a line either side can complete is a draw.
+ * Such nodes are decided when expanded and never played out again. A parent
+ * with a winning child, or with only losing children, is decided as well, so
+ * forced wins and losses propagate to the root.
+ *
+ * Threads share the tree without locks: statistics are atomic counters, and
+ * a node is expanded by the thread that moves it from leaf to expanding; the
+ * others keep playing out from it until its children are published.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "mcts.h"
+#include "search.h"
+#include "bitops.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Cells of the board (1ULL << 64 is undefined, hence the 8x8 case) */
+#if MAX_MOVES == 64
+#define MCTS_BOARD_CELLS (~0ULL)
+#else
+#define MCTS_BOARD_CELLS ((1ULL << MAX_MOVES) - 1)
+#endif
+
+/* Visits a leaf needs before it is expanded (keeps the tree small on 8x8) */
+#define MCTS_EXPAND_VISITS 8
+
+/* UCB1 exploration constant for rewards scaled to 0..1 */
+#define MCTS_EXPLORATION 1.0
+
+/* Playouts between two clock reads of each thread (power of two) */
+#define MCTS_TIME_CHECK_INTERVAL 64
+
+/* Playout cap of any search: node rewards (2 per win) must fit in an int */
+#define MCTS_MAX_PLAYOUTS (INT_MAX / 2 - MAX_SEARCH_THREADS)
+
+/* Playout results for one side; a node's reward sums them */
+enum
+{
+    MCTS_OPEN = -1, /* Not decided */
+    MCTS_LOSS = 0,
+    MCTS_DRAW = 1,
+    MCTS_WIN = 2
+};
+
+/* Expansion state of a node */
+enum
+{
+    MCTS_NODE_LEAF = 0,
+    MCTS_NODE_EXPANDING = 1,
+    MCTS_NODE_EXPANDED = 2
+};
+
+/*
+ * Tree node. visits, reward, state and outcome are accessed atomically;
+ * first_child and child_count are written before state becomes expanded and
+ * read only after.
+ */
+struct MctsNode
+{
+    int visits;      /* Descents through the node, counted on the way down */
+    int reward;      /* Sum of results for the side that moved into the node */
+    int first_child; /* Pool index of the first child */
+    int state;       /* MCTS_NODE_LEAF, _EXPANDING or _EXPANDED */
+    int outcome;     /* Decided result for the side that moved in, or MCTS_OPEN */
+    uint8_t cell;    /* Cell of the move into the node */
+    uint8_t child_count;
+    uint8_t padding[2];
+};
+
+_Static_assert(sizeof(MctsNode) == 24, "MctsNode must stay 24 bytes");
+
+/* Shared state of one search. */
+typedef struct
+{
+    MctsTree *tree;    /* The engine's node pool */
+    Bitboard board;    /* Root position */
+    LineCounts lines;  /* Root line counts */
+    char player;       /* Side to move at the root */
+    int stop;          /* Atomic: set once a limit is reached or the root is decided */
+    int playouts;      /* Atomic: playouts started */
+    int max_playouts;
+    double max_seconds; /* <= 0 = unlimited */
+    HiResTimer start;
+} MctsSearch;
+
+/* Arguments for one helper thread. */
+typedef struct
+{
+    MctsSearch *search;
+    uint64_t seed;
+} MctsWorker;
+
+void mcts_tree_init_r(MctsTree *tree, size_t max_bytes)
+{
+    mcts_tree_free_r(tree);
+
+    size_t capacity = max_bytes / sizeof(MctsNode);
+    if (capacity < MAX_MOVES + 1)
+        capacity = MAX_MOVES + 1;
+    if (capacity > INT_MAX / 2)
+        capacity = INT_MAX / 2;
+
+    tree->nodes = (MctsNode *)malloc(capacity * sizeof(MctsNode));
+    if (tree->nodes == NULL)
+    {
+        fprintf(stderr, "Warning: Failed to allocate MCTS tree (%zu bytes)\n", capacity * sizeof(MctsNode));
+        return;
+    }
+    tree->capacity = (int)capacity;
+}
+
+void mcts_tree_free_r(MctsTree *tree)
+{
+    free(tree->nodes);
+    tree->nodes = NULL;
+    tree->capacity = 0;
+    tree->next = 0;
+}
+
+void mcts_tree_free(void)
+{
+    mcts_tree_free_r(&engineDefault()->mcts_tree);
+}
+
+/* Allocate engine's pool within its memory cap on first use. Returns 0 if there is none. */
+static int mctsTreeReady(HyperPruneEngine *engine)
+{
+    if (engine->mcts_tree.nodes == NULL)
+        mcts_tree_init_r(&engine->mcts_tree, engine->mcts_memory);
+    return engine->mcts_tree.nodes != NULL;
+}
+
+/* xorshift64*: one 64-bit random number per call (state must be non-zero). */
+static inline uint64_t mctsRandom(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545f4914f6cdd1dULL;
+}
+
+/* Place player's piece on cell in board and lines. */
+static inline void mctsMakeMove(Bitboard *board, LineCounts *lines, int cell, char player)
+{
+    int row = BIT_TO_ROW(cell);
+    int col = BIT_TO_COL(cell);
+    bitboard_make_move(board, row, col, player);
+    line_counts_make(lines, row, col, player);
+}
+
+/*
+ * Finish the game with random moves. Returns the result for player, the side
+ * to move. Threats are played as the search plays them (win at once, block a
+ * single threat, lose to two), so no move needs a win check: a line is only
+ * ever completed by a side that had a threat on it.
+ */
+static int mctsPlayout(Bitboard board, LineCounts *lines, char player, uint64_t *rng)
+{
+    char start = player;
+    uint8_t cells[MAX_MOVES];
+    int count = 0;
+    for (uint64_t empty = ~(board.x_pieces | board.o_pieces) & MCTS_BOARD_CELLS; empty; empty &= empty - 1)
+        cells[count++] = (uint8_t)lowestCell(empty);
+
+    /* Random cells are drawn lazily from cells[next..count), two per 64-bit number */
+    uint64_t random = 0;
+    int available = 0;
+    int next = 0;
+
+    for (;;)
+    {
+        int p = (player == 'x') ? 0 : 1;
+        char opponent = p ? 'x' : 'o';
+        if (lines->threats[p])
+            return (player == start) ? MCTS_WIN : MCTS_LOSS;
+        if (lines->live == 0)
+            return MCTS_DRAW;
+
+        uint64_t occupied = board.x_pieces | board.o_pieces;
+        int cell;
+        if (lines->threats[1 - p])
+        {
+            uint64_t opponent_pieces = p ? board.x_pieces : board.o_pieces;
+            uint64_t blocks = line_counts_threat_cells(lines, opponent, opponent_pieces);
+            if (blocks & (blocks - 1))
+                return (player == start) ? MCTS_LOSS : MCTS_WIN;
+            cell = lowestCell(blocks);
+        }
+        else
+        {
+            /* A live line that is not complete has an empty cell, so this ends */
+            do
+            {
+                if (available == 0)
+                {
+                    random = mctsRandom(rng);
+                    available = 2;
+                }
+                uint64_t r = random & 0xffffffffULL;
+                random >>= 32;
+                available--;
+
+                int pick = next + (int)((r * (uint64_t)(count - next)) >> 32);
+                uint8_t swap = cells[pick];
+                cells[pick] = cells[next];
+                cells[next] = swap;
+                cell = cells[next++];
+            } while (occupied & (1ULL << cell)); /* Already played as a block */
+        }
+
+        mctsMakeMove(&board, lines, cell, player);
+        player = opponent;
+    }
+}
+
+/* Reserve count consecutive nodes. Returns the first index, or -1 if the pool is full. */
+static int mctsAllocate(MctsTree *tree, int count)
+{
+    if (atomic_load_int(&tree->next) > tree->capacity - count)
+        return -1;
+    int first = atomic_fetch_add_int(&tree->next, count);
+    return (first <= tree->capacity - count) ? first : -1;
+}
+
+static void mctsNodeInit(MctsNode *node, int cell)
+{
+    node->visits = 0;
+    node->reward = 0;
+    node->first_child = 0;
+    node->state = MCTS_NODE_LEAF;
+    node->outcome = MCTS_OPEN;
+    node->cell = (uint8_t)cell;
+    node->child_count = 0;
+}
+
+/*
+ * Expand a node claimed by this thread (state expanding), player to move.
+ * Returns the node's decided outcome, or MCTS_OPEN after publishing its
+ * children (none if the pool is full: the node then stays a playout leaf).
+ */
+static int mctsExpand(MctsTree *tree, MctsNode *node, Bitboard board, const LineCounts *lines, char player)
+{
+    int p = (player == 'x') ? 0 : 1;
+    uint64_t occupied = board.x_pieces | board.o_pieces;
+    uint64_t cells = 0;
+    int outcome = MCTS_OPEN;
+
+    if (lines->threats[p])
+    {
+        outcome = MCTS_LOSS; /* The side to move completes a line */
+    }
+    else if (lines->threats[1 - p])
+    {
+        uint64_t opponent_pieces = p ? board.x_pieces : board.o_pieces;
+        cells = line_counts_threat_cells(lines, p ? 'x' : 'o', opponent_pieces);
+        if (cells & (cells - 1))
+            outcome = MCTS_WIN; /* Two threats: one of them completes */
+    }
+    else if (lines->live == 0)
+    {
+        outcome = MCTS_DRAW;
+    }
+    else
+    {
+        cells = ~occupied & MCTS_BOARD_CELLS & line_counts_live_cells(lines);
+        if (POPCOUNT64(occupied) < BOARD_SIZE)
+            cells = bitboard_unique_cells(cells, bitboard_symmetries(board));
+    }
+
+    if (outcome == MCTS_OPEN)
+    {
+        int count = POPCOUNT64(cells);
+        int first = mctsAllocate(tree, count);
+        if (first >= 0)
+        {
+            for (int i = 0; cells; i++, cells &= cells - 1)
+                mctsNodeInit(&tree->nodes[first + i], lowestCell(cells));
+            node->first_child = first;
+            node->child_count = (uint8_t)count;
+        }
+    }
+    else
+    {
+        atomic_store_int(&node->outcome, outcome);
+    }
+
+    /* Release: children are initialized before other threads can see them */
+    atomic_compare_exchange_int(&node->state, MCTS_NODE_EXPANDING, MCTS_NODE_EXPANDED);
+    return outcome;
+}
+
+/*
+ * Pick the child of an expanded node to descend into by UCB1 (the first
+ * unvisited child if there is one). Sets *out_decided to the node's outcome
+ * if its children decide it: a winning child wins, only losing ones lose.
+ */
+static int mctsSelect(const MctsTree *tree, const MctsNode *node, int *out_decided)
+{
+    const MctsNode *children = &tree->nodes[node->first_child];
+    double log_visits = log((double)atomic_load_int(&node->visits));
+    int best = 0;
+    double best_value = -1.0;
+    int all_lost = 1;
+    *out_decided = MCTS_OPEN;
+
+    for (int i = 0; i < node->child_count; i++)
+    {
+        int outcome = atomic_load_int(&children[i].outcome);
+        if (outcome == MCTS_WIN)
+        {
+            *out_decided = MCTS_LOSS;
+            return i;
+        }
+        if (outcome != MCTS_LOSS)
+            all_lost = 0;
+
+        int visits = atomic_load_int(&children[i].visits);
+        if (visits == 0)
+            return i;
+
+        double mean = (double)atomic_load_int(&children[i].reward) / (2.0 * visits);
+        double value = mean + MCTS_EXPLORATION * sqrt(log_visits / visits);
+        if (value > best_value)
+        {
+            best_value = value;
+            best = i;
+        }
+    }
+
+    if (all_lost)
+        *out_decided = MCTS_WIN;
+    return best;
+}
+
+/* Run one playout: descend, expand, play out and back up the result. */
+static void mctsIterate(const MctsSearch *s, uint64_t *rng)
+{
+    int path[MAX_MOVES + 1];
+    int length = 0;
+    Bitboard board = s->board;
+    LineCounts lines = s->lines;
+    char player = s->player;
+    int index = 0;
+    int result; /* For the side that moved into the last node of path */
+
+    MctsNode *nodes = s->tree->nodes;
+
+    for (;;)
+    {
+        MctsNode *node = &nodes[index];
+        int visits = atomic_fetch_add_int(&node->visits, 1);
+        path[length++] = index;
+
+        result = atomic_load_int(&node->outcome);
+        if (result != MCTS_OPEN)
+            break;
+
+        int state = atomic_load_acquire_int(&node->state);
+        if (state == MCTS_NODE_LEAF && visits >= MCTS_EXPAND_VISITS &&
+            atomic_compare_exchange_int(&node->state, MCTS_NODE_LEAF, MCTS_NODE_EXPANDING))
+        {
+            result = mctsExpand(s->tree, node, board, &lines, player);
+            if (result != MCTS_OPEN)
+                break;
+            state = MCTS_NODE_EXPANDED;
+        }
+
+        if (state != MCTS_NODE_EXPANDED || node->child_count == 0)
+        {
+            result = MCTS_WIN - mctsPlayout(board, &lines, player, rng);
+            break;
+        }
+
+        int decided;
+        int child = mctsSelect(s->tree, node, &decided);
+        if (decided != MCTS_OPEN)
+        {
+            atomic_store_int(&node->outcome, decided);
+            result = decided;
+            break;
+        }
+
+        index = node->first_child + child;
+        mctsMakeMove(&board, &lines, nodes[index].cell, player);
+        player = (player == 'x') ? 'o' : 'x';
+    }
+
+    /* Results alternate between the two sides on the way up */
+    while (length > 0)
+    {
+        atomic_fetch_add_int(&nodes[path[--length]].reward, result);
+        result = MCTS_WIN - result;
+    }
+}
+
+/* Playout loop of one thread until the search stops. */
+static void mctsRun(MctsSearch *s, uint64_t seed)
+{
+    uint64_t rng = seed;
+    for (int n = 1;; n++)
+    {
+        if (atomic_load_int(&s->stop) || atomic_load_int(&s->tree->nodes[0].outcome) != MCTS_OPEN)
+            break;
+        if (atomic_fetch_add_int(&s->playouts, 1) >= s->max_playouts)
+            break;
+
+        mctsIterate(s, &rng);
+
+        if (s->max_seconds > 0 && (n & (MCTS_TIME_CHECK_INTERVAL - 1)) == 0)
+        {
+            HiResTimer now;
+            if (timer_get(&now) == 0 && timer_diff_seconds(&s->start, &now) >= s->max_seconds)
+                break;
+        }
+    }
+    atomic_store_int(&s->stop, 1);
+}
+
+THREAD_FUNC(mctsWorkerMain, arg)
+{
+    MctsWorker *worker = (MctsWorker *)arg;
+    mctsRun(worker->search, worker->seed);
+    THREAD_RETURN;
+}
+
+/* Non-zero random state for thread t (splitmix64 of t). */
+static uint64_t mctsSeed(int t)
+{
+    uint64_t z = ((uint64_t)t + 1) * 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+/* Return a move decided without a search in out_result. */
+static void mctsForcedMove(MctsResult *out_result, int cell, int score, int proven)
+{
+    out_result->row = BIT_TO_ROW(cell);
+    out_result->col = BIT_TO_COL(cell);
+    out_result->score = score;
+    out_result->proven = proven;
+}
+
+void getAiMoveMcts(Bitboard board, char aiPlayer, const SearchLimits *limits, MctsResult *out_result)
+{
+    engineGetAiMoveMcts(engineDefault(), board, aiPlayer, limits, out_result);
+}
+
+void engineGetAiMoveMcts(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const SearchLimits *limits,
+                         MctsResult *out_result)
+{
+    *out_result = (MctsResult){-1, -1, 0, 0, 0, 0, 0.0};
+
+    uint64_t occupied = board.x_pieces | board.o_pieces;
+    if ((board.x_pieces & board.o_pieces) || bitboard_has_won(board.x_pieces) ||
+        bitboard_has_won(board.o_pieces) || (occupied & MCTS_BOARD_CELLS) == MCTS_BOARD_CELLS)
+        return;
+
+    if (occupied == 0)
+    {
+        /* Same opening as getAiMove, not searched */
+        out_result->row = BOARD_SIZE / 2;
+        out_result->col = BOARD_SIZE / 2;
+        return;
+    }
+
+    uint64_t empty = ~occupied & MCTS_BOARD_CELLS;
+    uint64_t own = (aiPlayer == 'x') ? board.x_pieces : board.o_pieces;
+    uint64_t opponent = (aiPlayer == 'x') ? board.o_pieces : board.x_pieces;
+    uint64_t wins = bitboard_threat_cells(own, empty);
+    uint64_t blocks = bitboard_threat_cells(opponent, empty);
+    if (wins)
+    {
+        mctsForcedMove(out_result, lowestCell(wins), AI_WIN_SCORE, 1);
+        return;
+    }
+    if (blocks)
+    {
+        /* The only move that does not lose at once (two threats lose anyway) */
+        int lost = (blocks & (blocks - 1)) != 0;
+        mctsForcedMove(out_result, lowestCell(blocks), lost ? PLAYER_WIN_SCORE : TIE_SCORE, lost);
+        return;
+    }
+    if (!mctsTreeReady(engine))
+    {
+        mctsForcedMove(out_result, lowestCell(empty), TIE_SCORE, 0);
+        return;
+    }
+
+    MctsTree *tree = &engine->mcts_tree;
+    MctsSearch s;
+    s.tree = tree;
+    s.board = board;
+    line_counts_init(&s.lines, board);
+    s.player = aiPlayer;
+    s.stop = 0;
+    s.playouts = 0;
+    s.max_playouts = MCTS_MAX_PLAYOUTS;
+    s.max_seconds = 0.0;
+    if (limits != NULL)
+    {
+        if (limits->max_nodes != 0 && limits->max_nodes < (uint64_t)MCTS_MAX_PLAYOUTS)
+            s.max_playouts = (int)limits->max_nodes;
+        s.max_seconds = (double)limits->max_time_ms / 1000.0;
+    }
+    if (s.max_seconds <= 0 && s.max_playouts == MCTS_MAX_PLAYOUTS)
+        s.max_playouts = MCTS_DEFAULT_PLAYOUTS;
+    int timed = (timer_get(&s.start) == 0);
+    if (!timed && s.max_seconds > 0)
+    {
+        s.max_seconds = 0; /* No clock: fall back to the playout limit */
+        if (s.max_playouts == MCTS_MAX_PLAYOUTS)
+            s.max_playouts = MCTS_DEFAULT_PLAYOUTS;
+    }
+
+    if (s.lines.live == 0)
+    {
+        /* Every line is blocked: any move ties */
+        mctsForcedMove(out_result, lowestCell(empty), TIE_SCORE, 1);
+        return;
+    }
+
+    /* The root is expanded up front; it is never decided here (see above) */
+    tree->next = 1;
+    mctsNodeInit(&tree->nodes[0], 0);
+    tree->nodes[0].state = MCTS_NODE_EXPANDING;
+    mctsExpand(tree, &tree->nodes[0], board, &s.lines, aiPlayer);
+
+    MctsWorker workers[MAX_SEARCH_THREADS];
+    ThreadHandle handles[MAX_SEARCH_THREADS];
+    int started = 0;
+    for (int t = 1; t < engine->thread_count; t++)
+    {
+        workers[started] = (MctsWorker){&s, mctsSeed(t)};
+        /* Thread creation failure only costs playouts, never correctness */
+        if (thread_create(&handles[started], mctsWorkerMain, &workers[started]) != 0)
+            break;
+        started++;
+    }
+    mctsRun(&s, mctsSeed(0));
+    for (int t = 0; t < started; t++)
+        thread_join(handles[t]);
+
+    /* A proven win first, otherwise the most visited move */
+    const MctsNode *root = &tree->nodes[0];
+    const MctsNode *children = &tree->nodes[root->first_child];
+    int best = 0;
+    for (int i = 0; i < root->child_count; i++)
+    {
+        if (children[i].outcome == MCTS_WIN)
+        {
+            best = i;
+            break;
+        }
+        if (children[i].visits > children[best].visits)
+            best = i;
+    }
+
+    const MctsNode *chosen = &children[best];
+    int score = (chosen->visits > 0) ? (int)lround(100.0 * chosen->reward / chosen->visits) - 100 : 0;
+    if (score > HEURISTIC_LIMIT)
+        score = HEURISTIC_LIMIT;
+    if (score < -HEURISTIC_LIMIT)
+        score = -HEURISTIC_LIMIT;
+    if (chosen->outcome == MCTS_WIN)
+        mctsForcedMove(out_result, chosen->cell, AI_WIN_SCORE, 1);
+    else if (root->outcome == MCTS_WIN)
+        mctsForcedMove(out_result, chosen->cell, PLAYER_WIN_SCORE, 1);
+    else
+        mctsForcedMove(out_result, chosen->cell, score, 0);
+
+    out_result->playouts = (uint64_t)((s.playouts < s.max_playouts) ? s.playouts : s.max_playouts);
+    out_result->nodes = (uint64_t)((tree->next < tree->capacity) ? tree->next : tree->capacity);
+    if (timed)
+    {
+        HiResTimer end;
+        if (timer_get(&end) == 0)
+            out_result->seconds = timer_diff_seconds(&s.start, &end);
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Monte Carlo Tree Search (UCT)
+ * -----------------------------
+ * An anytime engine for boards where perfect play does not finish (7x7,
+ * 8x8): instead of proving a value, it plays random games from the current
+ * position and grows a search tree towards the moves that win them most
+ * often (UCB1 selection).
+ *
+ * Key components:
+ *  - Random playouts on bitboards with the per-line counts of the minimax
+ *    engine: a side that can complete a line wins, a single threat is
+ *    blocked, and a game where no line can be completed stops as a draw
+ *  - Empty cells are drawn two per 64-bit random number
+ *  - Tree parallelism: every thread from setSearchThreads descends the same
+ *    tree; a visit is counted on the way down (virtual loss), so concurrent
+ *    threads spread over different moves
+ *  - A node pool limited to a memory cap; when full, the tree stops growing
+ *    and the remaining playouts start from its leaves
+ *
+ * Usage:
+ *  1. Call init_win_masks() once at program startup
+ *  2. Optionally call setMctsMemory(bytes) to set the memory cap
+ *     (otherwise MCTS_DEFAULT_MEMORY is allocated on first use)
+ *  3. Call getAiMoveMcts(...) with a time and/or playout budget
+ *  4. Call mcts_tree_free() at program exit
+ *
+ * Every HyperPruneEngine owns its node pool, so engineGetAiMoveMcts may run
+ * on different engines concurrently; one call per engine at a time.
+ */
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../TicTacToe/tic_tac_toe.h"
+#include "mini_max.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Tree memory used when none was configured: 64 MiB */
+#define MCTS_DEFAULT_MEMORY ((size_t)64 << 20)
+
+/* Playouts per move when neither a time nor a playout budget is given */
+#define MCTS_DEFAULT_PLAYOUTS 100000
+
+    /** Outcome of a getAiMoveMcts search. */
+    typedef struct
+    {
+        int row;            /* Selected move, -1 if the game is already over */
+        int col;
+        int score;          /* AI's view: average playout result in -100..100 */
+        int proven;         /* Non-zero if the tree proved the move wins (or every move loses) */
+        uint64_t playouts;  /* Tree descents, each ending in a random game or a decided node */
+        uint64_t nodes;     /* Tree nodes allocated */
+        double seconds;     /* Wall-clock time of the search */
+    } MctsResult;
+
+    typedef struct MctsNode MctsNode;
+
+    /** Node pool of an engine's searches, reset for every search; index 0 is the root. */
+    typedef struct MctsTree
+    {
+        MctsNode *nodes; /* NULL until allocated */
+        int capacity;
+        int next; /* Atomic: next free index (may pass capacity) */
+    } MctsTree;
+
+    /**
+     * Allocate tree within max_bytes (at least one root and its children).
+     * Replaces any existing pool.
+     */
+    void mcts_tree_init_r(MctsTree *tree, size_t max_bytes);
+
+    /**
+     * Free tree. Safe to call even if it was never allocated.
+     */
+    void mcts_tree_free_r(MctsTree *tree);
+
+    /**
+     * Free the default engine's node pool.
+     * Safe to call even if it was never allocated.
+     */
+    void mcts_tree_free(void);
+
+    /**
+     * Compute the AI's next move with Monte Carlo Tree Search.
+     *
+     * Parameters:
+     *  - board:      Current position (bitboard representation)
+     *  - aiPlayer:   The AI symbol ('x' or 'o') to move
+     *  - limits:     Time budget and playout budget (max_nodes counts
+     *                playouts); NULL or all zero: MCTS_DEFAULT_PLAYOUTS
+     *  - out_result: Move, score, playouts, tree size and elapsed time
+     *
+     * Behavior:
+     *  - Terminal or invalid board: row/col -1
+     *  - Empty board: center without searching, like getAiMove
+     *  - An immediate win, or the only cell that blocks one, is played
+     *    without searching
+     *  - Otherwise selects the most visited root move (a proven win first)
+     *  - Runs on getSearchThreads() threads; with one thread the result
+     *    of a playout budget is deterministic
+     *  - getRootMoveScores is not affected
+     */
+    void getAiMoveMcts(Bitboard board, char aiPlayer, const SearchLimits *limits,
+                       MctsResult *out_result);
+
+    /* getAiMoveMcts on an explicit engine: its thread count and node pool. */
+    void engineGetAiMoveMcts(HyperPruneEngine *engine, Bitboard board, char aiPlayer,
+                             const SearchLimits *limits, MctsResult *out_result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,42 +3,40 @@
  * -------------------------------------------------------
  *
  * This file implements a deterministic Minimax engine with:
- *  - Alpha–beta pruning
+ *  - Alpha–beta pruning in negamax form (scores relative to the side to
+ *    move), optionally as Principal Variation Search (NegaScout):
+ *    later siblings get a null window and are re-searched only when they
+ *    might be better
  *  - Terminal-only scoring (win/loss/tie evaluation)
  *  - Simple opening heuristic: play center on empty board
  *  - Transposition table with Zobrist hashing for position caching
+ *  - Optional parallel search: Lazy SMP, Young Brothers Wait tree
+ *    splitting or root splitting (see parallel_search.c)
+ *  - Budgeted iterative deepening with a static line evaluation at the
+ *    horizon (getAiMoveBudgeted)
+ *  - Outcome-only solver: the root asks "can I win?" and "can I avoid
+ *    losing?" as two null-window searches instead of one full window
+ *  - Depth-first proof-number search as an alternative root engine
+ *    (see proof_number.c)
  *
- * Public entry point: getAiMove(...)
+ *  - Reentrant engines: all state lives in a HyperPruneEngine; the public
+ *    functions without an engine argument use the default engine
+ *
+ * Public entry points: getAiMove(...), getAiMoveBudgeted(...) and their
+ * engine* versions
  */
 
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include "mini_max.h"
+#include "search.h"
 #include "transposition.h"
 #include "bitops.h"
 #include <stdint.h>
-
-/* A single board coordinate (row, col). */
-typedef struct
-{
-    int row;
-    int col;
-} Move;
-
-/* A trivial fixed-size container for generated legal moves. */
-typedef struct
-{
-    int count;
-    Move moves[MAX_MOVES];
-} MoveList;
-
-/* Helper constants used by the evaluation and search. */
-typedef enum
-{
-    AI_WIN_SCORE = 100,
-    PLAYER_WIN_SCORE = -100,
-    TIE_SCORE = 0,
-    CONTINUE_SCORE = 1,
-    INF = 101
-} HelperScores;
+#include <stdlib.h>
+#include <string.h>
 
 /* Compile-time validation: terminal scores must fit in int16_t (transposition table storage) */
 _Static_assert(AI_WIN_SCORE <= INT16_MAX && AI_WIN_SCORE >= INT16_MIN,
@@ -56,31 +54,57 @@ static const uint64_t VALID_POSITIONS_MASK = ~0ULL;
 static const uint64_t VALID_POSITIONS_MASK = (1ULL << MAX_MOVES) - 1;
 #endif
 
-/* Collect all empty cells using bit scanning. */
-static void findEmptySpots(Bitboard board, MoveList *out_emptySpots)
-{
-    out_emptySpots->count = 0;
+/* Build-time default for setSearchAlgorithm (-DUSE_PVS=1 selects PVS). */
+#ifndef USE_PVS
+#define USE_PVS 0
+#endif
 
-    uint64_t empty = ~(board.x_pieces | board.o_pieces);
-    empty &= VALID_POSITIONS_MASK; /* Mask valid positions */
+/*
+ * Default of symmetric hashing: symmetric positions are common enough to pay
+ * for the 8 hash updates per move only on small boards.
+ */
+#define SYMMETRIC_HASHING_DEFAULT (BOARD_SIZE <= 4)
+
+/* Default of setSolutionTable: the built-in table exists for 3x3 only. */
+#define SOLUTION_TABLE_DEFAULT (BOARD_SIZE == 3)
+
+/*
+ * Nodes with fewer pieces than this search one move per group of cells that
+ * a symmetry of the position maps onto each other. Later positions are
+ * rarely symmetric, so deeper nodes skip the test.
+ */
+#ifndef SYMMETRY_PRUNING_PLIES
+#define SYMMETRY_PRUNING_PLIES BOARD_SIZE
+#endif
+
+/* History scores are halved once a cell reaches this value. */
+#define HISTORY_LIMIT (1u << 30)
+
+/* Engine of the functions without an engine argument; keys set on first use. */
+static HyperPruneEngine default_engine;
+
+/* Collect the cells of a bitmask as moves, in bit order, using bit scanning. */
+static void collectMoves(uint64_t cells, MoveList *out_moves)
+{
+    out_moves->count = 0;
 
 #ifdef HAS_CTZ64
     /* Use bit scanning intrinsic */
-    while (empty)
+    while (cells)
     {
-        int bit = CTZ64(empty);
-        out_emptySpots->moves[out_emptySpots->count++] = (Move){
+        int bit = CTZ64(cells);
+        out_moves->moves[out_moves->count++] = (Move){
             .row = BIT_TO_ROW(bit),
             .col = BIT_TO_COL(bit)};
-        empty &= empty - 1; /* Clear least significant bit */
+        cells &= cells - 1; /* Clear least significant bit */
     }
 #else
     /* Fallback: iterate all positions */
     for (int i = 0; i < MAX_MOVES; i++)
     {
-        if (empty & (1ULL << i))
+        if (cells & (1ULL << i))
         {
-            out_emptySpots->moves[out_emptySpots->count++] = (Move){
+            out_moves->moves[out_moves->count++] = (Move){
                 .row = BIT_TO_ROW(i),
                 .col = BIT_TO_COL(i)};
         }
@@ -88,22 +112,117 @@ static void findEmptySpots(Bitboard board, MoveList *out_emptySpots)
 #endif
 }
 
+/* Collect all empty cells. */
+static void findEmptySpots(Bitboard board, MoveList *out_emptySpots)
+{
+    uint64_t empty = ~(board.x_pieces | board.o_pieces);
+    empty &= VALID_POSITIONS_MASK; /* Mask valid positions */
+    collectMoves(empty, out_emptySpots);
+}
+
+/* Rotate a move list left by offset positions (Lazy SMP order perturbation). */
+static void rotateMoves(MoveList *list, int offset)
+{
+    offset %= list->count;
+    if (offset == 0)
+        return;
+
+    Move rotated[MAX_MOVES];
+    for (int i = 0; i < list->count; i++)
+        rotated[i] = list->moves[(i + offset) % list->count];
+    for (int i = 0; i < list->count; i++)
+        list->moves[i] = rotated[i];
+}
+
+/*
+ * Order moves for the side to move at ply (pieces on the board): killers of
+ * that ply first, most recent first, then by the player's history score.
+ * Stable, so equal keys keep the generated (bit or rotated) order.
+ */
+static void orderMoves(const MoveOrdering *ordering, MoveList *list, char player, int ply)
+{
+    const uint32_t *history = ordering->history[player == 'x' ? 0 : 1];
+    const uint8_t *killers = ordering->killers[ply];
+    uint64_t keys[MAX_MOVES];
+
+    for (int i = 0; i < list->count; i++)
+    {
+        Move move = list->moves[i];
+        int cell = POS_TO_BIT(move.row, move.col);
+        uint64_t key = history[cell];
+        if (killers[0] == cell + 1)
+            key += 2ULL * HISTORY_LIMIT;
+        else if (killers[1] == cell + 1)
+            key += HISTORY_LIMIT;
+
+        int j = i;
+        while (j > 0 && keys[j - 1] < key)
+        {
+            keys[j] = keys[j - 1];
+            list->moves[j] = list->moves[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        list->moves[j] = move;
+    }
+}
+
+/* Move the move on cell to the front of list, keeping the others' order. */
+static void moveToFront(MoveList *list, int cell)
+{
+    for (int i = 0; i < list->count; i++)
+    {
+        Move move = list->moves[i];
+        if (POS_TO_BIT(move.row, move.col) == cell)
+        {
+            for (int j = i; j > 0; j--)
+                list->moves[j] = list->moves[j - 1];
+            list->moves[0] = move;
+            return;
+        }
+    }
+}
+
+/*
+ * Remember a move that ended the search of its node early: it becomes the
+ * ply's first killer, and its history score grows by the square of the empty
+ * cell count so cutoffs near the root weigh more.
+ */
+static void recordCutoff(MoveOrdering *ordering, Move move, char player, int ply, int empty)
+{
+    uint8_t cell = (uint8_t)(POS_TO_BIT(move.row, move.col) + 1);
+    uint8_t *killers = ordering->killers[ply];
+    if (killers[0] != cell)
+    {
+        killers[1] = killers[0];
+        killers[0] = cell;
+    }
+
+    uint32_t *history = ordering->history[player == 'x' ? 0 : 1];
+    history[cell - 1] += (uint32_t)(empty * empty);
+    if (history[cell - 1] >= HISTORY_LIMIT)
+    {
+        for (int i = 0; i < MAX_MOVES; i++)
+            history[i] >>= 1;
+    }
+}
+
 /*
  * Terminal evaluation using bitboard win detection:
- *  - +100 if a line completed by aiPlayer
+ *  - +100 if a line completed by player
  *  - -100 if a line completed by opponent
  *  -  0 for tie
  *  -  1 (CONTINUE_SCORE) if the game is not terminal
  */
-static inline int boardScore(Bitboard board, char aiPlayer)
+static inline int boardScore(Bitboard board, char player)
 {
-    /* Check if AI has won */
-    uint64_t ai_pieces = (aiPlayer == 'x') ? board.x_pieces : board.o_pieces;
-    if (bitboard_has_won(ai_pieces))
+    /* Check if player has won */
+    uint64_t player_pieces = (player == 'x') ? board.x_pieces : board.o_pieces;
+    if (bitboard_has_won(player_pieces))
         return AI_WIN_SCORE;
 
     /* Check if opponent has won */
-    uint64_t opponent_pieces = (aiPlayer == 'x') ? board.o_pieces : board.x_pieces;
+    uint64_t opponent_pieces = (player == 'x') ? board.o_pieces : board.x_pieces;
     if (bitboard_has_won(opponent_pieces))
         return PLAYER_WIN_SCORE;
 
@@ -115,56 +234,302 @@ static inline int boardScore(Bitboard board, char aiPlayer)
     return CONTINUE_SCORE;
 }
 
-static int miniMaxLow(Bitboard board, char aiPlayer, int alpha, int beta, uint64_t hash);
+/*
+ * Incremental state of the position a search is working on, kept in step
+ * with its Bitboard by positionMake/positionUnmake:
+ *  - lines: per-line piece counts (terminal, dead-line and threat tests)
+ *  - hash:  Zobrist hash under every board symmetry; only keys[0] (the plain
+ *           hash) is maintained unless symmetric hashing is enabled
+ *  - keys, symmetric: the engine's Zobrist keys and symmetric hashing setting
+ */
+typedef struct
+{
+    LineCounts lines;
+    ZobristSymmetricHash hash;
+    const ZobristKeys *keys;
+    int symmetric;
+} SearchPosition;
+
+static void positionInit(SearchPosition *pos, const HyperPruneEngine *engine, Bitboard board, char player)
+{
+    line_counts_init(&pos->lines, board);
+    pos->keys = engine->keys;
+    pos->symmetric = engine->symmetric_hashing;
+    if (pos->symmetric)
+        zobrist_symmetric_hash_r(pos->keys, board, player, &pos->hash);
+    else
+        pos->hash.keys[0] = zobrist_hash_r(pos->keys, board, player);
+}
+
+/* Toggle player's piece on move and the side to move (make and unmake alike). */
+static inline void positionToggleHash(SearchPosition *pos, Move move, char player)
+{
+    if (pos->symmetric)
+    {
+        zobrist_symmetric_toggle_r(pos->keys, &pos->hash, move.row, move.col, player, 1);
+    }
+    else
+    {
+        uint64_t hash = zobrist_toggle_r(pos->keys, pos->hash.keys[0], move.row, move.col, player);
+        pos->hash.keys[0] = zobrist_toggle_turn_r(pos->keys, hash); /* Toggle turn: player → opponent */
+    }
+}
+
+static inline void positionMake(SearchPosition *pos, Move move, char player)
+{
+    line_counts_make(&pos->lines, move.row, move.col, player);
+    positionToggleHash(pos, move, player);
+}
+
+static inline void positionUnmake(SearchPosition *pos, Move move, char player)
+{
+    line_counts_unmake(&pos->lines, move.row, move.col, player);
+    positionToggleHash(pos, move, player);
+}
 
 /*
- * Maximizing ply (AI).
- * Returns best score achievable for aiPlayer from the current position.
+ * Transposition table key of pos. Moves are stored in the frame of the
+ * symmetry that produced the key (out_symmetry; 0 for the plain hash).
  */
-static int miniMaxHigh(Bitboard board, char aiPlayer, int alpha, int beta, uint64_t hash)
+static inline uint64_t positionKey(const SearchPosition *pos, int *out_symmetry)
 {
-    /* Transposition table probe */
-    int transposition_table_score;
-    if (transposition_table_probe(hash, alpha, beta, &transposition_table_score))
+    if (!pos->symmetric)
     {
-        return transposition_table_score;
+        *out_symmetry = 0;
+        return pos->hash.keys[0];
     }
+    return zobrist_canonical(&pos->hash, out_symmetry);
+}
 
-    int state = boardScore(board, aiPlayer);
+/*
+ * Terminal test of a search node, from the line counts kept by the search.
+ * Only the side that just moved can have completed a line (the game would
+ * have ended before the side to move's own last move otherwise), and its
+ * count changed only on the lines through that move's cell.
+ */
+static inline int terminalScore(Bitboard board, const LineCounts *lines, char player)
+{
+    if (lines->completed[(player == 'x') ? 1 : 0])
+        return PLAYER_WIN_SCORE;
+
+    uint64_t occupied = board.x_pieces | board.o_pieces;
+    if (occupied == VALID_POSITIONS_MASK)
+        return TIE_SCORE;
+
+    return CONTINUE_SCORE;
+}
+
+/*
+ * Static evaluation at the horizon of a depth-limited search: every line that
+ * is still open for only one side counts that side's pieces on it, positive
+ * for player. Clamped to +-HEURISTIC_LIMIT so it can never be mistaken for a
+ * proven result.
+ */
+static int heuristicScore(const LineCounts *lines, char player)
+{
+    int p = (player == 'x') ? 0 : 1;
+    int score = 0;
+
+    for (int i = 0; i < WIN_MASK_COUNT; i++)
+    {
+        int ai_count = lines->count[p][i];
+        int opponent_count = lines->count[1 - p][i];
+        if (opponent_count == 0)
+            score += ai_count;
+        else if (ai_count == 0)
+            score -= opponent_count;
+    }
+
+    if (score > HEURISTIC_LIMIT)
+        return HEURISTIC_LIMIT;
+    if (score < -HEURISTIC_LIMIT)
+        return -HEURISTIC_LIMIT;
+    return score;
+}
+
+/*
+ * Transposition table draft of a node searched depth plies deep: full when
+ * the search reaches every terminal position below it.
+ */
+static inline int searchDraft(Bitboard board, int depth)
+{
+    if (depth >= SEARCH_DEPTH_FULL)
+        return TRANSPOSITION_TABLE_DEPTH_FULL;
+
+    int empty = MAX_MOVES - POPCOUNT64(board.x_pieces | board.o_pieces);
+    return (depth >= empty) ? TRANSPOSITION_TABLE_DEPTH_FULL : depth;
+}
+
+/*
+ * Negamax ply: player is the side to move, and every score is from its point
+ * of view (AI_WIN_SCORE: player wins, PLAYER_WIN_SCORE: player loses). A
+ * child's score is the negation of the child's own result, so one function
+ * serves both sides; transposition table entries are side-relative as well.
+ * pos must match board with player to move; it is updated with every move
+ * and restored on return.
+ */
+static int negaMax(SearchContext *ctx, Bitboard board, SearchPosition *pos, char player,
+                   int alpha, int beta, int depth)
+{
+    const LineCounts *lines = &pos->lines;
+
+    /* Budget used up: unwind, the caller sees searchAborted() */
+    if (ctx->budget != NULL && searchBudgetExhausted(ctx->budget))
+        return 0;
+    SEARCH_STATS_NODE(node_stats, ctx, board);
+    SEARCH_STATS_ADD(node_stats, nodes, 1);
+
+    /*
+     * Nodes decided by their line counts alone are resolved before the
+     * transposition table and never stored: the tests take constant time, so
+     * an entry would only cost memory traffic and evict a searched node.
+     */
+    int state = terminalScore(board, lines, player);
     if (state != CONTINUE_SCORE)
     {
-        /* terminal: cache and return raw score */
-        transposition_table_store(hash, state, TRANSPOSITION_TABLE_EXACT);
+        SEARCH_STATS_ADD(node_stats, terminal, 1);
         return state;
     }
 
+    /* Every line holds both symbols: nobody can win any more */
+    if (lines->live == 0)
+    {
+        SEARCH_STATS_ADD(node_stats, terminal, 1);
+        return TIE_SCORE;
+    }
+
+    /*
+     * Threats decide the node without expanding it: a cell that completes one
+     * of player's lines wins at once, and two cells completing the opponent's
+     * lines cannot both be blocked. Both results are exact at any depth.
+     */
+    char opponent = (player == 'x') ? 'o' : 'x';
+    uint64_t empty = ~(board.x_pieces | board.o_pieces) & VALID_POSITIONS_MASK;
+    uint64_t opponent_pieces = (player == 'x') ? board.o_pieces : board.x_pieces;
+    if (lines->threats[player == 'x' ? 0 : 1])
+    {
+        SEARCH_STATS_ADD(node_stats, terminal, 1);
+        return AI_WIN_SCORE;
+    }
+    uint64_t blocks = line_counts_threat_cells(lines, opponent, opponent_pieces);
+    if (blocks & (blocks - 1))
+    {
+        SEARCH_STATS_ADD(node_stats, terminal, 1);
+        return PLAYER_WIN_SCORE;
+    }
+
+    /* Transposition table probe */
+    int symmetry;
+    uint64_t hash = positionKey(pos, &symmetry);
+    int draft = searchDraft(board, depth);
+    int transposition_table_score;
+    int transposition_table_move;
+    SEARCH_STATS_ADD(node_stats, tt_probes, 1);
+    SEARCH_STATS_ADD(node_stats, tt_hits,
+                     transposition_table_peek_r(ctx->engine->table, hash) == TRANSPOSITION_TABLE_SLOT_MATCH);
+    if (transposition_table_probe_move_r(ctx->engine->table, hash, draft, alpha, beta,
+                                         &transposition_table_score, &transposition_table_move))
+    {
+        SEARCH_STATS_ADD(node_stats, tt_cutoffs, 1);
+        return transposition_table_score;
+    }
+    transposition_table_move = zobrist_symmetry_unmap_r(pos->keys, symmetry, transposition_table_move);
+
+    /* Horizon of a depth-limited search: static evaluation, not cached */
+    if (depth == 0)
+        return heuristicScore(lines, player);
+
+    int emptyCount = POPCOUNT64(empty);
+    int ply = MAX_MOVES - emptyCount;
     MoveList emptySpots;
-    findEmptySpots(board, &emptySpots);
+    if (blocks)
+    {
+        /* Forced block: every other move loses to the opponent's completion */
+        int cell = lowestCell(blocks);
+        emptySpots.count = 1;
+        emptySpots.moves[0] = (Move){.row = BIT_TO_ROW(cell), .col = BIT_TO_COL(cell)};
+    }
+    else
+    {
+        /*
+         * A cell on dead lines only is as good as passing, and an extra piece
+         * never hurts its owner: such moves cannot beat a move on a live line,
+         * which exists while the game is undecided. The root keeps every move.
+         */
+        uint64_t cells = empty & line_counts_live_cells(lines);
+        if (ply < SYMMETRY_PRUNING_PLIES)
+            cells = bitboard_unique_cells(cells, bitboard_symmetries(board)); /* Equivalent moves */
+        collectMoves(cells, &emptySpots);
+    }
+    if (ctx->order_offset != 0)
+        rotateMoves(&emptySpots, ctx->order_offset);
+    if (ctx->ordering != NULL)
+        orderMoves(ctx->ordering, &emptySpots, player, ply);
+    if (transposition_table_move >= 0)
+        moveToFront(&emptySpots, transposition_table_move); /* Best move of an earlier search */
     int bestScore = -INF;
+    int bestIndex = 0;
     int original_alpha = alpha;
+    int childDepth = searchChildDepth(depth);
+    SEARCH_STATS_ADD(node_stats, expanded, 1);
 
     for (int i = 0; i < emptySpots.count; i++)
     {
         Move move = emptySpots.moves[i];
-        bitboard_make_move(&board, move.row, move.col, aiPlayer);
-        uint64_t new_hash = zobrist_toggle(hash, move.row, move.col, aiPlayer);
-        new_hash = zobrist_toggle_turn(new_hash); /* Toggle turn: AI → Opponent */
-        int score = miniMaxLow(board, aiPlayer, alpha, beta, new_hash);
-        bitboard_unmake_move(&board, move.row, move.col, aiPlayer);
+        SEARCH_STATS_ADD(node_stats, moves_searched, 1);
+        bitboard_make_move(&board, move.row, move.col, player);
+        positionMake(pos, move, player);
+        int score;
+        if (i > 0 && ctx->engine->search_algorithm == SEARCH_PVS)
+        {
+            /* Null window: only prove the move is no better than alpha */
+            score = -negaMax(ctx, board, pos, opponent, -alpha - 1, -alpha, childDepth);
+            if (score > alpha && score < beta && !searchAborted(ctx)) /* Fail high: re-search */
+                score = -negaMax(ctx, board, pos, opponent, -beta, -alpha, childDepth);
+        }
+        else
+        {
+            score = -negaMax(ctx, board, pos, opponent, -beta, -alpha, childDepth);
+        }
+        bitboard_unmake_move(&board, move.row, move.col, player);
+        positionUnmake(pos, move, player);
+
+        /* Aborted: the child score is meaningless, leave the TT untouched */
+        if (searchAborted(ctx))
+            return 0;
 
         if (score > bestScore)
         {
             bestScore = score;
+            bestIndex = i;
         }
 
         /* Early win return: stop searching if we found a winning move */
         if (bestScore == AI_WIN_SCORE)
+        {
+            if (ctx->ordering != NULL)
+                recordCutoff(ctx->ordering, move, player, ply, emptyCount);
             break;
+        }
 
         if (score > alpha)
             alpha = score;
         if (beta <= alpha)
+        {
+            if (ctx->ordering != NULL)
+                recordCutoff(ctx->ordering, move, player, ply, emptyCount);
             break; /* Beta cutoff */
+        }
+
+        /* Young Brothers Wait: eldest brother done, offer the rest to idle threads */
+        if (i == 0 && ctx->pool != NULL && ybwcShouldSplit(ctx, emptySpots.count))
+        {
+            bestScore = ybwcSearchSiblings(ctx, board, player, &emptySpots, 1, depth,
+                                           alpha, beta, bestScore, &bestIndex);
+            if (searchAborted(ctx))
+                return 0;
+            break;
+        }
     }
 
     /* Classify node type for transposition table storage */
@@ -181,151 +546,1011 @@ static int miniMaxHigh(Bitboard board, char aiPlayer, int alpha, int beta, uint6
     {
         store_type = TRANSPOSITION_TABLE_EXACT; /* Exact score */
     }
-    transposition_table_store(hash, bestScore, store_type);
+    SEARCH_STATS_ADD(node_stats, beta_cutoffs, store_type == TRANSPOSITION_TABLE_LOWERBOUND);
+    SEARCH_STATS_ADD(node_stats, cutoff_index[searchStatsCutoffSlot(bestIndex)],
+                     store_type == TRANSPOSITION_TABLE_LOWERBOUND);
+    SEARCH_STATS_ADD(node_stats, fail_lows, store_type == TRANSPOSITION_TABLE_UPPERBOUND); /* Alpha cutoff */
+    SEARCH_STATS_ADD(node_stats, tt_stores, 1);
+    SEARCH_STATS_ADD(node_stats, tt_overwrites,
+                     transposition_table_peek_r(ctx->engine->table, hash) == TRANSPOSITION_TABLE_SLOT_OTHER);
+    Move best = emptySpots.moves[bestIndex];
+    transposition_table_store_move_r(ctx->engine->table, hash, draft, bestScore, store_type,
+                                     zobrist_symmetry_map_r(pos->keys, symmetry, POS_TO_BIT(best.row, best.col)));
 
     return bestScore;
 }
 
-/*
- * Minimizing ply (opponent).
- * Returns worst-case score for aiPlayer given optimal opponent play.
- */
-static int miniMaxLow(Bitboard board, char aiPlayer, int alpha, int beta, uint64_t hash)
+int searchNode(SearchContext *ctx, Bitboard board, char player, int alpha, int beta, int depth)
 {
-    /* Transposition table probe */
-    int transposition_table_score;
-    if (transposition_table_probe(hash, alpha, beta, &transposition_table_score))
+    SearchPosition pos;
+    positionInit(&pos, ctx->engine, board, player);
+    return negaMax(ctx, board, &pos, player, alpha, beta, depth);
+}
+
+void rootScoresReset(RootScoreList *out_scores, const MoveList *moves)
+{
+    out_scores->count = moves->count;
+    for (int i = 0; i < moves->count; i++)
     {
-        return transposition_table_score;
+        out_scores->moves[i] = (RootMoveScore){
+            .row = moves->moves[i].row,
+            .col = moves->moves[i].col,
+            .score = 0,
+            .bound = ROOT_SCORE_NOT_SEARCHED};
     }
+}
 
-    int state = boardScore(board, aiPlayer);
-    if (state != CONTINUE_SCORE)
+/* Index of the move on cell in list, or -1 (also for cell -1). */
+static int findMove(const MoveList *list, int cell)
+{
+    for (int i = 0; i < list->count; i++)
     {
-        /* terminal: cache and return raw score */
-        transposition_table_store(hash, state, TRANSPOSITION_TABLE_EXACT);
-        return state;
+        if (POS_TO_BIT(list->moves[i].row, list->moves[i].col) == cell)
+            return i;
     }
+    return -1;
+}
 
-    MoveList emptySpots;
-    findEmptySpots(board, &emptySpots);
-    int bestScore = INF;
+/*
+ * Root search order: the transposition table's best move for the root (from
+ * an earlier search, stored in the frame of symmetry) first, then the rest in
+ * list order.
+ */
+static int rootSearchOrder(const HyperPruneEngine *engine, const MoveList *list, uint64_t hash, int symmetry,
+                           int *out_order)
+{
+    int first = findMove(list, zobrist_symmetry_unmap_r(engine->keys, symmetry,
+                                                        transposition_table_best_move_r(engine->table, hash)));
+    int count = 0;
+    if (first >= 0)
+        out_order[count++] = first;
+    for (int i = 0; i < list->count; i++)
+    {
+        if (i != first)
+            out_order[count++] = i;
+    }
+    return first;
+}
+
+/*
+ * Root loop: search every candidate move and keep the first one with the
+ * highest score. Moves are tried in list order (rotated by ctx->order_offset),
+ * except that the transposition table's best move goes first. A move listed
+ * before the current best is searched one below the best score, so a tie
+ * still goes to the earliest move and the choice does not depend on the order.
+ */
+int searchRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves,
+               int depth, Move *out_best, RootScoreList *out_scores)
+{
+    MoveList rootMoves = *moves;
+    if (ctx->order_offset != 0)
+        rotateMoves(&rootMoves, ctx->order_offset);
+    if (out_scores != NULL)
+        rootScoresReset(out_scores, &rootMoves);
+
+    int alpha = -INF;
+    int beta = INF;
+    int bestIndex = -1;
+    int bestScore = -INF;
+    int childDepth = searchChildDepth(depth);
     char opponent = (aiPlayer == 'x') ? 'o' : 'x';
-    int original_beta = beta;
+    SearchPosition pos;
+    positionInit(&pos, ctx->engine, board, aiPlayer);
+    int symmetry;
+    uint64_t hash = positionKey(&pos, &symmetry);
+    int order[MAX_MOVES];
+    rootSearchOrder(ctx->engine, &rootMoves, hash, symmetry, order);
 
-    for (int i = 0; i < emptySpots.count; i++)
+    for (int k = 0; k < rootMoves.count; ++k)
     {
-        Move move = emptySpots.moves[i];
-        bitboard_make_move(&board, move.row, move.col, opponent);
-        uint64_t new_hash = zobrist_toggle(hash, move.row, move.col, opponent);
-        new_hash = zobrist_toggle_turn(new_hash); /* Toggle turn: Opponent → AI */
-        int score = miniMaxHigh(board, aiPlayer, alpha, beta, new_hash);
-        bitboard_unmake_move(&board, move.row, move.col, opponent);
+        int i = order[k];
+
+        /* Early exit: nothing after a winning move can replace it */
+        if (bestScore == AI_WIN_SCORE && i > bestIndex)
+            break;
 
-        if (score < bestScore)
+        /* An earlier move than the best must show a tie exactly to take over */
+        int floor = (i < bestIndex) ? bestScore - 1 : alpha;
+
+        Move move = rootMoves.moves[i];
+        bitboard_make_move(&board, move.row, move.col, aiPlayer);
+        positionMake(&pos, move, aiPlayer);
+        int score;
+        if (k > 0 && ctx->engine->search_algorithm == SEARCH_PVS)
         {
-            bestScore = score;
+            /* Null window: only prove the move is no better than floor */
+            score = -negaMax(ctx, board, &pos, opponent, -floor - 1, -floor, childDepth);
+            if (score > floor && score < beta && !searchAborted(ctx)) /* Fail high: re-search */
+                score = -negaMax(ctx, board, &pos, opponent, -beta, -floor, childDepth);
+        }
+        else
+        {
+            score = -negaMax(ctx, board, &pos, opponent, -beta, -floor, childDepth);
         }
+        bitboard_unmake_move(&board, move.row, move.col, aiPlayer);
+        positionUnmake(&pos, move, aiPlayer);
 
-        /* Early win return: stop searching if opponent found a winning move */
-        if (bestScore == PLAYER_WIN_SCORE)
+        if (searchAborted(ctx))
             break;
 
-        if (score < beta)
-            beta = score;
-        if (beta <= alpha)
-            break; /* Alpha cutoff */
-    }
+        if (out_scores != NULL)
+        {
+            out_scores->moves[i].score = score;
+            out_scores->moves[i].bound = (score > floor) ? ROOT_SCORE_EXACT : ROOT_SCORE_UPPER_BOUND;
+        }
 
-    /* Classify node type for transposition table storage */
-    TranspositionTableNodeType store_type;
-    if (bestScore <= alpha)
-    {
-        store_type = TRANSPOSITION_TABLE_UPPERBOUND; /* Alpha cutoff */
-    }
-    else if (bestScore >= original_beta)
-    {
-        store_type = TRANSPOSITION_TABLE_LOWERBOUND; /* All moves were >= original beta */
+        if (score > bestScore || (score == bestScore && i < bestIndex))
+        {
+            bestScore = score;
+            bestIndex = i;
+            alpha = score;
+        }
     }
-    else
+
+    if (bestIndex < 0)
     {
-        store_type = TRANSPOSITION_TABLE_EXACT; /* Exact score */
+        /* Aborted before any move finished: the move it started with */
+        *out_best = (rootMoves.count > 0) ? rootMoves.moves[order[0]] : (Move){-1, -1};
+        return bestScore;
     }
-    transposition_table_store(hash, bestScore, store_type);
 
+    /* Full window: the best score is exact; its move leads the next search */
+    Move best = rootMoves.moves[bestIndex];
+    if (!searchAborted(ctx))
+        transposition_table_store_move_r(ctx->engine->table, hash, searchDraft(board, depth), bestScore,
+                                         TRANSPOSITION_TABLE_EXACT,
+                                         zobrist_symmetry_map_r(pos.keys, symmetry, POS_TO_BIT(best.row, best.col)));
+    *out_best = best;
     return bestScore;
 }
 
-/*
- * Public entry: select the best move for aiPlayer.
- * Short-circuits:
- *  - Invalid board (overlapping pieces) -> (-1, -1)
- *  - Terminal board -> (-1, -1)
- *  - Empty board    -> center (BOARD_SIZE/2, BOARD_SIZE/2) without searching
- */
-void getAiMove(Bitboard board, char aiPlayer, int *out_row, int *out_col)
+int probeRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves,
+              const int *order, int alpha, int *out_passed)
 {
-    /* Validate: no overlapping pieces */
-    if (board.x_pieces & board.o_pieces)
+    char opponent = (aiPlayer == 'x') ? 'o' : 'x';
+    int found = -1;
+    SearchPosition pos;
+    positionInit(&pos, ctx->engine, board, aiPlayer);
+
+    for (int i = 0; i < moves->count; ++i)
+        out_passed[i] = -1;
+
+    for (int k = 0; k < moves->count; ++k)
     {
-        *out_row = -1;
-        *out_col = -1;
-        return;
+        int i = order[k];
+        if (found >= 0 && i > found)
+            break;
+
+        Move move = moves->moves[i];
+        bitboard_make_move(&board, move.row, move.col, aiPlayer);
+        positionMake(&pos, move, aiPlayer);
+        int score = -negaMax(ctx, board, &pos, opponent, -alpha - 1, -alpha, SEARCH_DEPTH_FULL);
+        bitboard_unmake_move(&board, move.row, move.col, aiPlayer);
+        positionUnmake(&pos, move, aiPlayer);
+
+        if (searchAborted(ctx))
+            return -1;
+        out_passed[i] = (score > alpha);
+        if (score > alpha && (found < 0 || i < found))
+            found = i;
     }
+    return found;
+}
 
-    int state = boardScore(board, aiPlayer);
-    if (state != CONTINUE_SCORE)
+/*
+ * Outcome-only root: full-depth scores are only ever a win, a tie or a loss,
+ * so two null-window probes decide the game value. The first probe looks for
+ * a win (score > TIE_SCORE), the second for a move that at least ties
+ * (score > TIE_SCORE - 1). Both try the transposition table's best move
+ * first and pick the same move as searchRoot: the first move with the best
+ * outcome. If ctx->stop is raised no move is scored and out_best is the first
+ * move of the search order.
+ */
+int solveRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves, RootProbe probe,
+              Move *out_best, RootScoreList *out_scores)
+{
+    MoveList rotated;
+    if (ctx->order_offset != 0)
     {
-        *out_row = -1;
-        *out_col = -1;
-        return;
+        rotated = *moves;
+        rotateMoves(&rotated, ctx->order_offset);
+        moves = &rotated;
     }
+    rootScoresReset(out_scores, moves);
 
-    MoveList emptySpots;
-    findEmptySpots(board, &emptySpots);
+    SearchPosition pos;
+    positionInit(&pos, ctx->engine, board, aiPlayer);
+    int symmetry;
+    uint64_t hash = positionKey(&pos, &symmetry);
+    int order[MAX_MOVES];
+    rootSearchOrder(ctx->engine, moves, hash, symmetry, order);
 
-    if (emptySpots.count == MAX_MOVES)
+    int passed[MAX_MOVES];
+    int score;
+    int best = probe(ctx, board, aiPlayer, moves, order, TIE_SCORE, passed);
+    if (best >= 0)
     {
-        /* center square; for even boards, lower-right of the central 2×2 */
-        *out_row = BOARD_SIZE / 2;
-        *out_col = BOARD_SIZE / 2;
-        return;
+        for (int i = 0; i < moves->count; i++)
+        {
+            if (passed[i] >= 0)
+            {
+                out_scores->moves[i].score = passed[i] ? AI_WIN_SCORE : TIE_SCORE;
+                out_scores->moves[i].bound = passed[i] ? ROOT_SCORE_EXACT : ROOT_SCORE_UPPER_BOUND;
+            }
+        }
+        score = AI_WIN_SCORE;
     }
-
-    if (emptySpots.count == 1)
+    else
+    {
+        /* No win: every move is known to be a tie at best */
+        best = probe(ctx, board, aiPlayer, moves, order, TIE_SCORE - 1, passed);
+        for (int i = 0; i < moves->count; i++)
+        {
+            out_scores->moves[i].score = (passed[i] == 0) ? PLAYER_WIN_SCORE : TIE_SCORE;
+            out_scores->moves[i].bound = (passed[i] >= 0) ? ROOT_SCORE_EXACT : ROOT_SCORE_UPPER_BOUND;
+        }
+        score = (best >= 0) ? TIE_SCORE : PLAYER_WIN_SCORE;
+        if (best < 0)
+            best = 0;
+    }
+
+    if (searchAborted(ctx))
+    {
+        /* Probes cut short prove nothing: no scores, no root entry */
+        rootScoresReset(out_scores, moves);
+        *out_best = moves->moves[order[0]];
+        return TIE_SCORE;
+    }
+
+    *out_best = moves->moves[best];
+    transposition_table_store_move_r(ctx->engine->table, hash, TRANSPOSITION_TABLE_DEPTH_FULL, score,
+                                     TRANSPOSITION_TABLE_EXACT,
+                                     zobrist_symmetry_map_r(pos.keys, symmetry, POS_TO_BIT(out_best->row, out_best->col)));
+    return score;
+}
+
+/* Default settings, and the keys and table the engine searches with. */
+static void engineSetup(HyperPruneEngine *engine, ZobristKeys *keys, TranspositionTable *table)
+{
+    engine->keys = keys;
+    engine->table = table;
+    engine->thread_count = 1;
+    engine->parallel_mode = PARALLEL_LAZY_SMP;
+    engine->search_algorithm = USE_PVS ? SEARCH_PVS : SEARCH_ALPHA_BETA;
+    engine->search_engine = (BOARD_SIZE >= 5) ? ENGINE_SOLVER : ENGINE_MINIMAX;
+    engine->symmetric_hashing = SYMMETRIC_HASHING_DEFAULT;
+    engine->solution_table = SOLUTION_TABLE_DEFAULT;
+    engine->proof_memory = PROOF_NUMBER_DEFAULT_MEMORY;
+    engine->mcts_memory = MCTS_DEFAULT_MEMORY;
+}
+
+HyperPruneEngine *engineCreate(size_t table_size)
+{
+    HyperPruneEngine *engine = (HyperPruneEngine *)calloc(1, sizeof(HyperPruneEngine));
+    if (engine == NULL)
+        return NULL;
+
+    engineSetup(engine, &engine->own_keys, &engine->own_table);
+    zobrist_set_seed_r(engine->keys, ZOBRIST_DEFAULT_SEED);
+    zobrist_init_r(engine->keys);
+    transposition_table_init_r(engine->table, table_size);
+    proof_number_table_init_r(&engine->proof_table, engine->proof_memory);
+    return engine;
+}
+
+void engineDestroy(HyperPruneEngine *engine)
+{
+    if (engine == NULL || engine == &default_engine)
+        return;
+    transposition_table_free_r(&engine->own_table);
+    proof_number_table_free_r(&engine->proof_table);
+    mcts_tree_free_r(&engine->mcts_tree);
+    free(engine);
+}
+
+HyperPruneEngine *engineDefault(void)
+{
+    if (default_engine.keys == NULL)
+        engineSetup(&default_engine, zobrist_default_keys(), transposition_table_default());
+    return &default_engine;
+}
+
+struct ZobristKeys *engineZobristKeys(HyperPruneEngine *engine)
+{
+    return engine->keys;
+}
+
+struct TranspositionTable *engineTranspositionTable(HyperPruneEngine *engine)
+{
+    return engine->table;
+}
+
+void engineGetStats(const HyperPruneEngine *engine, EngineStats *out_stats)
+{
+    *out_stats = engine->stats;
+}
+
+void engineSetSearchThreads(HyperPruneEngine *engine, int threads)
+{
+    if (threads < 1)
+        threads = 1;
+    if (threads > MAX_SEARCH_THREADS)
+        threads = MAX_SEARCH_THREADS;
+    engine->thread_count = threads;
+}
+
+int engineGetSearchThreads(const HyperPruneEngine *engine)
+{
+    return engine->thread_count;
+}
+
+void engineSetParallelMode(HyperPruneEngine *engine, ParallelMode mode)
+{
+    engine->parallel_mode = mode;
+}
+
+ParallelMode engineGetParallelMode(const HyperPruneEngine *engine)
+{
+    return engine->parallel_mode;
+}
+
+void engineSetSearchAlgorithm(HyperPruneEngine *engine, SearchAlgorithm algorithm)
+{
+    engine->search_algorithm = algorithm;
+}
+
+SearchAlgorithm engineGetSearchAlgorithm(const HyperPruneEngine *engine)
+{
+    return engine->search_algorithm;
+}
+
+void engineSetSearchEngine(HyperPruneEngine *engine, SearchEngine searchEngine)
+{
+    engine->search_engine = searchEngine;
+}
+
+SearchEngine engineGetSearchEngine(const HyperPruneEngine *engine)
+{
+    return engine->search_engine;
+}
+
+void engineSetSymmetricHashing(HyperPruneEngine *engine, int enabled)
+{
+    engine->symmetric_hashing = (enabled != 0);
+}
+
+int engineGetSymmetricHashing(const HyperPruneEngine *engine)
+{
+    return engine->symmetric_hashing;
+}
+
+void engineSetSolutionTable(HyperPruneEngine *engine, int enabled)
+{
+    engine->solution_table = (enabled != 0);
+}
+
+int engineGetSolutionTable(const HyperPruneEngine *engine)
+{
+    return engine->solution_table;
+}
+
+void engineSetProofNumberMemory(HyperPruneEngine *engine, size_t bytes)
+{
+    engine->proof_memory = bytes;
+    proof_number_table_init_r(&engine->proof_table, bytes);
+}
+
+size_t engineGetProofNumberMemory(const HyperPruneEngine *engine)
+{
+    return engine->proof_memory;
+}
+
+void engineSetMctsMemory(HyperPruneEngine *engine, size_t bytes)
+{
+    engine->mcts_memory = bytes;
+    mcts_tree_init_r(&engine->mcts_tree, bytes);
+}
+
+size_t engineGetMctsMemory(const HyperPruneEngine *engine)
+{
+    return engine->mcts_memory;
+}
+
+void engineResetMoveOrdering(HyperPruneEngine *engine)
+{
+    memset(&engine->ordering, 0, sizeof(engine->ordering));
+}
+
+int engineGetRootMoveScores(const HyperPruneEngine *engine, RootMoveScore *out_scores, int max_count)
+{
+    const RootScoreList *scores = &engine->last_root_scores;
+    if (out_scores != NULL)
+    {
+        for (int i = 0; i < scores->count && i < max_count; i++)
+        {
+            out_scores[i] = scores->moves[i];
+            if (engine->solution_player != 0)
+            {
+                /* Read from the solution table: score the move now, not on every getAiMove */
+                Move move = {scores->moves[i].row, scores->moves[i].col};
+                out_scores[i].score = solutionTableMoveScore(engine->solution_root, engine->solution_player, move);
+                out_scores[i].bound = ROOT_SCORE_EXACT;
+            }
+        }
+    }
+    return scores->count;
+}
+
+/* Add every counter of from to into. */
+static void searchPlyStatsAdd(SearchPlyStats *into, const SearchPlyStats *from)
+{
+    into->nodes += from->nodes;
+    into->terminal += from->terminal;
+    into->tt_probes += from->tt_probes;
+    into->tt_hits += from->tt_hits;
+    into->tt_cutoffs += from->tt_cutoffs;
+    into->tt_stores += from->tt_stores;
+    into->tt_overwrites += from->tt_overwrites;
+    into->expanded += from->expanded;
+    into->moves_searched += from->moves_searched;
+    into->beta_cutoffs += from->beta_cutoffs;
+    into->fail_lows += from->fail_lows;
+    for (int i = 0; i < SEARCH_STATS_CUTOFF_SLOTS; i++)
+        into->cutoff_index[i] += from->cutoff_index[i];
+}
+
+#if HP_STATS
+SearchStats *searchStatsAcquire(int count)
+{
+    return (count > 0) ? (SearchStats *)calloc((size_t)count, sizeof(SearchStats)) : NULL;
+}
+
+void searchStatsRelease(HyperPruneEngine *engine, SearchStats *block, int count)
+{
+    if (block == NULL)
+        return;
+    for (int t = 0; t < count; t++)
+    {
+        for (int p = 0; p <= MAX_MOVES; p++)
+            searchPlyStatsAdd(&engine->search_stats.ply[p], &block[t].ply[p]);
+    }
+    free(block);
+}
+#endif
+
+int engineGetSearchStats(const HyperPruneEngine *engine, SearchStats *out_stats)
+{
+#if HP_STATS
+    *out_stats = engine->search_stats;
+    return 1;
+#else
+    (void)engine;
+    memset(out_stats, 0, sizeof(*out_stats));
+    return 0;
+#endif
+}
+
+void engineResetSearchStats(HyperPruneEngine *engine)
+{
+#if HP_STATS
+    memset(&engine->search_stats, 0, sizeof(engine->search_stats));
+#else
+    (void)engine;
+#endif
+}
+
+void searchStatsTotal(const SearchStats *stats, SearchPlyStats *out_total)
+{
+    memset(out_total, 0, sizeof(*out_total));
+    for (int p = 0; p <= MAX_MOVES; p++)
+        searchPlyStatsAdd(out_total, &stats->ply[p]);
+}
+
+void setSearchThreads(int threads)
+{
+    engineSetSearchThreads(engineDefault(), threads);
+}
+
+int getSearchThreads(void)
+{
+    return engineGetSearchThreads(engineDefault());
+}
+
+void setParallelMode(ParallelMode mode)
+{
+    engineSetParallelMode(engineDefault(), mode);
+}
+
+ParallelMode getParallelMode(void)
+{
+    return engineGetParallelMode(engineDefault());
+}
+
+void setSearchAlgorithm(SearchAlgorithm algorithm)
+{
+    engineSetSearchAlgorithm(engineDefault(), algorithm);
+}
+
+SearchAlgorithm getSearchAlgorithm(void)
+{
+    return engineGetSearchAlgorithm(engineDefault());
+}
+
+void setSearchEngine(SearchEngine engine)
+{
+    engineSetSearchEngine(engineDefault(), engine);
+}
+
+SearchEngine getSearchEngine(void)
+{
+    return engineGetSearchEngine(engineDefault());
+}
+
+void setSymmetricHashing(int enabled)
+{
+    engineSetSymmetricHashing(engineDefault(), enabled);
+}
+
+int getSymmetricHashing(void)
+{
+    return engineGetSymmetricHashing(engineDefault());
+}
+
+void setSolutionTable(int enabled)
+{
+    engineSetSolutionTable(engineDefault(), enabled);
+}
+
+int getSolutionTable(void)
+{
+    return engineGetSolutionTable(engineDefault());
+}
+
+void setProofNumberMemory(size_t bytes)
+{
+    engineSetProofNumberMemory(engineDefault(), bytes);
+}
+
+size_t getProofNumberMemory(void)
+{
+    return engineGetProofNumberMemory(engineDefault());
+}
+
+void setMctsMemory(size_t bytes)
+{
+    engineSetMctsMemory(engineDefault(), bytes);
+}
+
+size_t getMctsMemory(void)
+{
+    return engineGetMctsMemory(engineDefault());
+}
+
+void resetMoveOrdering(void)
+{
+    engineResetMoveOrdering(engineDefault());
+}
+
+int getRootMoveScores(RootMoveScore *out_scores, int max_count)
+{
+    return engineGetRootMoveScores(engineDefault(), out_scores, max_count);
+}
+
+int getSearchStats(SearchStats *out_stats)
+{
+    return engineGetSearchStats(engineDefault(), out_stats);
+}
+
+void resetSearchStats(void)
+{
+    engineResetSearchStats(engineDefault());
+}
+
+/*
+ * Checks shared by every public entry point. Returns the root state:
+ *  - CONTINUE_SCORE with out_moves filled when a search is needed
+ *  - any other value (or -1 for an invalid board) when the position is over;
+ *    out_moves is left empty
+ */
+static int prepareRoot(Bitboard board, char aiPlayer, MoveList *out_moves)
+{
+    out_moves->count = 0;
+
+    /* Validate: no overlapping pieces */
+    if (board.x_pieces & board.o_pieces)
+        return -1;
+
+    int state = boardScore(board, aiPlayer);
+    if (state == CONTINUE_SCORE)
+    {
+        findEmptySpots(board, out_moves);
+
+        /*
+         * Slower wins score the same as winning now, and ties go to the
+         * earliest listed move: list an immediate win first.
+         */
+        uint64_t own = (aiPlayer == 'x') ? board.x_pieces : board.o_pieces;
+        uint64_t wins = bitboard_threat_cells(own, ~(board.x_pieces | board.o_pieces));
+        if (wins)
+            moveToFront(out_moves, lowestCell(wins));
+    }
+    return state;
+}
+
+/*
+ * Root moves to search: one per group of cells that a symmetry of the board
+ * maps onto each other, in the order of moves. Every group keeps its lowest
+ * cell; that move scores the same as the others and comes first in bit order,
+ * so the first best move does not change. Returns the board's symmetries.
+ */
+static unsigned uniqueRootMoves(Bitboard board, const MoveList *moves, MoveList *out_unique)
+{
+    unsigned symmetries = bitboard_symmetries(board);
+    uint64_t cells = 0;
+    for (int i = 0; i < moves->count; i++)
+        cells |= 1ULL << POS_TO_BIT(moves->moves[i].row, moves->moves[i].col);
+    cells = bitboard_unique_cells(cells, symmetries);
+
+    out_unique->count = 0;
+    for (int i = 0; i < moves->count; i++)
+    {
+        if (cells & (1ULL << POS_TO_BIT(moves->moves[i].row, moves->moves[i].col)))
+            out_unique->moves[out_unique->count++] = moves->moves[i];
+    }
+    return symmetries;
+}
+
+/*
+ * Rebuild scores (of the moves kept by uniqueRootMoves) for every move in
+ * moves: a dropped move gets the score of the kept move of its group.
+ */
+static void expandRootScores(RootScoreList *scores, const MoveList *moves, unsigned symmetries)
+{
+    if (scores->count == moves->count)
+        return;
+
+    RootScoreList unique = *scores;
+    rootScoresReset(scores, moves);
+    for (int i = 0; i < moves->count; i++)
+    {
+        uint64_t cell = 1ULL << POS_TO_BIT(moves->moves[i].row, moves->moves[i].col);
+        uint64_t group = cell;
+        for (int s = 1; s < BITBOARD_SYMMETRY_COUNT; s++)
+        {
+            if (symmetries & (1u << s))
+                group |= bitboard_transform(cell, s);
+        }
+
+        int kept = lowestCell(group);
+        for (int j = 0; j < unique.count; j++)
+        {
+            if (POS_TO_BIT(unique.moves[j].row, unique.moves[j].col) == kept)
+            {
+                scores->moves[i].score = unique.moves[j].score;
+                scores->moves[i].bound = unique.moves[j].bound;
+            }
+        }
+    }
+}
+
+/*
+ * Select the best move for aiPlayer (engineGetAiMove without clearing the
+ * stop flag). Returns non-zero if the search was stopped.
+ * Short-circuits:
+ *  - Invalid board (overlapping pieces) -> (-1, -1)
+ *  - Terminal board -> (-1, -1)
+ *  - Empty board    -> center (BOARD_SIZE/2, BOARD_SIZE/2) without searching
+ *  - Open tablebase or opening book, then the 3x3 solution table -> their
+ *    move without searching
+ */
+static int selectMove(HyperPruneEngine *engine, Bitboard board, char aiPlayer, int *out_row, int *out_col)
+{
+    RootScoreList *rootScores = &engine->last_root_scores;
+    rootScores->count = 0;
+    engine->solution_player = 0;
+
+    MoveList emptySpots;
+    if (prepareRoot(board, aiPlayer, &emptySpots) != CONTINUE_SCORE)
+    {
+        *out_row = -1;
+        *out_col = -1;
+        return 0;
+    }
+
+    if (emptySpots.count == MAX_MOVES)
+    {
+        /* center square; for even boards, lower-right of the central 2×2 */
+        *out_row = BOARD_SIZE / 2;
+        *out_col = BOARD_SIZE / 2;
+        return 0;
+    }
+
+    if (emptySpots.count == 1)
     {
         *out_row = emptySpots.moves[0].row;
         *out_col = emptySpots.moves[0].col;
-        return;
+        return 0;
     }
 
-    int alpha = -INF;
-    int beta = INF;
     Move bestMove = {-1, -1};
-    int bestScore = -INF;
-    uint64_t hash = zobrist_hash(board, aiPlayer);
+    if (tablebaseSearchRoot(board, aiPlayer, &emptySpots, &bestMove, rootScores))
+    {
+        engine->stats.tablebase_hits++;
+        *out_row = bestMove.row;
+        *out_col = bestMove.col;
+        return 0;
+    }
+    if (openingBookSearchRoot(board, aiPlayer, 1, &bestMove, NULL))
+    {
+        engine->stats.book_hits++;
+        *out_row = bestMove.row;
+        *out_col = bestMove.col;
+        return 0;
+    }
+    if (engine->solution_table && solutionTableSearchRoot(board, aiPlayer, &bestMove))
+    {
+        rootScoresReset(rootScores, &emptySpots);
+        engine->solution_root = board;
+        engine->solution_player = aiPlayer;
+        engine->stats.solution_table_hits++;
+        *out_row = bestMove.row;
+        *out_col = bestMove.col;
+        return 0;
+    }
 
-    for (int i = 0; i < emptySpots.count; ++i)
+    MoveList rootMoves;
+    unsigned symmetries = uniqueRootMoves(board, &emptySpots, &rootMoves);
+    int threads = engine->thread_count;
+    int solver = (engine->search_engine == ENGINE_SOLVER);
+    engine->stats.searches++;
+
+    if (engine->search_engine == ENGINE_PROOF_NUMBER)
     {
-        Move move = emptySpots.moves[i];
-        bitboard_make_move(&board, move.row, move.col, aiPlayer);
-        uint64_t new_hash = zobrist_toggle(hash, move.row, move.col, aiPlayer);
-        new_hash = zobrist_toggle_turn(new_hash); /* Toggle turn: AI → Opponent */
-        int score = miniMaxLow(board, aiPlayer, alpha, beta, new_hash);
-        bitboard_unmake_move(&board, move.row, move.col, aiPlayer);
+        proofNumberSearchRoot(engine, board, aiPlayer, &rootMoves, &bestMove, rootScores);
+    }
+    else if (threads > 1 && engine->parallel_mode == PARALLEL_YBWC)
+    {
+        engine->stats.parallel_searches++;
+        if (solver)
+            ybwcSolveRoot(engine, board, aiPlayer, &rootMoves, threads, &bestMove, rootScores);
+        else
+            ybwcSearchRoot(engine, board, aiPlayer, &rootMoves, threads, &bestMove, rootScores);
+    }
+    else if (threads > 1 && engine->parallel_mode == PARALLEL_ROOT_SPLIT)
+    {
+        engine->stats.parallel_searches++;
+        if (solver)
+            rootSplitSolveRoot(engine, board, aiPlayer, &rootMoves, threads, &bestMove, rootScores);
+        else
+            rootSplitSearchRoot(engine, board, aiPlayer, &rootMoves, threads, &bestMove, rootScores);
+    }
+    else if (threads > 1)
+    {
+        engine->stats.parallel_searches++;
+        if (solver)
+            lazySmpSolveRoot(engine, board, aiPlayer, &rootMoves, threads, &bestMove, rootScores);
+        else
+            lazySmpSearchRoot(engine, board, aiPlayer, &rootMoves, threads, &bestMove, rootScores);
+    }
+    else
+    {
+        SearchContext ctx = {engine, &engine->stop, 0, NULL, NULL, 0, NULL, &engine->ordering, searchStatsOf(engine)};
+        if (solver)
+            solveRoot(&ctx, board, aiPlayer, &rootMoves, probeRoot, &bestMove, rootScores);
+        else
+            searchRoot(&ctx, board, aiPlayer, &rootMoves, SEARCH_DEPTH_FULL, &bestMove, rootScores);
+    }
+    expandRootScores(rootScores, &emptySpots, symmetries);
 
-        if (score > bestScore)
+    *out_row = bestMove.row;
+    *out_col = bestMove.col;
+    return atomic_load_int(&engine->stop);
+}
+
+int engineGetAiMove(HyperPruneEngine *engine, Bitboard board, char aiPlayer, int *out_row, int *out_col)
+{
+    int stopped = selectMove(engine, board, aiPlayer, out_row, out_col);
+    atomic_store_int(&engine->stop, 0); /* A stop request ends with the call it reached */
+    return stopped;
+}
+
+int getAiMove(Bitboard board, char aiPlayer, int *out_row, int *out_col)
+{
+    return engineGetAiMove(engineDefault(), board, aiPlayer, out_row, out_col);
+}
+
+void engineRequestStop(HyperPruneEngine *engine)
+{
+    atomic_store_int(&engine->stop, 1);
+}
+
+void requestSearchStop(void)
+{
+    /* Not engineDefault(): its lazy setup may be running on the searching thread */
+    engineRequestStop(&default_engine);
+}
+
+void engineCancelStop(HyperPruneEngine *engine)
+{
+    atomic_store_int(&engine->stop, 0);
+}
+
+void cancelSearchStop(void)
+{
+    engineCancelStop(&default_engine);
+}
+
+void searchPosition(SearchContext *ctx, Bitboard board, char aiPlayer, SearchResult *out_result)
+{
+    *out_result = (SearchResult){-1, -1, 0, 0, 0, 0, 0};
+
+    MoveList allMoves;
+    int state = (aiPlayer == 'x' || aiPlayer == 'o') ? prepareRoot(board, aiPlayer, &allMoves) : -1;
+    if (state != CONTINUE_SCORE)
+    {
+        out_result->score = (state == -1) ? 0 : state;
+        out_result->proven = (state != -1);
+        return;
+    }
+
+    if (allMoves.count == MAX_MOVES)
+    {
+        out_result->row = BOARD_SIZE / 2;
+        out_result->col = BOARD_SIZE / 2;
+        return;
+    }
+
+    Move best = {-1, -1};
+    RootScoreList scores;
+    int score;
+    if (tablebaseSearchRoot(board, aiPlayer, &allMoves, &best, &scores))
+    {
+        score = -INF;
+        for (int i = 0; i < scores.count; i++)
         {
-            bestScore = score;
-            bestMove = move;
-            alpha = score;
+            if (scores.moves[i].score > score)
+                score = scores.moves[i].score;
         }
+    }
+    else
+    {
+        MoveList moves;
+        uniqueRootMoves(board, &allMoves, &moves);
+        if (ctx->engine->search_engine == ENGINE_MINIMAX)
+            score = searchRoot(ctx, board, aiPlayer, &moves, SEARCH_DEPTH_FULL, &best, NULL);
+        else
+            score = solveRoot(ctx, board, aiPlayer, &moves, probeRoot, &best, &scores);
+    }
 
-        /* Early exit: stop searching if we found a winning move */
-        if (bestScore == AI_WIN_SCORE)
+    out_result->row = best.row;
+    out_result->col = best.col;
+    if (searchAborted(ctx))
+    {
+        out_result->aborted = 1;
+        return;
+    }
+    out_result->score = score;
+    out_result->proven = 1;
+    out_result->depth = allMoves.count;
+}
+
+/*
+ * Order root moves for the next iteration: by score from the last completed
+ * one, best first; stable, so equal scores keep their relative order.
+ */
+static void sortRootMoves(MoveList *moves, const RootScoreList *scores)
+{
+    RootMoveScore sorted[MAX_MOVES];
+    for (int i = 0; i < scores->count; i++)
+    {
+        RootMoveScore entry = scores->moves[i];
+        if (entry.bound == ROOT_SCORE_NOT_SEARCHED)
+            entry.score = -INF;
+
+        int j = i;
+        while (j > 0 && sorted[j - 1].score < entry.score)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = entry;
+    }
+
+    for (int i = 0; i < scores->count; i++)
+        moves->moves[i] = (Move){sorted[i].row, sorted[i].col};
+}
+
+/* engineGetAiMoveBudgeted without clearing the stop flag. */
+static void selectMoveBudgeted(HyperPruneEngine *engine, Bitboard board, char aiPlayer,
+                               const SearchLimits *limits, SearchResult *out_result)
+{
+    *out_result = (SearchResult){-1, -1, 0, 0, 0, 0, 0};
+    RootScoreList *rootScores = &engine->last_root_scores;
+    rootScores->count = 0;
+    engine->solution_player = 0;
+
+    MoveList allMoves;
+    int state = prepareRoot(board, aiPlayer, &allMoves);
+    if (state != CONTINUE_SCORE)
+    {
+        /* Game over: the terminal score is exact; an invalid board has none */
+        out_result->score = (state == -1) ? 0 : state;
+        out_result->proven = (state != -1);
+        return;
+    }
+
+    if (allMoves.count == MAX_MOVES)
+    {
+        /* Same opening as getAiMove, not searched */
+        out_result->row = BOARD_SIZE / 2;
+        out_result->col = BOARD_SIZE / 2;
+        return;
+    }
+
+    Move bookMove;
+    if (openingBookSearchRoot(board, aiPlayer, 0, &bookMove, out_result))
+    {
+        engine->stats.book_hits++;
+        return;
+    }
+    engine->stats.searches++;
+
+    SearchBudget budget = {&engine->stop, 0, 0, 0.0, {0}};
+    if (limits != NULL)
+    {
+        budget.max_nodes = limits->max_nodes;
+        budget.max_seconds = (double)limits->max_time_ms / 1000.0;
+    }
+    if (budget.max_seconds > 0 && timer_get(&budget.start) != 0)
+        budget.max_seconds = 0; /* No clock: fall back to the node limit */
+
+    MoveList moves;
+    unsigned symmetries = uniqueRootMoves(board, &allMoves, &moves);
+    SearchContext ctx = {engine, &engine->stop, 0, NULL, NULL, 0, &budget, &engine->ordering, searchStatsOf(engine)};
+    RootScoreList scores;
+    Move best = moves.moves[0];
+
+    /* Deepen one ply at a time; depth == allMoves.count reaches every game end */
+    for (int depth = 1; depth <= allMoves.count; depth++)
+    {
+        Move move;
+        int score = searchRoot(&ctx, board, aiPlayer, &moves, depth, &move, &scores);
+        if (searchAborted(&ctx))
+        {
+            out_result->aborted = 1;
+            break;
+        }
+
+        best = move;
+        out_result->score = score;
+        out_result->depth = depth;
+        *rootScores = scores;
+
+        /* A win or loss is proven at any depth: heuristics never reach +-100 */
+        if (depth == allMoves.count || score == AI_WIN_SCORE || score == PLAYER_WIN_SCORE)
+        {
+            out_result->proven = 1;
             break;
+        }
+        sortRootMoves(&moves, &scores);
     }
+    if (rootScores->count > 0)
+        expandRootScores(rootScores, &allMoves, symmetries);
 
-    *out_row = bestMove.row;
-    *out_col = bestMove.col;
+    out_result->row = best.row;
+    out_result->col = best.col;
+    out_result->nodes = budget.nodes;
+}
+
+void engineGetAiMoveBudgeted(HyperPruneEngine *engine, Bitboard board, char aiPlayer,
+                             const SearchLimits *limits, SearchResult *out_result)
+{
+    selectMoveBudgeted(engine, board, aiPlayer, limits, out_result);
+    atomic_store_int(&engine->stop, 0);
+}
+
+void getAiMoveBudgeted(Bitboard board, char aiPlayer, const SearchLimits *limits,
+                       SearchResult *out_result)
+{
+    engineGetAiMoveBudgeted(engineDefault(), board, aiPlayer, limits, out_result);
 }
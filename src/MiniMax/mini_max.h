@@ -6,7 +6,8 @@
  * ---------------------
  * Public API for the Minimax-based Tic-Tac-Toe engine.
  *
- * The engine searches the full game tree using Minimax with alpha–beta pruning.
+ * The engine searches the full game tree using Minimax with alpha–beta pruning
+ * (optionally as Principal Variation Search).
  * BOARD_SIZE is configured at
  * compile time (3-8 per tic_tac_toe.h).
  *
@@ -17,8 +18,23 @@
  * Notable characteristics:
  * - Deterministic results due to stable ordering of move generation
  * - Simple opening heuristic (play center on empty board)
+ * - Optional parallel search (Lazy SMP, Young Brothers Wait or root
+ *   splitting), sharing the transposition table between threads
+ * - Budgeted iterative deepening for boards too large to solve per move
+ * - Outcome-only solver (null-window probes), the default from 5x5 up
+ * - Depth-first proof-number search engine for larger boards (proof_number.h)
+ * - Monte Carlo Tree Search as an anytime alternative for 7x7/8x8 (mcts.h)
+ * - Retrograde tablebase for 3x3/4x4, answered from a memory-mapped file (tablebase.h)
+ * - Opening book of the first plies, deduplicated by symmetry (opening_book.h)
+ * - Batch analysis of many positions on a thread pool (getAiMoveBatch)
+ * - Searches stoppable from another thread (requestSearchStop)
+ * - Per-ply search statistics in builds with HP_STATS (getSearchStats)
+ * - Reentrant engines: every function has an engine* version that works on
+ *   a HyperPruneEngine with its own keys, table, settings and statistics;
+ *   the plain functions use the default engine (engineDefault)
  */
 
+#include <stddef.h>
 #include "../TicTacToe/tic_tac_toe.h"
 
 #ifdef __cplusplus
@@ -26,6 +42,132 @@ extern "C"
 {
 #endif
 
+/* Upper bound for setSearchThreads() */
+#define MAX_SEARCH_THREADS 256
+
+    /** Parallel search algorithm used when more than one thread is configured. */
+    typedef enum
+    {
+        PARALLEL_LAZY_SMP = 0,  /* Independent searches sharing the TT */
+        PARALLEL_YBWC = 1,      /* Young Brothers Wait tree splitting, work stealing */
+        PARALLEL_ROOT_SPLIT = 2 /* One root move per worker, shared atomic alpha */
+    } ParallelMode;
+
+    /** Window strategy of the minimax core. */
+    typedef enum
+    {
+        SEARCH_ALPHA_BETA = 0, /* Every sibling searched with the full window */
+        SEARCH_PVS = 1         /* Principal Variation Search (NegaScout) */
+    } SearchAlgorithm;
+
+    /** Root driver of getAiMove. */
+    typedef enum
+    {
+        ENGINE_MINIMAX = 0,     /* One search with the full (-INF, INF) window */
+        ENGINE_SOLVER = 1,      /* Outcome-only: null-window "win?" and "tie?" probes */
+        ENGINE_PROOF_NUMBER = 2 /* Outcome-only: depth-first proof-number search */
+    } SearchEngine;
+
+    /** How much is known about a root move's score after a search. */
+    typedef enum
+    {
+        ROOT_SCORE_EXACT = 0,       /* Exact game value */
+        ROOT_SCORE_UPPER_BOUND = 1, /* True value <= score (failed low) */
+        ROOT_SCORE_NOT_SEARCHED = 2 /* Skipped: an earlier move already wins */
+    } RootScoreBound;
+
+    /**
+     * Score of one root move from the AI's point of view:
+     * +100 forced win, 0 draw, -100 forced loss.
+     */
+    typedef struct
+    {
+        int row;
+        int col;
+        int score;
+        RootScoreBound bound;
+    } RootMoveScore;
+
+    /** Limits of a getAiMoveBudgeted search; 0 means unlimited. */
+    typedef struct
+    {
+        long max_time_ms;   /* Wall-clock budget in milliseconds */
+        uint64_t max_nodes; /* Node budget (every visited node counts) */
+    } SearchLimits;
+
+    /** Outcome of a getAiMoveBudgeted search. */
+    typedef struct
+    {
+        int row;        /* Selected move, -1 if the game is already over */
+        int col;
+        int score;      /* AI's view: +100 win, -100 loss, 0 draw; heuristic if not proven */
+        int proven;     /* Non-zero if score is the exact game value */
+        int depth;      /* Plies of the deepest completed iteration (0 = none) */
+        uint64_t nodes; /* Nodes visited */
+        int aborted;    /* Non-zero if the budget or a stop request cut the search short */
+    } SearchResult;
+
+    /**
+     * Search engine state: Zobrist keys, transposition table, proof-number
+     * table, MCTS node pool, the settings below (threads, parallel mode,
+     * window strategy, root driver, symmetric hashing, solution table,
+     * proof-number and MCTS memory), killer/history tables, the last root
+     * scores and statistics.
+     *
+     * Engines share nothing, so different engines may search concurrently
+     * from different threads without locks; one engine runs one call at a
+     * time. Process-wide, and shared by every engine:
+     *  - the win masks (init_win_masks() once before any search)
+     *  - the open tablebase and opening book, read-only while searching
+     *    (open and close them only while no engine is searching)
+     *  - the 3x3 solution table, built by the first engine that reads it
+     */
+    typedef struct HyperPruneEngine HyperPruneEngine;
+
+    /** Counters of an engine's getAiMove and getAiMoveBudgeted calls. */
+    typedef struct
+    {
+        uint64_t searches;            /* Moves computed by searching */
+        uint64_t parallel_searches;   /* Searches split across threads by a parallel driver */
+        uint64_t tablebase_hits;      /* Moves read from the tablebase */
+        uint64_t solution_table_hits; /* Moves read from the 3x3 solution table */
+        uint64_t book_hits;           /* Moves read from the opening book */
+    } EngineStats;
+
+/* Cutoff counters per index of the cutting move; the last one counts every later index */
+#define SEARCH_STATS_CUTOFF_SLOTS 8
+
+    /**
+     * Search counters of the nodes at one ply (pieces on the board), below
+     * the root. Collected only in builds with HP_STATS (make STATS=1, CMake
+     * -DENABLE_STATS=ON); without it the search has no counting code at all.
+     */
+    typedef struct
+    {
+        uint64_t nodes;          /* Nodes visited */
+        uint64_t terminal;       /* Decided by the line counts alone: won, drawn, dead or threat */
+        uint64_t tt_probes;      /* Transposition table probes */
+        uint64_t tt_hits;        /* Probes that found the position's entry */
+        uint64_t tt_cutoffs;     /* Hits whose score answered the node (usable hits) */
+        uint64_t tt_stores;      /* Entries written */
+        uint64_t tt_overwrites;  /* Stores that replaced another position's entry */
+        uint64_t expanded;       /* Nodes whose moves were searched */
+        uint64_t moves_searched; /* Moves searched by expanded nodes */
+        uint64_t beta_cutoffs;   /* Expanded nodes that failed high (score >= beta) */
+        uint64_t fail_lows;      /* Expanded nodes with every move <= alpha (alpha cutoffs) */
+        uint64_t cutoff_index[SEARCH_STATS_CUTOFF_SLOTS]; /* Beta cutoffs by index of the cutting move */
+    } SearchPlyStats;
+
+    /**
+     * Per-ply counters of every search since the last reset. The effective
+     * branching factor is moves_searched / expanded: 1 when the first move
+     * always cuts off, the number of legal moves without any pruning.
+     */
+    typedef struct
+    {
+        SearchPlyStats ply[MAX_MOVES + 1];
+    } SearchStats;
+
     /**
      * Compute the AI's next move using Minimax with alpha–beta pruning.
      *
@@ -38,9 +180,332 @@ extern "C"
      * Behavior:
      *  - If the board is terminal (win/tie), returns (-1, -1)
      *  - On an empty board, selects the center without searching
+     *  - While a tablebase is open (tablebase.h), reads the move from it
+     *    without searching; the move and root scores match the search
+     *  - Otherwise, while an opening book is open (opening_book.h), plays its
+     *    move for positions it holds with a proven score, without searching
+     *    (getRootMoveScores then reports no moves)
      *  - Otherwise, orders candidate moves and runs a full-depth alpha–beta search
+     *    (or the outcome-only solver, see setSearchEngine)
+     *
+     * Returns: non-zero if requestSearchStop stopped the search. The move is
+     *          then the best of the root moves that finished (the first move
+     *          searched if none did), getRootMoveScores lists only those, and
+     *          the transposition table holds no result of the unfinished part
+     */
+    int getAiMove(Bitboard board, char aiPlayer, int *out_row, int *out_col);
+
+    /**
+     * Compute the AI's next move within a time and/or node budget.
+     *
+     * Runs iterative deepening over the remaining plies: depth 1, 2, ...
+     * until the game end is reached, a win or loss is proven, or the budget
+     * runs out. Positions beyond the depth horizon get a static evaluation
+     * (open lines per side, within +-99). Each iteration searches the root
+     * moves best-first by the previous iteration's scores, and results are
+     * shared with getAiMove through the transposition table (depth-limited
+     * entries never stand in for a full-depth result).
+     *
+     * When the budget expires, or requestSearchStop is called, the move of
+     * the deepest completed iteration is returned (the first legal move if
+     * not even depth 1 finished) and aborted is set.
+     *
+     * Parameters:
+     *  - board:      Current position (bitboard representation)
+     *  - aiPlayer:   The AI symbol ('x' or 'o') to maximize for
+     *  - limits:     Time/node budget (NULL or all zero: search to the end)
+     *  - out_result: Move, score, proven flag, depth reached and node count
+     *
+     * Behavior:
+     *  - Terminal or invalid board: row/col -1; a terminal score is proven
+     *  - Empty board: center without searching (not proven)
+     *  - Position in an open opening book: its move, score, proven flag and
+     *    depth without searching (nodes 0)
+     *  - Always single-threaded, regardless of setSearchThreads
+     *  - getRootMoveScores reports the deepest completed iteration
+     */
+    void getAiMoveBudgeted(Bitboard board, char aiPlayer, const SearchLimits *limits,
+                           SearchResult *out_result);
+
+    /**
+     * Search many independent positions to the end of the game.
+     *
+     * Parameters:
+     *  - boards:      count positions (bitboard representation)
+     *  - players:     Side to move ('x' or 'o') of each position
+     *  - count:       Number of positions (nothing happens if <= 0)
+     *  - out_results: count results, in the order of boards
+     *
+     * Behavior:
+     *  - Each result holds the move and exact score getAiMove would give with
+     *    one thread (proven set, depth = empty cells, nodes 0)
+     *  - Terminal, invalid (overlapping pieces, or a side other than 'x'/'o')
+     *    and empty boards get the results of getAiMoveBudgeted: row/col -1
+     *    with the proven terminal score, row/col -1 with score 0, or the
+     *    center unsearched
+     *  - Runs on getSearchThreads() threads, each taking the next position;
+     *    positions with fewer pieces go first, so their transposition table
+     *    entries are there when later positions of the same game are searched
+     *  - Uses an open tablebase but not the opening book; getRootMoveScores
+     *    is not affected
+     *  - After requestSearchStop, positions not finished yet are marked
+     *    aborted (score 0, not proven) with the best move found so far
+     */
+    void getAiMoveBatch(const Bitboard *boards, const char *players, int count,
+                        SearchResult *out_results);
+
+    /**
+     * Set the number of threads used by getAiMove.
+     *
+     * With more than one thread the search runs in parallel (see
+     * setParallelMode). Every parallel mode selects the same move as the
+     * single-threaded search, independent of the thread count.
+     *
+     * Parameters:
+     *  - threads: Thread count, clamped to 1..MAX_SEARCH_THREADS (default: 1)
+     */
+    void setSearchThreads(int threads);
+
+    /** Return the thread count used by getAiMove. */
+    int getSearchThreads(void);
+
+    /**
+     * Select the parallel search algorithm (default: PARALLEL_LAZY_SMP).
+     *
+     *  - PARALLEL_LAZY_SMP: helper threads run the same search with perturbed
+     *    move orders and share results through the transposition table.
+     *  - PARALLEL_YBWC: the first child of each node is searched serially, the
+     *    remaining siblings become tasks on per-thread work-stealing deques;
+     *    a cutoff cancels siblings that are still running.
+     *  - PARALLEL_ROOT_SPLIT: each root move is searched by one worker; the best
+     *    score so far is shared through an atomic alpha bound.
+     */
+    void setParallelMode(ParallelMode mode);
+
+    /** Return the parallel search algorithm. */
+    ParallelMode getParallelMode(void);
+
+    /**
+     * Select the window strategy of the minimax core (default:
+     * SEARCH_ALPHA_BETA, or SEARCH_PVS when built with -DUSE_PVS=1).
+     *
+     *  - SEARCH_ALPHA_BETA: every move is searched with the full window.
+     *  - SEARCH_PVS: the first move of each node gets the full window, later
+     *    moves a null window; a move is re-searched with the full window only
+     *    if the null-window search shows it may be better.
+     *
+     * Both return the same scores and select the same move; they differ only
+     * in the nodes visited. Applies to getAiMove and getAiMoveBudgeted.
+     */
+    void setSearchAlgorithm(SearchAlgorithm algorithm);
+
+    /** Return the window strategy of the minimax core. */
+    SearchAlgorithm getSearchAlgorithm(void);
+
+    /**
+     * Select how getAiMove searches the root (default: ENGINE_SOLVER for
+     * boards of 5x5 and larger, ENGINE_MINIMAX otherwise).
+     *
+     *  - ENGINE_MINIMAX: one search with the full window, using the parallel
+     *    mode when more than one thread is configured.
+     *  - ENGINE_SOLVER: game values are only win, tie or loss, so the root
+     *    asks "can I win?" and then "can I avoid losing?" as two null-window
+     *    searches, each run by the parallel mode when more than one thread is
+     *    configured.
+     *
+     *  - ENGINE_PROOF_NUMBER: the same two questions answered by depth-first
+     *    proof-number search (see proof_number.h), which expands the moves
+     *    that are cheapest to decide first instead of enumerating them in
+     *    order. Uses its own table, not the transposition table.
+     *
+     * The minimax engine and the solver select the same move. The proof-number
+     * engine selects a move with the same game value, not necessarily the
+     * same move among equal ones. The outcome-only engines report loss and tie
+     * scores they decided as exact, and moves they never tested as not
+     * searched. getAiMoveBudgeted is not affected.
+     */
+    void setSearchEngine(SearchEngine engine);
+
+    /** Return the root driver of getAiMove. */
+    SearchEngine getSearchEngine(void);
+
+    /**
+     * Key transposition table entries by board symmetry (default: on for
+     * boards up to 4x4, off from 5x5 up).
+     *
+     * When enabled, a position and its rotations and reflections share one
+     * entry: the search keeps the Zobrist hash of all 8 symmetric images up
+     * to date and uses the smallest as the key, storing best moves in that
+     * image's frame. Entries are compatible across settings, so the table does
+     * not need to be cleared when switching. Never changes the move selected
+     * by getAiMove.
+     */
+    void setSymmetricHashing(int enabled);
+
+    /** Return non-zero if transposition table keys are symmetry-canonical. */
+    int getSymmetricHashing(void);
+
+    /**
+     * Answer getAiMove from the built-in solution table (default: on for
+     * 3x3, the only board size that has one; no effect on other sizes).
+     *
+     * The table holds the game value and best move of every 3x3 position.
+     * It is solved by retrograde analysis on the first getAiMove and shared
+     * by all engines. After that, a move is one base-3 index computation and
+     * one load: no hashing and no transposition table. The move is the one
+     * the search selects. getRootMoveScores scores the moves exactly from
+     * the table when called. An open tablebase or opening book still comes
+     * first, and getAiMoveBudgeted and getAiMoveBatch still search.
+     */
+    void setSolutionTable(int enabled);
+
+    /** Return non-zero if getAiMove reads the built-in solution table. */
+    int getSolutionTable(void);
+
+    /**
+     * Cap the memory of the ENGINE_PROOF_NUMBER table (default:
+     * PROOF_NUMBER_DEFAULT_MEMORY, see proof_number.h). Reallocates and
+     * clears the table right away; otherwise it is allocated on the first
+     * proof-number search. Call only while the engine is not searching.
+     */
+    void setProofNumberMemory(size_t bytes);
+
+    /** Return the memory cap of the proof-number table. */
+    size_t getProofNumberMemory(void);
+
+    /**
+     * Cap the memory of the getAiMoveMcts node pool (default:
+     * MCTS_DEFAULT_MEMORY, see mcts.h). Reallocates the pool right away;
+     * otherwise it is allocated on the first MCTS search. Call only while
+     * the engine is not searching.
      */
-    void getAiMove(Bitboard board, char aiPlayer, int *out_row, int *out_col);
+    void setMctsMemory(size_t bytes);
+
+    /** Return the memory cap of the MCTS node pool. */
+    size_t getMctsMemory(void);
+
+    /**
+     * Clear the killer-move and history tables used to order moves below the
+     * root. They persist across getAiMove/getAiMoveBudgeted calls and across
+     * games (they learn which cells tend to refute moves); clearing them only
+     * changes search effort, never the selected move.
+     */
+    void resetMoveOrdering(void);
+
+    /**
+     * Retrieve the per-move root scores of the most recent getAiMove (or
+     * getAiMoveBudgeted) search.
+     *
+     * Moves are reported in board order (row-major); getAiMoveBudgeted reports
+     * them in its final search order, best first. Moves that failed low
+     * against the best score are upper bounds; the best move and every move
+     * tied with it are exact. Bounds may differ between parallel runs, exact
+     * scores never do.
+     *
+     * Parameters:
+     *  - out_scores: Output array (may be NULL to query the count)
+     *  - max_count:  Capacity of out_scores
+     *
+     * Returns: number of root moves of the last search (0 if getAiMove
+     *          answered without searching, e.g. terminal or empty board)
+     */
+    int getRootMoveScores(RootMoveScore *out_scores, int max_count);
+
+    /**
+     * Stop the running getAiMove, getAiMoveBudgeted or getAiMoveBatch call.
+     * Safe to call from any thread: the search threads poll an atomic flag
+     * at every node and unwind without storing anything, and the call
+     * returns as described for each function. A request made while nothing
+     * is searching stops the next call; the call that returns clears it.
+     */
+    void requestSearchStop(void);
+
+    /**
+     * Withdraw a requestSearchStop that no call has used yet. Only call this
+     * while nothing searches, e.g. after joining a thread whose last search
+     * returned just before the request.
+     */
+    void cancelSearchStop(void);
+
+    /**
+     * Copy the search statistics collected since the start (or the last
+     * resetSearchStats) by getAiMove, getAiMoveBudgeted and getAiMoveBatch,
+     * over all of their threads.
+     *
+     * Returns: non-zero if the build collects statistics (HP_STATS);
+     *          otherwise out_stats is zeroed
+     */
+    int getSearchStats(SearchStats *out_stats);
+
+    /** Zero the search statistics. */
+    void resetSearchStats(void);
+
+    /** Sum the counters of every ply of stats into out_total. */
+    void searchStatsTotal(const SearchStats *stats, SearchPlyStats *out_total);
+
+    /**
+     * Create an engine with the default settings, Zobrist keys drawn from
+     * ZOBRIST_DEFAULT_SEED (transposition.h), a transposition table of
+     * table_size entries (0: no table) and a proof-number table of
+     * PROOF_NUMBER_DEFAULT_MEMORY bytes (proof_number.h).
+     *
+     * Returns: the engine, or NULL if it cannot be allocated
+     */
+    HyperPruneEngine *engineCreate(size_t table_size);
+
+    /**
+     * Free an engine and its tables. Safe to call with NULL; the default
+     * engine is never freed.
+     */
+    void engineDestroy(HyperPruneEngine *engine);
+
+    /**
+     * The engine used by the functions without an engine argument. Its keys
+     * and table are the default ones of transposition.h (zobrist_init,
+     * transposition_table_init); proof_number_table_free releases its
+     * proof-number table and mcts_tree_free its MCTS node pool.
+     */
+    HyperPruneEngine *engineDefault(void);
+
+    /*
+     * Keys and table of an engine, for the reentrant (_r) functions of
+     * transposition.h, e.g. to reseed the keys or resize the table while the
+     * engine is idle.
+     */
+    struct ZobristKeys *engineZobristKeys(HyperPruneEngine *engine);
+    struct TranspositionTable *engineTranspositionTable(HyperPruneEngine *engine);
+
+    /** Copy an engine's counters to out_stats. */
+    void engineGetStats(const HyperPruneEngine *engine, EngineStats *out_stats);
+
+    /* The functions above, on an explicit engine. */
+    int engineGetAiMove(HyperPruneEngine *engine, Bitboard board, char aiPlayer, int *out_row, int *out_col);
+    void engineGetAiMoveBudgeted(HyperPruneEngine *engine, Bitboard board, char aiPlayer,
+                                 const SearchLimits *limits, SearchResult *out_result);
+    void engineGetAiMoveBatch(HyperPruneEngine *engine, const Bitboard *boards, const char *players,
+                              int count, SearchResult *out_results);
+    void engineSetSearchThreads(HyperPruneEngine *engine, int threads);
+    int engineGetSearchThreads(const HyperPruneEngine *engine);
+    void engineSetParallelMode(HyperPruneEngine *engine, ParallelMode mode);
+    ParallelMode engineGetParallelMode(const HyperPruneEngine *engine);
+    void engineSetSearchAlgorithm(HyperPruneEngine *engine, SearchAlgorithm algorithm);
+    SearchAlgorithm engineGetSearchAlgorithm(const HyperPruneEngine *engine);
+    void engineSetSearchEngine(HyperPruneEngine *engine, SearchEngine searchEngine);
+    SearchEngine engineGetSearchEngine(const HyperPruneEngine *engine);
+    void engineSetSymmetricHashing(HyperPruneEngine *engine, int enabled);
+    int engineGetSymmetricHashing(const HyperPruneEngine *engine);
+    void engineSetSolutionTable(HyperPruneEngine *engine, int enabled);
+    int engineGetSolutionTable(const HyperPruneEngine *engine);
+    void engineSetProofNumberMemory(HyperPruneEngine *engine, size_t bytes);
+    size_t engineGetProofNumberMemory(const HyperPruneEngine *engine);
+    void engineSetMctsMemory(HyperPruneEngine *engine, size_t bytes);
+    size_t engineGetMctsMemory(const HyperPruneEngine *engine);
+    void engineResetMoveOrdering(HyperPruneEngine *engine);
+    int engineGetRootMoveScores(const HyperPruneEngine *engine, RootMoveScore *out_scores, int max_count);
+    void engineRequestStop(HyperPruneEngine *engine);
+    void engineCancelStop(HyperPruneEngine *engine);
+    int engineGetSearchStats(const HyperPruneEngine *engine, SearchStats *out_stats);
+    void engineResetSearchStats(HyperPruneEngine *engine);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,379 @@
+/*
+ * Opening book
+ * ------------
+ * See opening_book.h for the API and file layout.
+ *
+ * Generation walks the game one ply at a time: the children of every
+ * position in a layer are put in canonical orientation, sorted and
+ * deduplicated, so each group of symmetric positions is searched once.
+ * Positions where the game is already over are neither stored nor
+ * expanded. The searches run in the canonical orientation, so the stored
+ * move needs no mapping; a probe maps it back through the inverse of the
+ * symmetry that made the queried board canonical.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "opening_book.h"
+#include "search.h"
+#include "bitops.h"
+#include "mapped_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OPENING_BOOK_MAGIC "HPBOOK"
+#define OPENING_BOOK_VERSION 1
+
+/* Cells of the board */
+#define BOOK_BOARD_CELLS (~0ULL >> (64 - MAX_MOVES))
+
+/* File header; the sorted entries follow at data_offset. */
+typedef struct
+{
+    char magic[8];        /* OPENING_BOOK_MAGIC */
+    uint32_t version;     /* OPENING_BOOK_VERSION */
+    uint32_t board_size;  /* BOARD_SIZE of the generator */
+    uint64_t entry_count;
+    uint32_t data_offset;
+    uint32_t plies;       /* Plies the book covers */
+} OpeningBookHeader;
+
+/* One position in canonical orientation, with its move in the same frame. */
+typedef struct
+{
+    uint64_t x_pieces;
+    uint64_t o_pieces;
+    int16_t score;  /* Side to move's view: +100 win, -100 loss, 0 draw; heuristic if not proven */
+    uint8_t cell;   /* Move as row * BOARD_SIZE + col */
+    uint8_t depth;  /* Plies of the search that produced it */
+    uint8_t proven; /* Non-zero if score is the exact game value */
+    uint8_t reserved[3];
+} OpeningBookEntry;
+
+_Static_assert(sizeof(OpeningBookHeader) == 32, "OpeningBookHeader must stay 32 bytes");
+_Static_assert(sizeof(OpeningBookEntry) == 24, "OpeningBookEntry must stay 24 bytes");
+
+/* Open book: the mapping and the entries inside it */
+static MappedFile opening_book_map;
+static const OpeningBookEntry *opening_book_entries = NULL;
+static size_t opening_book_count = 0;
+
+/* Order positions by x pieces, then o pieces. */
+static int bookCompare(uint64_t ax, uint64_t ao, uint64_t bx, uint64_t bo)
+{
+    if (ax != bx)
+        return (ax < bx) ? -1 : 1;
+    if (ao != bo)
+        return (ao < bo) ? -1 : 1;
+    return 0;
+}
+
+static int bookCompareBoards(const void *a, const void *b)
+{
+    const Bitboard *left = (const Bitboard *)a;
+    const Bitboard *right = (const Bitboard *)b;
+    return bookCompare(left->x_pieces, left->o_pieces, right->x_pieces, right->o_pieces);
+}
+
+/*
+ * Canonical orientation of board: the smallest (x, o) pair over the board's
+ * symmetries. The symmetry that produced it goes to out_symmetry.
+ */
+static Bitboard bookCanonical(Bitboard board, int *out_symmetry)
+{
+    Bitboard best = board;
+    int symmetry = 0;
+    for (int s = 1; s < BITBOARD_SYMMETRY_COUNT; s++)
+    {
+        Bitboard mapped = {bitboard_transform(board.x_pieces, s), bitboard_transform(board.o_pieces, s)};
+        if (bookCompare(mapped.x_pieces, mapped.o_pieces, best.x_pieces, best.o_pieces) < 0)
+        {
+            best = mapped;
+            symmetry = s;
+        }
+    }
+    *out_symmetry = symmetry;
+    return best;
+}
+
+/* Inverse of a board symmetry: the rotations by 90 and 270 degrees swap. */
+static int bookInverseSymmetry(int symmetry)
+{
+    if (symmetry == 1)
+        return 3;
+    return (symmetry == 3) ? 1 : symmetry;
+}
+
+/* The side to move by the piece counts, 0 if the counts are not of a game. */
+static char bookSideToMove(Bitboard board)
+{
+    int x_count = POPCOUNT64(board.x_pieces);
+    int o_count = POPCOUNT64(board.o_pieces);
+    if (x_count == o_count)
+        return 'x';
+    return (x_count == o_count + 1) ? 'o' : 0;
+}
+
+/* Search one canonical position and fill its entry. */
+static void bookSolve(Bitboard board, const SearchLimits *limits, OpeningBookEntry *out_entry)
+{
+    char side = bookSideToMove(board);
+    SearchResult result = {-1, -1, 0, 0, 0, 0, 0};
+
+    if (limits != NULL && (limits->max_time_ms > 0 || limits->max_nodes > 0))
+    {
+        getAiMoveBudgeted(board, side, limits, &result);
+    }
+    else
+    {
+        getAiMove(board, side, &result.row, &result.col);
+        RootMoveScore scores[MAX_MOVES];
+        int count = getRootMoveScores(scores, MAX_MOVES);
+        for (int i = 0; i < count; i++)
+        {
+            if (scores[i].row == result.row && scores[i].col == result.col &&
+                scores[i].bound == ROOT_SCORE_EXACT)
+            {
+                result.score = scores[i].score;
+                result.proven = 1;
+                result.depth = MAX_MOVES - POPCOUNT64(board.x_pieces | board.o_pieces);
+            }
+        }
+    }
+
+    memset(out_entry, 0, sizeof(*out_entry));
+    out_entry->x_pieces = board.x_pieces;
+    out_entry->o_pieces = board.o_pieces;
+    out_entry->score = (int16_t)result.score;
+    out_entry->cell = (uint8_t)(result.row * BOARD_SIZE + result.col);
+    out_entry->depth = (uint8_t)result.depth;
+    out_entry->proven = (uint8_t)(result.proven != 0);
+}
+
+/*
+ * Canonical children of every position in layer that are still in play,
+ * sorted and without duplicates. Returns the count (-1 if out of memory);
+ * the caller frees *out_next.
+ */
+static long bookNextLayer(const Bitboard *layer, long count, Bitboard **out_next)
+{
+    size_t capacity = (size_t)count * MAX_MOVES;
+    Bitboard *next = (Bitboard *)malloc(capacity * sizeof(Bitboard));
+    *out_next = next;
+    if (next == NULL)
+        return -1;
+
+    long total = 0;
+    for (long i = 0; i < count; i++)
+    {
+        char side = bookSideToMove(layer[i]);
+        uint64_t empty = ~(layer[i].x_pieces | layer[i].o_pieces) & BOOK_BOARD_CELLS;
+        while (empty)
+        {
+            int cell = lowestCell(empty);
+            empty &= empty - 1;
+
+            Bitboard child = layer[i];
+            bitboard_make_move(&child, cell / BOARD_SIZE, cell % BOARD_SIZE, side);
+            if (bitboard_has_won(side == 'x' ? child.x_pieces : child.o_pieces) ||
+                (child.x_pieces | child.o_pieces) == BOOK_BOARD_CELLS)
+                continue; /* Game over: nothing to book */
+
+            int symmetry;
+            next[total++] = bookCanonical(child, &symmetry);
+        }
+    }
+
+    qsort(next, (size_t)total, sizeof(Bitboard), bookCompareBoards);
+    long unique = 0;
+    for (long i = 0; i < total; i++)
+    {
+        if (unique == 0 || bookCompareBoards(&next[unique - 1], &next[i]) != 0)
+            next[unique++] = next[i];
+    }
+    return unique;
+}
+
+static int bookCompareEntries(const void *a, const void *b)
+{
+    const OpeningBookEntry *left = (const OpeningBookEntry *)a;
+    const OpeningBookEntry *right = (const OpeningBookEntry *)b;
+    return bookCompare(left->x_pieces, left->o_pieces, right->x_pieces, right->o_pieces);
+}
+
+/* Write the header and the sorted entries. Returns 0 on success. */
+static int bookWrite(const char *path, int plies, OpeningBookEntry *entries, long count)
+{
+    qsort(entries, (size_t)count, sizeof(OpeningBookEntry), bookCompareEntries);
+
+    OpeningBookHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OPENING_BOOK_MAGIC, sizeof(OPENING_BOOK_MAGIC));
+    header.version = OPENING_BOOK_VERSION;
+    header.board_size = BOARD_SIZE;
+    header.entry_count = (uint64_t)count;
+    header.data_offset = sizeof(header);
+    header.plies = (uint32_t)plies;
+
+    FILE *file = fopen(path, "wb");
+    int ok = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(entries, sizeof(OpeningBookEntry), (size_t)count, file) == (size_t)count;
+    if (file != NULL && fclose(file) != 0)
+        ok = 0;
+    if (!ok)
+    {
+        fprintf(stderr, "Error: Failed to write opening book '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+long opening_book_generate(const char *path, int plies, const SearchLimits *limits)
+{
+    if (plies < 1 || plies > OPENING_BOOK_MAX_PLIES)
+    {
+        fprintf(stderr, "Error: Opening book plies must be from 1 to %d\n", OPENING_BOOK_MAX_PLIES);
+        return -1;
+    }
+    opening_book_close();
+
+    Bitboard *layer = (Bitboard *)malloc(sizeof(Bitboard));
+    OpeningBookEntry *entries = NULL;
+    long layer_count = (layer != NULL) ? 1 : -1;
+    long entry_count = 0;
+    if (layer != NULL)
+        layer[0] = (Bitboard){0, 0};
+
+    for (int ply = 1; ply <= plies && layer_count > 0; ply++)
+    {
+        Bitboard *next;
+        layer_count = bookNextLayer(layer, layer_count, &next);
+        free(layer);
+        layer = next;
+        if (layer_count <= 0)
+            break;
+
+        OpeningBookEntry *grown = (OpeningBookEntry *)realloc(
+            entries, (size_t)(entry_count + layer_count) * sizeof(OpeningBookEntry));
+        if (grown == NULL)
+        {
+            layer_count = -1;
+            break;
+        }
+        entries = grown;
+        for (long i = 0; i < layer_count; i++)
+            bookSolve(layer[i], limits, &entries[entry_count++]);
+    }
+
+    long result = -1;
+    if (layer_count < 0)
+        fprintf(stderr, "Error: Failed to allocate opening book generator\n");
+    else if (bookWrite(path, plies, entries, entry_count) == 0)
+        result = entry_count;
+    free(layer);
+    free(entries);
+    return result;
+}
+
+int opening_book_open(const char *path)
+{
+    opening_book_close();
+
+    if (mapped_file_open(&opening_book_map, path, sizeof(OpeningBookHeader)) != 0)
+    {
+        fprintf(stderr, "Error: Cannot open opening book '%s'\n", path);
+        return -1;
+    }
+
+    OpeningBookHeader header;
+    memcpy(&header, opening_book_map.data, sizeof(header));
+    size_t available = opening_book_map.size - sizeof(header);
+    if (memcmp(header.magic, OPENING_BOOK_MAGIC, sizeof(OPENING_BOOK_MAGIC)) != 0 ||
+        header.version != OPENING_BOOK_VERSION || header.board_size != BOARD_SIZE ||
+        header.data_offset != sizeof(header) ||
+        header.entry_count > available / sizeof(OpeningBookEntry))
+    {
+        opening_book_close();
+        fprintf(stderr, "Error: '%s' is not a %dx%d opening book\n", path, BOARD_SIZE, BOARD_SIZE);
+        return -1;
+    }
+    opening_book_entries = (const OpeningBookEntry *)((const char *)opening_book_map.data + header.data_offset);
+    opening_book_count = (size_t)header.entry_count;
+    return 0;
+}
+
+void opening_book_close(void)
+{
+    mapped_file_close(&opening_book_map);
+    opening_book_entries = NULL;
+    opening_book_count = 0;
+}
+
+int opening_book_is_open(void)
+{
+    return opening_book_entries != NULL;
+}
+
+int opening_book_probe(Bitboard board, SearchResult *out_result)
+{
+    if (opening_book_entries == NULL || (board.x_pieces & board.o_pieces) || bookSideToMove(board) == 0)
+        return 0;
+
+    int symmetry;
+    Bitboard key = bookCanonical(board, &symmetry);
+
+    size_t low = 0;
+    size_t high = opening_book_count;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        const OpeningBookEntry *entry = &opening_book_entries[mid];
+        int order = bookCompare(entry->x_pieces, entry->o_pieces, key.x_pieces, key.o_pieces);
+        if (order < 0)
+        {
+            low = mid + 1;
+        }
+        else if (order > 0)
+        {
+            high = mid;
+        }
+        else
+        {
+            uint64_t move = bitboard_transform(1ULL << entry->cell, bookInverseSymmetry(symmetry));
+            int cell = lowestCell(move);
+            out_result->row = cell / BOARD_SIZE;
+            out_result->col = cell % BOARD_SIZE;
+            out_result->score = entry->score;
+            out_result->proven = entry->proven;
+            out_result->depth = entry->depth;
+            out_result->nodes = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint64_t opening_book_hits(void)
+{
+    EngineStats stats;
+    engineGetStats(engineDefault(), &stats);
+    return stats.book_hits;
+}
+
+int openingBookSearchRoot(Bitboard board, char aiPlayer, int requireProven, Move *out_best,
+                          SearchResult *out_result)
+{
+    SearchResult entry;
+    if (bookSideToMove(board) != aiPlayer || !opening_book_probe(board, &entry) ||
+        (requireProven && !entry.proven) || !bitboard_is_empty(board, entry.row, entry.col))
+        return 0;
+
+    out_best->row = entry.row;
+    out_best->col = entry.col;
+    if (out_result != NULL)
+        *out_result = entry;
+    return 1;
+}
@@ -0,0 +1,99 @@
+/*
+ * Opening book
+ * ------------
+ * The searched move of every position in the first plies of the game,
+ * computed once and stored in a file that getAiMove answers from without
+ * searching. Meant for 4x4 and larger, where the first moves cost the most
+ * search time.
+ *
+ * Key components:
+ *  - Generator: every position reachable in 1..plies moves, one per group
+ *    of positions that a rotation or reflection maps onto each other,
+ *    searched with getAiMove (or getAiMoveBudgeted within a budget)
+ *  - Entries: the position in its canonical orientation (the smallest
+ *    bitboards over the 8 symmetries), the move, score, proven flag and
+ *    search depth, sorted by position; native byte order
+ *  - Lookup: the file is memory-mapped read-only and binary-searched in
+ *    place; the move is mapped back to the queried orientation
+ *
+ * Usage:
+ *  1. Call init_win_masks() once at program startup (and zobrist_init() and
+ *     transposition_table_init() before generating, as for getAiMove)
+ *  2. Once per board size: opening_book_generate(path, plies, limits)
+ *  3. Call opening_book_open(path); getAiMove and getAiMoveBudgeted then
+ *     use the book
+ *  4. Call opening_book_close() at program exit
+ */
+
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <stdint.h>
+#include "../TicTacToe/tic_tac_toe.h"
+#include "mini_max.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Upper bound for the plies of opening_book_generate */
+#define OPENING_BOOK_MAX_PLIES 8
+
+    /**
+     * Search every position of the first plies moves and write the book to
+     * path. Any open book is closed first, so the searches do not read it.
+     *
+     * Parameters:
+     *  - path:   Output file (replaced if it exists)
+     *  - plies:  Moves from the empty board, 1..OPENING_BOOK_MAX_PLIES
+     *  - limits: Budget per position for getAiMoveBudgeted; NULL or all
+     *            zero: full getAiMove searches, every entry proven
+     *
+     * Returns: number of entries written, -1 on error (message on stderr)
+     */
+    long opening_book_generate(const char *path, int plies, const SearchLimits *limits);
+
+    /**
+     * Map a book written by opening_book_generate for this board size.
+     * Replaces any book already open.
+     *
+     * Returns: 0 on success, -1 if the file is missing or does not match
+     *          (message on stderr)
+     */
+    int opening_book_open(const char *path);
+
+    /**
+     * Unmap the open book.
+     * Safe to call even if none is open.
+     */
+    void opening_book_close(void);
+
+    /** Return non-zero if a book is open. */
+    int opening_book_is_open(void);
+
+    /**
+     * Look up a position.
+     *
+     * Parameters:
+     *  - board:      Position with the side to move implied by the piece
+     *                counts ('x' if equal, 'o' if x has one more)
+     *  - out_result: Book move, score for the side to move, proven flag and
+     *                depth of the search that produced it (nodes is 0)
+     *
+     * Returns: 1 if the position is in the book, 0 otherwise
+     */
+    int opening_book_probe(Bitboard board, SearchResult *out_result);
+
+    /**
+     * Moves that getAiMove and getAiMoveBudgeted took from the book since
+     * the program started (book_hits of the default engine; see
+     * engineGetStats for other engines).
+     */
+    uint64_t opening_book_hits(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
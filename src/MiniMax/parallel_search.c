@@ -0,0 +1,897 @@
+/*
+ * Parallel search drivers
+ * -----------------------
+ *
+ * Lazy SMP:
+ *  - The calling thread runs the normal root search (order offset 0)
+ *  - Helper threads run the same search with rotated move orders, so they
+ *    reach different subtrees first and publish exact results to the shared
+ *    transposition table, where the main thread picks them up
+ *  - When the main thread finishes, helpers are stopped and joined; aborted
+ *    helpers never store partial results
+ *
+ * Young Brothers Wait (YBWC):
+ *  - At every node the first child (the eldest brother) is searched serially;
+ *    only then are the remaining siblings published as tasks on the owning
+ *    thread's work-stealing deque (owner pops the bottom, thieves steal the top)
+ *  - Idle threads steal tasks and search them with the split point's current
+ *    window; a cutoff lowers the split point's cutoff_index, which cancels
+ *    every running or queued sibling behind it (and their whole subtrees)
+ *  - The owner works through its own tasks, then helps with tasks below its
+ *    split point until every stolen sibling has finished
+ *  - At the root, ties are searched with a window one below the best score and
+ *    resolved by move index, so the chosen move equals the sequential one
+ *
+ * Root split:
+ *  - Threads (the caller included) take root moves one at a time from a shared
+ *    counter and search each one sequentially below the root
+ *  - The best exact root score is shared as alpha; every move is searched
+ *    with a window one below it, so ties stay exact and resolve by index
+ *  - A winning move cancels only the root moves after it, as in YBWC
+ *  - Every root move reports its score and whether it is exact or only an
+ *    upper bound (see getRootMoveScores)
+ *
+ * Outcome-only solver (ENGINE_SOLVER):
+ *  - Each mode runs the solver's "win?" and "tie?" null-window probes:
+ *    Lazy SMP helpers solve the whole root with rotated orders, YBWC splits
+ *    the nodes below each probed root move, and root split hands the root
+ *    moves of each probe to the threads one at a time
+ *  - A root move that passes a probe cancels only the moves after it, so
+ *    the choice matches the sequential solver
+ *
+ * Batch (getAiMoveBatch):
+ *  - Independent positions instead of one root: threads (the caller
+ *    included) take positions one at a time from a shared counter and search
+ *    each to the end of the game, single-threaded
+ *  - Positions are handed out fewest pieces first: the largest trees start
+ *    early, and the entries they store in the shared transposition table
+ *    answer later positions of the same games
+ *
+ * Only the calling thread orders moves with the engine's killer/history
+ * tables; helper threads keep plain (or rotated) move order, so the tables
+ * are never shared. Every thread searches with the engine's keys and table.
+ * In HP_STATS builds helpers count into their own statistics, added to the
+ * engine's once they are joined.
+ *
+ * Scores in this engine are depth-independent, so every TT entry written by a
+ * helper is valid for the main thread regardless of where it was produced.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "mini_max.h"
+#include "search.h"
+#include "transposition.h"
+#include "threading.h"
+#include "bitops.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/* Minimum empty cells at a node before its siblings are offered to other threads. */
+#define YBWC_MIN_SPLIT_EMPTY 6
+
+/* Deque capacity: fewer than MAX_MOVES tasks per split, at most one split per ply. */
+#define YBWC_DEQUE_CAPACITY (MAX_MOVES * MAX_MOVES)
+
+/* Arguments for one Lazy SMP helper thread. */
+typedef struct
+{
+    SearchContext ctx;
+    Bitboard board;
+    char aiPlayer;
+    const MoveList *moves;
+    int solve; /* Non-zero: solveRoot instead of searchRoot */
+} LazySmpHelper;
+
+THREAD_FUNC(lazySmpHelperMain, arg)
+{
+    LazySmpHelper *helper = (LazySmpHelper *)arg;
+    Move ignored;
+    if (helper->solve)
+    {
+        RootScoreList scores;
+        solveRoot(&helper->ctx, helper->board, helper->aiPlayer, helper->moves, probeRoot, &ignored, &scores);
+    }
+    else
+    {
+        searchRoot(&helper->ctx, helper->board, helper->aiPlayer, helper->moves, SEARCH_DEPTH_FULL,
+                   &ignored, NULL);
+    }
+    THREAD_RETURN;
+}
+
+/* Lazy SMP around searchRoot, or around solveRoot if solve is non-zero. */
+static int lazySmpRun(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                      int threadCount, int solve, Move *out_best, RootScoreList *out_scores)
+{
+    int stop = 0;
+    LazySmpHelper helpers[MAX_SEARCH_THREADS];
+    ThreadHandle handles[MAX_SEARCH_THREADS];
+    SearchStats *stats = searchStatsAcquire(threadCount - 1);
+    int started = 0;
+
+    /* Helpers stop when the main thread returns: none for a search already stopped */
+    for (int t = 1; t < threadCount && !atomic_load_int(&engine->stop); t++)
+    {
+        LazySmpHelper *helper = &helpers[started];
+        helper->ctx = (SearchContext){engine, &stop, t, NULL, NULL, 0, NULL, NULL,
+                                      searchStatsSlot(stats, started)}; /* Distinct rotation per helper */
+        helper->board = board;
+        helper->aiPlayer = aiPlayer;
+        helper->moves = moves;
+        helper->solve = solve;
+
+        /* Thread creation failure only costs parallelism, never correctness */
+        if (thread_create(&handles[started], lazySmpHelperMain, helper) != 0)
+            break;
+        started++;
+    }
+
+    SearchContext ctx = {engine, &engine->stop, 0, NULL, NULL, 0, NULL, &engine->ordering, searchStatsOf(engine)};
+    int bestScore = solve ? solveRoot(&ctx, board, aiPlayer, moves, probeRoot, out_best, out_scores)
+                          : searchRoot(&ctx, board, aiPlayer, moves, SEARCH_DEPTH_FULL, out_best, out_scores);
+
+    atomic_store_int(&stop, 1);
+    for (int t = 0; t < started; t++)
+        thread_join(handles[t]);
+    searchStatsRelease(engine, stats, threadCount - 1);
+
+    return bestScore;
+}
+
+int lazySmpSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                      int threadCount, Move *out_best, RootScoreList *out_scores)
+{
+    return lazySmpRun(engine, board, aiPlayer, moves, threadCount, 0, out_best, out_scores);
+}
+
+int lazySmpSolveRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                     int threadCount, Move *out_best, RootScoreList *out_scores)
+{
+    return lazySmpRun(engine, board, aiPlayer, moves, threadCount, 1, out_best, out_scores);
+}
+
+/* Shared state of one node whose siblings are searched in parallel. */
+struct SplitPoint
+{
+    ThreadMutex lock;
+    Bitboard board;
+    const MoveList *moves; /* Owner's move list, alive until the split finishes */
+    char player; /* Side to move at the split node; scores are from its view */
+    int depth;   /* Remaining plies at the split node */
+    int root;              /* Root split: ties are searched exactly and resolved by index */
+    RootScoreList *scores; /* Root only: per-move results, or NULL */
+
+    /* Protected by lock */
+    int alpha;
+    int beta;
+    int bestScore;
+    int bestIndex;
+
+    int cutoff_index; /* Atomic: tasks with a greater index are cancelled */
+    int pending;      /* Atomic: tasks not finished yet */
+    const TaskFrame *parent_frame;
+};
+
+typedef struct
+{
+    SplitPoint *sp;
+    int index;
+} Task;
+
+/* Work-stealing deque: the owner pushes/pops at bottom, thieves take the top. */
+typedef struct
+{
+    ThreadMutex lock;
+    unsigned top;
+    unsigned bottom;
+    Task tasks[YBWC_DEQUE_CAPACITY];
+} TaskDeque;
+
+typedef struct
+{
+    YbwcPool *pool;
+    int thread_id;
+    SearchStats *stats;
+} YbwcWorker;
+
+struct YbwcPool
+{
+    HyperPruneEngine *engine;
+    int thread_count;
+    int done; /* Atomic: set when the root search has finished */
+    int idle; /* Atomic: workers currently looking for work */
+    TaskDeque *deques;
+
+    YbwcWorker workers[MAX_SEARCH_THREADS];
+    ThreadHandle handles[MAX_SEARCH_THREADS];
+    SearchStats *stats; /* The workers' statistics */
+    int started;        /* Workers running */
+};
+
+static void dequePushBottom(TaskDeque *deque, Task task)
+{
+    mutex_lock(&deque->lock);
+    deque->tasks[deque->bottom % YBWC_DEQUE_CAPACITY] = task;
+    deque->bottom++;
+    mutex_unlock(&deque->lock);
+}
+
+/* Pop the newest task, but only if it belongs to sp. */
+static int dequePopBottom(TaskDeque *deque, const SplitPoint *sp, Task *out_task)
+{
+    int found = 0;
+    mutex_lock(&deque->lock);
+    if (deque->bottom != deque->top &&
+        deque->tasks[(deque->bottom - 1) % YBWC_DEQUE_CAPACITY].sp == sp)
+    {
+        deque->bottom--;
+        *out_task = deque->tasks[deque->bottom % YBWC_DEQUE_CAPACITY];
+        found = 1;
+    }
+    mutex_unlock(&deque->lock);
+    return found;
+}
+
+/* Non-zero if sp is ancestor or lies below it in the split point tree. */
+static int splitDescendsFrom(const SplitPoint *sp, const SplitPoint *ancestor)
+{
+    if (sp == ancestor)
+        return 1;
+    for (const TaskFrame *frame = sp->parent_frame; frame != NULL; frame = frame->parent)
+    {
+        if (frame->sp == ancestor)
+            return 1;
+    }
+    return 0;
+}
+
+/* Steal the oldest task from another thread's deque (below ancestor, if given). */
+static int dequeSteal(YbwcPool *pool, int self, const SplitPoint *ancestor, Task *out_task)
+{
+    for (int k = 1; k < pool->thread_count; k++)
+    {
+        TaskDeque *deque = &pool->deques[(self + k) % pool->thread_count];
+        int found = 0;
+
+        mutex_lock(&deque->lock);
+        if (deque->bottom != deque->top)
+        {
+            Task task = deque->tasks[deque->top % YBWC_DEQUE_CAPACITY];
+            if (ancestor == NULL || splitDescendsFrom(task.sp, ancestor))
+            {
+                deque->top++;
+                *out_task = task;
+                found = 1;
+            }
+        }
+        mutex_unlock(&deque->lock);
+
+        if (found)
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * Fold one finished sibling, searched with lower bound alpha, into its split
+ * point; cancel the rest on a cutoff.
+ */
+static void splitReport(SplitPoint *sp, int index, int alpha, int score)
+{
+    mutex_lock(&sp->lock);
+
+    if (sp->scores != NULL)
+    {
+        sp->scores->moves[index].score = score;
+        sp->scores->moves[index].bound = (score > alpha) ? ROOT_SCORE_EXACT : ROOT_SCORE_UPPER_BOUND;
+    }
+
+    if (score > sp->bestScore || (sp->root && score == sp->bestScore && index < sp->bestIndex))
+    {
+        sp->bestScore = score;
+        sp->bestIndex = index;
+    }
+    if (score > sp->alpha)
+        sp->alpha = score;
+
+    if (sp->bestScore == AI_WIN_SCORE || sp->beta <= sp->alpha)
+    {
+        /* At the root only later moves may go: an earlier win must still be found */
+        int limit = sp->root ? sp->bestIndex : -1;
+        if (limit < atomic_load_int(&sp->cutoff_index))
+            atomic_store_int(&sp->cutoff_index, limit);
+    }
+
+    mutex_unlock(&sp->lock);
+}
+
+/* Search one sibling task of a split point on the calling thread. */
+static void executeTask(const SearchContext *ctx, Task task)
+{
+    SplitPoint *sp = task.sp;
+    TaskFrame frame = {sp, &sp->cutoff_index, task.index, sp->parent_frame};
+    SearchContext taskCtx = *ctx;
+    taskCtx.frame = &frame;
+
+    if (!searchAborted(&taskCtx))
+    {
+        mutex_lock(&sp->lock);
+        int alpha = sp->root ? sp->bestScore - 1 : sp->alpha;
+        int beta = sp->beta;
+        mutex_unlock(&sp->lock);
+
+        Move move = sp->moves->moves[task.index];
+        char opponent = (sp->player == 'x') ? 'o' : 'x';
+        Bitboard board = sp->board;
+        bitboard_make_move(&board, move.row, move.col, sp->player);
+
+        /* A move of the split node, whose own node the owner counted (the root counts none) */
+        SEARCH_STATS_NODE(split_stats, &taskCtx, sp->board);
+        SEARCH_STATS_ADD(split_stats, moves_searched, !sp->root);
+
+        int score = -searchNode(&taskCtx, board, opponent, -beta, -alpha, searchChildDepth(sp->depth));
+
+        if (!searchAborted(&taskCtx))
+            splitReport(sp, task.index, alpha, score);
+    }
+
+    atomic_fetch_add_int(&sp->pending, -1);
+}
+
+/*
+ * Publish moves[first..count) of sp as tasks, work on them, then help below
+ * sp until every stolen task has finished. Returns the split's best score.
+ */
+static int runSplit(SearchContext *ctx, SplitPoint *sp, int first)
+{
+    TaskDeque *own = &ctx->pool->deques[ctx->thread_id];
+
+    sp->cutoff_index = INT_MAX;
+    sp->pending = sp->moves->count - first;
+    sp->parent_frame = ctx->frame;
+    mutex_init(&sp->lock);
+
+    /* Reverse order so the owner pops the best-ordered sibling first */
+    for (int i = sp->moves->count - 1; i >= first; i--)
+        dequePushBottom(own, (Task){sp, i});
+
+    Task task;
+    while (dequePopBottom(own, sp, &task))
+        executeTask(ctx, task);
+
+    while (atomic_fetch_add_int(&sp->pending, 0) > 0)
+    {
+        if (dequeSteal(ctx->pool, ctx->thread_id, sp, &task))
+            executeTask(ctx, task);
+        else
+            thread_yield();
+    }
+
+    mutex_lock(&sp->lock);
+    int bestScore = sp->bestScore;
+    mutex_unlock(&sp->lock);
+    mutex_destroy(&sp->lock);
+    return bestScore;
+}
+
+int ybwcShouldSplit(const SearchContext *ctx, int emptyCount)
+{
+    return emptyCount >= YBWC_MIN_SPLIT_EMPTY && atomic_load_int(&ctx->pool->idle) > 0;
+}
+
+int ybwcSearchSiblings(SearchContext *ctx, Bitboard board, char player,
+                       const MoveList *moves, int first, int depth,
+                       int alpha, int beta, int bestScore, int *inout_bestIndex)
+{
+    SplitPoint sp;
+    sp.board = board;
+    sp.moves = moves;
+    sp.player = player;
+    sp.depth = depth;
+    sp.root = 0;
+    sp.scores = NULL;
+    sp.alpha = alpha;
+    sp.beta = beta;
+    sp.bestScore = bestScore;
+    sp.bestIndex = *inout_bestIndex;
+
+    bestScore = runSplit(ctx, &sp, first);
+    *inout_bestIndex = sp.bestIndex;
+    return bestScore;
+}
+
+THREAD_FUNC(ybwcWorkerMain, arg)
+{
+    YbwcWorker *worker = (YbwcWorker *)arg;
+    YbwcPool *pool = worker->pool;
+    SearchContext ctx = {pool->engine, &pool->engine->stop, 0, pool, NULL, worker->thread_id, NULL, NULL,
+                         worker->stats};
+    Task task;
+
+    while (!atomic_load_int(&pool->done))
+    {
+        if (dequeSteal(pool, worker->thread_id, NULL, &task))
+        {
+            atomic_fetch_add_int(&pool->idle, -1);
+            executeTask(&ctx, task);
+            atomic_fetch_add_int(&pool->idle, 1);
+        }
+        else
+        {
+            thread_yield();
+        }
+    }
+    THREAD_RETURN;
+}
+
+/*
+ * Start threadCount - 1 workers on pool; the calling thread is thread 0.
+ * Returns 0 (and starts nothing) if the deques cannot be allocated.
+ */
+static int ybwcPoolStart(YbwcPool *pool, HyperPruneEngine *engine, int threadCount)
+{
+    pool->engine = engine;
+    pool->done = 0;
+    pool->idle = 0;
+    pool->deques = (TaskDeque *)calloc((size_t)threadCount, sizeof(TaskDeque));
+    if (pool->deques == NULL)
+        return 0;
+    for (int t = 0; t < threadCount; t++)
+        mutex_init(&pool->deques[t].lock);
+
+    /* Deques must exist for every id before any worker starts stealing */
+    pool->thread_count = threadCount;
+    pool->stats = searchStatsAcquire(threadCount - 1);
+    pool->started = 0;
+    for (int t = 1; t < threadCount; t++)
+    {
+        int w = pool->started;
+        pool->workers[w] = (YbwcWorker){pool, t, searchStatsSlot(pool->stats, w)};
+        atomic_fetch_add_int(&pool->idle, 1);
+        if (thread_create(&pool->handles[w], ybwcWorkerMain, &pool->workers[w]) != 0)
+        {
+            atomic_fetch_add_int(&pool->idle, -1);
+            break;
+        }
+        pool->started++;
+    }
+    return 1;
+}
+
+/* Stop and join the workers of pool once the root search has finished. */
+static void ybwcPoolFinish(YbwcPool *pool)
+{
+    atomic_store_int(&pool->done, 1);
+    for (int t = 0; t < pool->started; t++)
+        thread_join(pool->handles[t]);
+    searchStatsRelease(pool->engine, pool->stats, pool->thread_count - 1);
+    for (int t = 0; t < pool->thread_count; t++)
+        mutex_destroy(&pool->deques[t].lock);
+    free(pool->deques);
+}
+
+int ybwcSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                   int threadCount, Move *out_best, RootScoreList *out_scores)
+{
+    YbwcPool pool;
+    if (!ybwcPoolStart(&pool, engine, threadCount))
+    {
+        SearchContext ctx = {engine, &engine->stop, 0, NULL, NULL, 0, NULL, &engine->ordering, searchStatsOf(engine)};
+        return searchRoot(&ctx, board, aiPlayer, moves, SEARCH_DEPTH_FULL, out_best, out_scores);
+    }
+
+    SearchContext ctx = {engine, &engine->stop, 0, &pool, NULL, 0, NULL, &engine->ordering, searchStatsOf(engine)};
+    char opponent = (aiPlayer == 'x') ? 'o' : 'x';
+
+    /* Eldest brother at the root: serial, full window */
+    Move first = moves->moves[0];
+    Bitboard child = board;
+    bitboard_make_move(&child, first.row, first.col, aiPlayer);
+    int bestScore = -searchNode(&ctx, child, opponent, -INF, INF, SEARCH_DEPTH_FULL);
+    int bestIndex = 0;
+
+    rootScoresReset(out_scores, moves);
+    if (!searchAborted(&ctx))
+    {
+        out_scores->moves[0].score = bestScore;
+        out_scores->moves[0].bound = ROOT_SCORE_EXACT;
+    }
+
+    if (bestScore != AI_WIN_SCORE && moves->count > 1 && !searchAborted(&ctx))
+    {
+        SplitPoint sp;
+        sp.board = board;
+        sp.moves = moves;
+        sp.player = aiPlayer;
+        sp.depth = SEARCH_DEPTH_FULL;
+        sp.root = 1;
+        sp.scores = out_scores;
+        sp.alpha = bestScore;
+        sp.beta = INF;
+        sp.bestScore = bestScore;
+        sp.bestIndex = 0;
+
+        bestScore = runSplit(&ctx, &sp, 1);
+        bestIndex = sp.bestIndex;
+    }
+
+    ybwcPoolFinish(&pool);
+
+    *out_best = moves->moves[bestIndex];
+    return bestScore;
+}
+
+int ybwcSolveRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                  int threadCount, Move *out_best, RootScoreList *out_scores)
+{
+    YbwcPool pool;
+    int pooled = ybwcPoolStart(&pool, engine, threadCount);
+
+    /* Without a pool the probes simply run sequentially */
+    SearchContext ctx = {engine, &engine->stop, 0, pooled ? &pool : NULL, NULL, 0, NULL, &engine->ordering,
+                         searchStatsOf(engine)};
+    int score = solveRoot(&ctx, board, aiPlayer, moves, probeRoot, out_best, out_scores);
+
+    if (pooled)
+        ybwcPoolFinish(&pool);
+    return score;
+}
+
+/* Shared state of a root split search. */
+typedef struct
+{
+    HyperPruneEngine *engine;
+    Bitboard board;
+    const MoveList *moves;
+    char aiPlayer;
+    RootScoreList *scores; /* Each entry is written by the thread that took the move */
+
+    int next_index;   /* Atomic: next root move to hand out */
+    int alpha;        /* Atomic: best exact root score so far */
+    int cutoff_index; /* Atomic: moves with a greater index are cancelled */
+} RootSplit;
+
+/* Raise the shared alpha to score unless another thread already went higher. */
+static void rootSplitRaiseAlpha(RootSplit *split, int score)
+{
+    int current = atomic_load_int(&split->alpha);
+    while (score > current && !atomic_compare_exchange_int(&split->alpha, current, score))
+        current = atomic_load_int(&split->alpha);
+}
+
+/* Arguments for one root split worker thread. */
+typedef struct
+{
+    RootSplit *split;
+    SearchStats *stats;
+} RootSplitWorker;
+
+/*
+ * Take root moves until none are left (or all remaining ones are cancelled).
+ * ordering and stats are the calling thread's killer/history tables and
+ * statistics, or NULL.
+ */
+static void rootSplitWork(RootSplit *split, MoveOrdering *ordering, SearchStats *stats)
+{
+    for (;;)
+    {
+        int index = atomic_fetch_add_int(&split->next_index, 1);
+        if (index >= split->moves->count || index > atomic_load_int(&split->cutoff_index))
+            break;
+
+        TaskFrame frame = {NULL, &split->cutoff_index, index, NULL};
+        SearchContext ctx = {split->engine, &split->engine->stop, 0, NULL, &frame, 0, NULL, ordering, stats};
+
+        /* One below the best score: a tie must come back exact */
+        int bestSoFar = atomic_load_int(&split->alpha);
+        int alpha = (bestSoFar == -INF) ? -INF : bestSoFar - 1;
+
+        Move move = split->moves->moves[index];
+        Bitboard child = split->board;
+        bitboard_make_move(&child, move.row, move.col, split->aiPlayer);
+
+        char opponent = (split->aiPlayer == 'x') ? 'o' : 'x';
+        int score = -searchNode(&ctx, child, opponent, -INF, -alpha, SEARCH_DEPTH_FULL);
+        if (searchAborted(&ctx))
+            continue;
+
+        split->scores->moves[index].score = score;
+        if (score > alpha)
+        {
+            split->scores->moves[index].bound = ROOT_SCORE_EXACT;
+            rootSplitRaiseAlpha(split, score);
+        }
+        else
+        {
+            split->scores->moves[index].bound = ROOT_SCORE_UPPER_BOUND;
+        }
+
+        /* Later moves cannot beat a win; earlier ones must still finish */
+        if (score == AI_WIN_SCORE)
+        {
+            int current = atomic_load_int(&split->cutoff_index);
+            while (index < current && !atomic_compare_exchange_int(&split->cutoff_index, current, index))
+                current = atomic_load_int(&split->cutoff_index);
+        }
+    }
+}
+
+THREAD_FUNC(rootSplitWorkerMain, arg)
+{
+    RootSplitWorker *worker = (RootSplitWorker *)arg;
+    rootSplitWork(worker->split, NULL, worker->stats);
+    THREAD_RETURN;
+}
+
+int rootSplitSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                        int threadCount, Move *out_best, RootScoreList *out_scores)
+{
+    RootSplit split;
+    split.engine = engine;
+    split.board = board;
+    split.moves = moves;
+    split.aiPlayer = aiPlayer;
+    split.scores = out_scores;
+    split.next_index = 0;
+    split.alpha = -INF;
+    split.cutoff_index = INT_MAX;
+    rootScoresReset(out_scores, moves);
+
+    RootSplitWorker workers[MAX_SEARCH_THREADS];
+    ThreadHandle handles[MAX_SEARCH_THREADS];
+    SearchStats *stats = searchStatsAcquire(threadCount - 1);
+    int started = 0;
+    for (int t = 1; t < threadCount; t++)
+    {
+        workers[started] = (RootSplitWorker){&split, searchStatsSlot(stats, started)};
+        if (thread_create(&handles[started], rootSplitWorkerMain, &workers[started]) != 0)
+            break;
+        started++;
+    }
+
+    rootSplitWork(&split, &engine->ordering, searchStatsOf(engine));
+    for (int t = 0; t < started; t++)
+        thread_join(handles[t]);
+    searchStatsRelease(engine, stats, threadCount - 1);
+
+    /* First move with the highest exact score, as in the sequential root loop */
+    int bestIndex = 0;
+    int bestScore = -INF;
+    for (int i = 0; i < out_scores->count; i++)
+    {
+        const RootMoveScore *entry = &out_scores->moves[i];
+        if (entry->bound == ROOT_SCORE_EXACT && entry->score > bestScore)
+        {
+            bestScore = entry->score;
+            bestIndex = i;
+        }
+    }
+
+    *out_best = moves->moves[bestIndex];
+    return bestScore;
+}
+
+/* Shared state of one root split null-window probe. */
+typedef struct
+{
+    HyperPruneEngine *engine;
+    const int *stop;
+    Bitboard board;
+    const MoveList *moves;
+    const int *order; /* Root moves in hand-out order */
+    char aiPlayer;
+    int alpha;
+    int *passed; /* Each entry is written by the thread that took the move */
+
+    int next;         /* Atomic: next entry of order to hand out */
+    int cutoff_index; /* Atomic: moves with a greater index are cancelled */
+} RootSplitProbe;
+
+/* Arguments for one root split probe worker thread. */
+typedef struct
+{
+    RootSplitProbe *probe;
+    SearchStats *stats;
+} RootSplitProbeWorker;
+
+/*
+ * Probe root moves until none are left. A move that passes cancels only the
+ * moves after it: an earlier one that passes must still win the choice.
+ */
+static void rootSplitProbeWork(RootSplitProbe *probe, MoveOrdering *ordering, SearchStats *stats)
+{
+    char opponent = (probe->aiPlayer == 'x') ? 'o' : 'x';
+    for (;;)
+    {
+        int next = atomic_fetch_add_int(&probe->next, 1);
+        if (next >= probe->moves->count)
+            break;
+
+        int index = probe->order[next];
+        if (index > atomic_load_int(&probe->cutoff_index))
+            continue;
+
+        TaskFrame frame = {NULL, &probe->cutoff_index, index, NULL};
+        SearchContext ctx = {probe->engine, probe->stop, 0, NULL, &frame, 0, NULL, ordering, stats};
+
+        Move move = probe->moves->moves[index];
+        Bitboard child = probe->board;
+        bitboard_make_move(&child, move.row, move.col, probe->aiPlayer);
+        int score = -searchNode(&ctx, child, opponent, -probe->alpha - 1, -probe->alpha, SEARCH_DEPTH_FULL);
+        if (searchAborted(&ctx))
+            continue;
+
+        probe->passed[index] = (score > probe->alpha);
+        if (score > probe->alpha)
+        {
+            int current = atomic_load_int(&probe->cutoff_index);
+            while (index < current && !atomic_compare_exchange_int(&probe->cutoff_index, current, index))
+                current = atomic_load_int(&probe->cutoff_index);
+        }
+    }
+}
+
+THREAD_FUNC(rootSplitProbeWorkerMain, arg)
+{
+    RootSplitProbeWorker *worker = (RootSplitProbeWorker *)arg;
+    rootSplitProbeWork(worker->probe, NULL, worker->stats);
+    THREAD_RETURN;
+}
+
+/* RootProbe of rootSplitSolveRoot: the engine's threads share the root moves. */
+static int rootSplitProbeRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves,
+                              const int *order, int alpha, int *out_passed)
+{
+    HyperPruneEngine *engine = ctx->engine;
+    int threadCount = engine->thread_count;
+    for (int i = 0; i < moves->count; ++i)
+        out_passed[i] = -1;
+
+    RootSplitProbe probe;
+    probe.engine = engine;
+    probe.stop = ctx->stop;
+    probe.board = board;
+    probe.moves = moves;
+    probe.order = order;
+    probe.aiPlayer = aiPlayer;
+    probe.alpha = alpha;
+    probe.passed = out_passed;
+    probe.next = 0;
+    probe.cutoff_index = INT_MAX;
+
+    RootSplitProbeWorker workers[MAX_SEARCH_THREADS];
+    ThreadHandle handles[MAX_SEARCH_THREADS];
+    SearchStats *stats = searchStatsAcquire(threadCount - 1);
+    int started = 0;
+    for (int t = 1; t < threadCount; t++)
+    {
+        workers[started] = (RootSplitProbeWorker){&probe, searchStatsSlot(stats, started)};
+        if (thread_create(&handles[started], rootSplitProbeWorkerMain, &workers[started]) != 0)
+            break;
+        started++;
+    }
+
+    rootSplitProbeWork(&probe, ctx->ordering, ctx->stats);
+    for (int t = 0; t < started; t++)
+        thread_join(handles[t]);
+    searchStatsRelease(engine, stats, threadCount - 1);
+
+    if (searchAborted(ctx))
+        return -1;
+    int found = atomic_load_int(&probe.cutoff_index);
+    return (found == INT_MAX) ? -1 : found;
+}
+
+int rootSplitSolveRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                       int threadCount, Move *out_best, RootScoreList *out_scores)
+{
+    (void)threadCount; /* The probes read it from the engine */
+    SearchContext ctx = {engine, &engine->stop, 0, NULL, NULL, 0, NULL, &engine->ordering, searchStatsOf(engine)};
+    return solveRoot(&ctx, board, aiPlayer, moves, rootSplitProbeRoot, out_best, out_scores);
+}
+
+/* Shared state of a getAiMoveBatch call. */
+typedef struct
+{
+    HyperPruneEngine *engine;
+    const Bitboard *boards;
+    const char *players;
+    SearchResult *results; /* Each entry is written by the thread that took the position */
+    const int *order;      /* Positions in hand-out order, NULL for index order */
+    int count;
+    int next; /* Atomic: next entry of order to hand out */
+} BatchSearch;
+
+/* Arguments for one batch worker thread. */
+typedef struct
+{
+    BatchSearch *batch;
+    SearchStats *stats;
+} BatchWorker;
+
+/*
+ * Take positions until none are left.
+ * ordering and stats are the calling thread's killer/history tables and
+ * statistics, or NULL.
+ */
+static void batchWork(BatchSearch *batch, MoveOrdering *ordering, SearchStats *stats)
+{
+    SearchContext ctx = {batch->engine, &batch->engine->stop, 0, NULL, NULL, 0, NULL, ordering, stats};
+    for (;;)
+    {
+        int next = atomic_fetch_add_int(&batch->next, 1);
+        if (next >= batch->count)
+            break;
+
+        int index = (batch->order != NULL) ? batch->order[next] : next;
+        searchPosition(&ctx, batch->boards[index], batch->players[index], &batch->results[index]);
+    }
+}
+
+/* Pieces on the board, as the hand-out key of a batch position (at most MAX_MOVES). */
+static int batchPieces(Bitboard board)
+{
+    int pieces = POPCOUNT64(board.x_pieces | board.o_pieces);
+    return (pieces < MAX_MOVES) ? pieces : MAX_MOVES;
+}
+
+THREAD_FUNC(batchWorkerMain, arg)
+{
+    BatchWorker *worker = (BatchWorker *)arg;
+    batchWork(worker->batch, NULL, worker->stats);
+    THREAD_RETURN;
+}
+
+void engineGetAiMoveBatch(HyperPruneEngine *engine, const Bitboard *boards, const char *players, int count,
+                          SearchResult *out_results)
+{
+    if (count <= 0)
+        return;
+
+    /* Counting sort by pieces on the board, stable within a count */
+    int *order = (int *)malloc((size_t)count * sizeof(int));
+    if (order != NULL)
+    {
+        int starts[MAX_MOVES + 2] = {0};
+        for (int i = 0; i < count; i++)
+            starts[batchPieces(boards[i]) + 1]++;
+        for (int p = 1; p <= MAX_MOVES + 1; p++)
+            starts[p] += starts[p - 1];
+        for (int i = 0; i < count; i++)
+            order[starts[batchPieces(boards[i])]++] = i;
+    }
+
+    BatchSearch batch = {engine, boards, players, out_results, order, count, 0};
+    int threadCount = engine->thread_count;
+    if (threadCount > count)
+        threadCount = count;
+
+    BatchWorker workers[MAX_SEARCH_THREADS];
+    ThreadHandle handles[MAX_SEARCH_THREADS];
+    SearchStats *stats = searchStatsAcquire(threadCount - 1);
+    int started = 0;
+    for (int t = 1; t < threadCount; t++)
+    {
+        workers[started] = (BatchWorker){&batch, searchStatsSlot(stats, started)};
+        /* Thread creation failure only costs parallelism, never correctness */
+        if (thread_create(&handles[started], batchWorkerMain, &workers[started]) != 0)
+            break;
+        started++;
+    }
+
+    batchWork(&batch, &engine->ordering, searchStatsOf(engine));
+    for (int t = 0; t < started; t++)
+        thread_join(handles[t]);
+    searchStatsRelease(engine, stats, threadCount - 1);
+    atomic_store_int(&engine->stop, 0);
+
+    free(order);
+}
+
+void getAiMoveBatch(const Bitboard *boards, const char *players, int count, SearchResult *out_results)
+{
+    engineGetAiMoveBatch(engineDefault(), boards, players, count, out_results);
+}
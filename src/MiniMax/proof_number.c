@@ -0,0 +1,493 @@
+/*
+ * Depth-first proof-number search
+ * -------------------------------
+ * See proof_number.h for the API.
+ *
+ * Every question is asked for one attacker (the side to move at the root)
+ * and one goal: win, or at least draw. Inside the search, proof numbers are
+ * kept from the side to move's point of view (phi/delta form of df-pn):
+ *  - phi:   leaves to decide before the side to move reaches its goal
+ *           (the attacker's goal, or the defender's refutation of it)
+ *  - delta: leaves to decide before the opponent reaches its goal
+ * so a node's phi is the smallest delta of its children and its delta is the
+ * sum of their phis. A node is searched until one of its numbers reaches the
+ * threshold its parent passed down; only then is it stored and the parent
+ * picks its next most-proving child.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "proof_number.h"
+#include "search.h"
+#include "transposition.h"
+#include "bitops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Proof number of a decided node: the other side can never reach its goal */
+#define PROOF_NUMBER_INF UINT32_MAX
+
+/* Cells of the board (1ULL << 64 is undefined, hence the 8x8 case) */
+#if MAX_MOVES == 64
+#define PROOF_BOARD_CELLS (~0ULL)
+#else
+#define PROOF_BOARD_CELLS ((1ULL << MAX_MOVES) - 1)
+#endif
+
+/*
+ * Table entry: the proof numbers of one (position, question) pair. The key
+ * is the position's Zobrist hash XOR a constant per question, so the answers
+ * to different questions never mix.
+ */
+struct ProofNumberEntry
+{
+    uint64_t key;
+    uint32_t phi;
+    uint32_t delta;
+    uint32_t work; /* Nodes searched to compute the entry, 0 = empty slot */
+    uint32_t padding;
+};
+
+_Static_assert(sizeof(ProofNumberEntry) == 24, "ProofNumberEntry must stay 24 bytes");
+
+/* The question a search answers for its attacker. */
+typedef enum
+{
+    PROOF_GOAL_WIN = 0,     /* Attacker wins */
+    PROOF_GOAL_NOT_LOSE = 1 /* Attacker wins or draws */
+} ProofGoal;
+
+/* Key salts per [attacker: 0 = 'x', 1 = 'o'][goal] */
+static const uint64_t proof_number_salts[2][2] = {
+    {0x8a5cd789635d2dffULL, 0x121fd2155c472f96ULL},
+    {0x2545f4914f6cdd1dULL, 0xd6e8feb86659fd93ULL}};
+
+/* State of one question being searched. */
+typedef struct
+{
+    const ZobristKeys *keys;
+    ProofNumberTable *table;
+    char attacker;
+    ProofGoal goal;
+    uint64_t salt;
+    uint64_t nodes;
+    uint64_t max_nodes; /* 0 = unlimited */
+    const int *stop;    /* Atomic stop request, or NULL */
+    int aborted;        /* Set once max_nodes is reached or stop is raised */
+} ProofSearch;
+
+/* A child of the node being expanded and its current proof numbers. */
+typedef struct
+{
+    Move move;
+    uint64_t hash; /* Zobrist hash of the child position */
+    uint32_t phi;
+    uint32_t delta;
+} ProofChild;
+
+void proof_number_table_init_r(ProofNumberTable *table, size_t max_bytes)
+{
+    proof_number_table_free_r(table);
+
+    size_t buckets = 1;
+    while (buckets * 2 * 2 * sizeof(ProofNumberEntry) <= max_bytes)
+        buckets *= 2;
+
+    table->entries = (ProofNumberEntry *)calloc(buckets * 2, sizeof(ProofNumberEntry));
+    if (table->entries == NULL)
+    {
+        fprintf(stderr, "Warning: Failed to allocate proof-number table (%zu bytes)\n",
+                buckets * 2 * sizeof(ProofNumberEntry));
+        return;
+    }
+    table->bucket_mask = buckets - 1;
+}
+
+void proof_number_table_free_r(ProofNumberTable *table)
+{
+    free(table->entries);
+    table->entries = NULL;
+    table->bucket_mask = 0;
+}
+
+void proof_number_table_clear_r(ProofNumberTable *table)
+{
+    if (table->entries != NULL)
+        memset(table->entries, 0, (table->bucket_mask + 1) * 2 * sizeof(ProofNumberEntry));
+}
+
+void proof_number_table_free(void)
+{
+    proof_number_table_free_r(&engineDefault()->proof_table);
+}
+
+void proof_number_table_clear(void)
+{
+    proof_number_table_clear_r(&engineDefault()->proof_table);
+}
+
+/* Allocate engine's table within its memory cap on first use. Returns 0 if there is none. */
+static int proofTableReady(HyperPruneEngine *engine)
+{
+    ProofNumberTable *table = &engine->proof_table;
+    if (table->entries == NULL)
+        proof_number_table_init_r(table, engine->proof_memory);
+    return table->entries != NULL;
+}
+
+/* Stored proof numbers of key, or 1/1 (one unexpanded leaf) if absent. */
+static void proofTableLookup(const ProofNumberTable *table, uint64_t key, uint32_t *out_phi, uint32_t *out_delta)
+{
+    const ProofNumberEntry *bucket = &table->entries[(key & table->bucket_mask) * 2];
+    for (int i = 0; i < 2; i++)
+    {
+        if (bucket[i].work != 0 && bucket[i].key == key)
+        {
+            *out_phi = bucket[i].phi;
+            *out_delta = bucket[i].delta;
+            return;
+        }
+    }
+    *out_phi = 1;
+    *out_delta = 1;
+}
+
+static void proofTableStore(ProofNumberTable *table, uint64_t key, uint32_t phi, uint32_t delta, uint64_t work)
+{
+    ProofNumberEntry *bucket = &table->entries[(key & table->bucket_mask) * 2];
+    ProofNumberEntry *slot = &bucket[0];
+    if (bucket[1].work != 0 && bucket[1].key == key)
+        slot = &bucket[1];
+    else if (!(bucket[0].work != 0 && bucket[0].key == key) && bucket[1].work < bucket[0].work)
+        slot = &bucket[1];
+
+    slot->key = key;
+    slot->phi = phi;
+    slot->delta = delta;
+    slot->work = (work >= UINT32_MAX) ? UINT32_MAX : (uint32_t)(work + 1);
+}
+
+static inline uint32_t proofAdd(uint32_t a, uint32_t b)
+{
+    /* A decided term keeps the sum infinite; large finite sums stay finite */
+    if (a == PROOF_NUMBER_INF || b == PROOF_NUMBER_INF)
+        return PROOF_NUMBER_INF;
+    uint64_t sum = (uint64_t)a + b;
+    return (sum >= PROOF_NUMBER_INF) ? PROOF_NUMBER_INF - 1 : (uint32_t)sum;
+}
+
+static inline uint32_t proofClamp(uint64_t value)
+{
+    return (value >= PROOF_NUMBER_INF) ? PROOF_NUMBER_INF : (uint32_t)value;
+}
+
+/*
+ * Result of a node that is decided without expanding it, from the view of
+ * player (the side to move): AI_WIN_SCORE, TIE_SCORE or PLAYER_WIN_SCORE, or
+ * CONTINUE_SCORE if it must be searched. The opponent's threat cells go to
+ * out_blocks.
+ */
+static int proofNodeOutcome(Bitboard board, const LineCounts *lines, char player, uint64_t *out_blocks)
+{
+    int p = (player == 'x') ? 0 : 1;
+    char opponent = (player == 'x') ? 'o' : 'x';
+    uint64_t occupied = board.x_pieces | board.o_pieces;
+
+    *out_blocks = 0;
+    if (lines->completed[1 - p] > 0)
+        return PLAYER_WIN_SCORE; /* The last move completed a line */
+    if (lines->completed[p] > 0)
+        return AI_WIN_SCORE; /* Only in a position handed in already won */
+    if (POPCOUNT64(occupied) == MAX_MOVES || lines->live == 0)
+        return TIE_SCORE;
+    if (lines->threats[p])
+        return AI_WIN_SCORE; /* Completes a line now */
+
+    uint64_t blocks = line_counts_threat_cells(lines, opponent, p ? board.x_pieces : board.o_pieces);
+    if (blocks & (blocks - 1))
+        return PLAYER_WIN_SCORE; /* Two completions cannot both be blocked */
+    *out_blocks = blocks;
+    return CONTINUE_SCORE;
+}
+
+/* Proof numbers of a decided node for its side to move (outcome as above). */
+static void proofDecided(const ProofSearch *s, char player, int outcome, uint32_t *out_phi, uint32_t *out_delta)
+{
+    int attacker_outcome = (player == s->attacker) ? outcome : -outcome;
+    int reached = (s->goal == PROOF_GOAL_WIN) ? (attacker_outcome > TIE_SCORE) : (attacker_outcome >= TIE_SCORE);
+    if (reached == (player == s->attacker))
+    {
+        *out_phi = 0;
+        *out_delta = PROOF_NUMBER_INF;
+    }
+    else
+    {
+        *out_phi = PROOF_NUMBER_INF;
+        *out_delta = 0;
+    }
+}
+
+static void proofSearchNode(ProofSearch *s, Bitboard board, LineCounts *lines, uint64_t hash, char player,
+                            uint32_t th_phi, uint32_t th_delta, uint32_t *io_phi, uint32_t *io_delta);
+
+/* Fill children for moves with their stored (or initial) proof numbers. */
+static int proofChildren(const ProofSearch *s, uint64_t hash, char player, const MoveList *moves,
+                         ProofChild *out_children)
+{
+    for (int i = 0; i < moves->count; i++)
+    {
+        Move move = moves->moves[i];
+        ProofChild *child = &out_children[i];
+        child->move = move;
+        child->hash = zobrist_toggle_turn_r(s->keys, zobrist_toggle_r(s->keys, hash, move.row, move.col, player));
+        proofTableLookup(s->table, child->hash ^ s->salt, &child->phi, &child->delta);
+    }
+    return moves->count;
+}
+
+/*
+ * Search the children of a node until its phi reaches th_phi or its delta
+ * reaches th_delta (or the budget runs out), always descending into the
+ * child with the smallest delta. The node's proof numbers go to out_phi and
+ * out_delta; children keeps every child's latest numbers.
+ */
+static void proofExpand(ProofSearch *s, Bitboard board, LineCounts *lines, char player,
+                        ProofChild *children, int count, uint32_t th_phi, uint32_t th_delta,
+                        uint32_t *out_phi, uint32_t *out_delta)
+{
+    char opponent = (player == 'x') ? 'o' : 'x';
+    for (;;)
+    {
+        uint32_t phi = PROOF_NUMBER_INF;
+        uint32_t delta = 0;
+        uint32_t second = PROOF_NUMBER_INF;
+        int best = 0;
+        for (int i = 0; i < count; i++)
+        {
+            delta = proofAdd(delta, children[i].phi);
+            if (children[i].delta < phi)
+            {
+                second = phi;
+                phi = children[i].delta;
+                best = i;
+            }
+            else if (children[i].delta < second)
+            {
+                second = children[i].delta;
+            }
+        }
+
+        *out_phi = phi;
+        *out_delta = delta;
+        if (phi >= th_phi || delta >= th_delta || s->aborted)
+            return;
+
+        /*
+         * The child may use the node's delta slack as its phi budget, and may
+         * not let its delta grow past the runner-up's (plus one) or the node's
+         * phi threshold.
+         */
+        ProofChild *child = &children[best];
+        uint32_t child_th_phi = proofClamp((uint64_t)th_delta - delta + child->phi);
+        uint32_t child_th_delta = proofClamp((uint64_t)second + 1);
+        if (child_th_delta > th_phi)
+            child_th_delta = th_phi;
+
+        Move move = child->move;
+        bitboard_make_move(&board, move.row, move.col, player);
+        line_counts_make(lines, move.row, move.col, player);
+        proofSearchNode(s, board, lines, child->hash, opponent, child_th_phi, child_th_delta,
+                        &child->phi, &child->delta);
+        line_counts_unmake(lines, move.row, move.col, player);
+        bitboard_unmake_move(&board, move.row, move.col, player);
+    }
+}
+
+/*
+ * Search one node (player to move, hash its Zobrist hash) within the
+ * thresholds. io_phi/io_delta hold the node's numbers as known by the parent
+ * on entry and its updated numbers on return.
+ */
+static void proofSearchNode(ProofSearch *s, Bitboard board, LineCounts *lines, uint64_t hash, char player,
+                            uint32_t th_phi, uint32_t th_delta, uint32_t *io_phi, uint32_t *io_delta)
+{
+    if ((s->max_nodes != 0 && s->nodes >= s->max_nodes) || (s->stop != NULL && atomic_load_int(s->stop)))
+    {
+        s->aborted = 1;
+        return;
+    }
+    uint64_t start = s->nodes++;
+
+    /* Decided nodes cost nothing to recognize again: never stored */
+    uint64_t blocks;
+    int outcome = proofNodeOutcome(board, lines, player, &blocks);
+    if (outcome != CONTINUE_SCORE)
+    {
+        proofDecided(s, player, outcome, io_phi, io_delta);
+        return;
+    }
+
+    /* Same move generation as the minimax kernel: forced block, else live cells */
+    uint64_t empty = ~(board.x_pieces | board.o_pieces) & PROOF_BOARD_CELLS;
+    uint64_t cells = blocks;
+    if (cells == 0)
+    {
+        cells = empty & line_counts_live_cells(lines);
+        if (MAX_MOVES - POPCOUNT64(empty) < BOARD_SIZE)
+            cells = bitboard_unique_cells(cells, bitboard_symmetries(board));
+    }
+
+    MoveList moves;
+    moves.count = 0;
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+    {
+        if (cells & (1ULL << cell))
+            moves.moves[moves.count++] = (Move){BIT_TO_ROW(cell), BIT_TO_COL(cell)};
+    }
+
+    ProofChild children[MAX_MOVES];
+    int count = proofChildren(s, hash, player, &moves, children);
+    proofExpand(s, board, lines, player, children, count, th_phi, th_delta, io_phi, io_delta);
+    proofTableStore(s->table, hash ^ s->salt, *io_phi, *io_delta, s->nodes - start);
+}
+
+static void proofSearchInit(ProofSearch *s, HyperPruneEngine *engine, char attacker, ProofGoal goal,
+                            uint64_t max_nodes, const int *stop)
+{
+    s->keys = engine->keys;
+    s->table = &engine->proof_table;
+    s->attacker = attacker;
+    s->goal = goal;
+    s->salt = proof_number_salts[attacker == 'x' ? 0 : 1][goal];
+    s->nodes = 0;
+    s->max_nodes = max_nodes;
+    s->stop = stop;
+    s->aborted = 0;
+}
+
+int proof_number_solve(Bitboard board, char player, uint64_t max_nodes, int *out_score)
+{
+    HyperPruneEngine *engine = engineDefault();
+    if ((board.x_pieces & board.o_pieces) || !proofTableReady(engine))
+        return 0;
+
+    LineCounts lines;
+    line_counts_init(&lines, board);
+    uint64_t hash = zobrist_hash_r(engine->keys, board, player);
+    uint64_t nodes = 0;
+
+    /* Win? If not, at least a draw? */
+    static const ProofGoal goals[2] = {PROOF_GOAL_WIN, PROOF_GOAL_NOT_LOSE};
+    static const int reached_score[2] = {AI_WIN_SCORE, TIE_SCORE};
+    for (int q = 0; q < 2; q++)
+    {
+        ProofSearch s;
+        proofSearchInit(&s, engine, player, goals[q], (max_nodes != 0) ? max_nodes - nodes : 0, NULL);
+        uint32_t phi = 1;
+        uint32_t delta = 1;
+        proofSearchNode(&s, board, &lines, hash, player, PROOF_NUMBER_INF, PROOF_NUMBER_INF, &phi, &delta);
+        nodes += s.nodes;
+        if (s.aborted || (phi != 0 && delta != 0))
+            return 0;
+        if (phi == 0)
+        {
+            *out_score = reached_score[q];
+            return 1;
+        }
+        if (max_nodes != 0 && nodes >= max_nodes)
+            return 0;
+    }
+
+    *out_score = PLAYER_WIN_SCORE;
+    return 1;
+}
+
+/*
+ * Ask one question about the root moves. Returns 1 if the attacker reaches
+ * the goal, 0 if not, -1 if stop was raised; children then holds each move's
+ * numbers from the opponent's view (delta 0: the move reaches the goal,
+ * phi 0: it does not).
+ */
+static int proofRootQuestion(HyperPruneEngine *engine, Bitboard board, char aiPlayer, ProofGoal goal,
+                             const MoveList *moves, ProofChild *children)
+{
+    ProofSearch s;
+    proofSearchInit(&s, engine, aiPlayer, goal, 0, &engine->stop);
+
+    LineCounts lines;
+    line_counts_init(&lines, board);
+    uint64_t hash = zobrist_hash_r(s.keys, board, aiPlayer);
+    int count = proofChildren(&s, hash, aiPlayer, moves, children);
+
+    uint32_t phi;
+    uint32_t delta;
+    proofExpand(&s, board, &lines, aiPlayer, children, count, PROOF_NUMBER_INF, PROOF_NUMBER_INF,
+                &phi, &delta);
+    if (s.aborted)
+        return -1;
+    return phi == 0;
+}
+
+/* Index of the first move whose child delta is 0 (reaches the goal). */
+static int proofFirstReached(const ProofChild *children, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (children[i].delta == 0)
+            return i;
+    }
+    return 0;
+}
+
+int proofNumberSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                          Move *out_best, RootScoreList *out_scores)
+{
+    rootScoresReset(out_scores, moves);
+    *out_best = moves->moves[0];
+    if (!proofTableReady(engine))
+        return TIE_SCORE;
+
+    ProofChild children[MAX_MOVES];
+    int win = proofRootQuestion(engine, board, aiPlayer, PROOF_GOAL_WIN, moves, children);
+    if (win < 0)
+        return TIE_SCORE; /* Stopped: nothing is proven */
+    if (win)
+    {
+        /* Moves that were never proven either way are left as not searched */
+        for (int i = 0; i < moves->count; i++)
+        {
+            if (children[i].delta == 0)
+            {
+                out_scores->moves[i].score = AI_WIN_SCORE;
+                out_scores->moves[i].bound = ROOT_SCORE_EXACT;
+            }
+        }
+        *out_best = moves->moves[proofFirstReached(children, moves->count)];
+        return AI_WIN_SCORE;
+    }
+
+    /* No move wins: every move is a draw at best */
+    int draw = proofRootQuestion(engine, board, aiPlayer, PROOF_GOAL_NOT_LOSE, moves, children);
+    if (draw < 0)
+        return TIE_SCORE;
+    int score = draw ? TIE_SCORE : PLAYER_WIN_SCORE;
+    for (int i = 0; i < moves->count; i++)
+    {
+        if (children[i].delta == 0 || children[i].phi == 0)
+        {
+            out_scores->moves[i].score = (children[i].delta == 0) ? TIE_SCORE : PLAYER_WIN_SCORE;
+            out_scores->moves[i].bound = ROOT_SCORE_EXACT;
+        }
+        else
+        {
+            out_scores->moves[i].score = TIE_SCORE;
+            out_scores->moves[i].bound = ROOT_SCORE_UPPER_BOUND;
+        }
+    }
+    if (score == TIE_SCORE)
+        *out_best = moves->moves[proofFirstReached(children, moves->count)];
+    return score;
+}
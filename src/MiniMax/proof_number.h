@@ -0,0 +1,96 @@
+/*
+ * Depth-first proof-number search (df-pn)
+ * ---------------------------------------
+ * An outcome-only engine for boards too large for alpha-beta enumeration.
+ * Instead of scoring every move, df-pn answers one yes/no question at a time
+ * ("can the side to move win?", then "can it avoid losing?") and always
+ * expands the part of the tree that is cheapest to decide, measured by
+ * proof and disproof numbers: the number of leaves that still have to be
+ * decided to prove or to disprove a node.
+ *
+ * Key components:
+ *  - Shares the Bitboard, win masks, per-line counts and Zobrist keys with
+ *    the minimax engine
+ *  - Its own table of proof/disproof numbers, limited to a memory cap;
+ *    when full, entries that took the least work to compute are replaced
+ *  - Selected for getAiMove with setSearchEngine(ENGINE_PROOF_NUMBER)
+ *
+ * Usage:
+ *  1. Call zobrist_init() and init_win_masks() once at program startup
+ *  2. Optionally call setProofNumberMemory(bytes) to set the memory cap
+ *     (otherwise PROOF_NUMBER_DEFAULT_MEMORY is allocated on first use)
+ *  3. Call proof_number_solve(...) or getAiMove(...) with the engine selected
+ *  4. Call proof_number_table_free() at program exit
+ *
+ * Every HyperPruneEngine owns its table (engineSetProofNumberMemory), so
+ * engines may run proof-number searches concurrently. proof_number_solve and
+ * the functions without _r use the default engine's table and keys.
+ */
+
+#ifndef PROOF_NUMBER_H
+#define PROOF_NUMBER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../TicTacToe/tic_tac_toe.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Table memory used when none was configured: 64 MiB */
+#define PROOF_NUMBER_DEFAULT_MEMORY ((size_t)64 << 20)
+
+    typedef struct ProofNumberEntry ProofNumberEntry;
+
+    /** Two-entry buckets: a new entry replaces the one that took less work. */
+    typedef struct ProofNumberTable
+    {
+        ProofNumberEntry *entries; /* NULL until allocated */
+        size_t bucket_mask;        /* Bucket count - 1 */
+    } ProofNumberTable;
+
+    /**
+     * Allocate table within max_bytes (rounded down to a power-of-two entry
+     * count; at least one bucket). Replaces and clears any existing table.
+     */
+    void proof_number_table_init_r(ProofNumberTable *table, size_t max_bytes);
+
+    /**
+     * Free table. Safe to call even if it was never allocated.
+     */
+    void proof_number_table_free_r(ProofNumberTable *table);
+
+    /** Clear every entry of table, keeping the allocation. */
+    void proof_number_table_clear_r(ProofNumberTable *table);
+
+    /**
+     * Free the default engine's table.
+     * Safe to call even if it was never allocated.
+     */
+    void proof_number_table_free(void);
+
+    /** Clear every entry of the default engine's table, keeping the allocation. */
+    void proof_number_table_clear(void);
+
+    /**
+     * Prove the game value of a position with player to move.
+     *
+     * Parameters:
+     *  - board:     Position to solve
+     *  - player:    Side to move ('x' or 'o')
+     *  - max_nodes: Node budget over both questions (0 = unlimited)
+     *  - out_score: Game value from player's view: +100 win, 0 draw,
+     *               -100 loss (set only when proven)
+     *
+     * Returns: 1 if the value was proven, 0 if the budget ran out or the
+     *          board is invalid (overlapping pieces)
+     */
+    int proof_number_solve(Bitboard board, char player, uint64_t max_nodes, int *out_score);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
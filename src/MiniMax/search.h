@@ -0,0 +1,449 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+/*
+ * Internal search interface
+ * -------------------------
+ * Shared between the sequential driver (mini_max.c) and the parallel
+ * drivers (parallel_search.c). Not part of the public API.
+ */
+
+#include "../TicTacToe/tic_tac_toe.h"
+#include "bitops.h"
+#include "mcts.h"
+#include "mini_max.h"
+#include "proof_number.h"
+#include "threading.h"
+#include "timer.h"
+#include "transposition.h"
+#include <stdint.h>
+
+/* Build-time search statistics (make STATS=1 / -DENABLE_STATS=ON). */
+#ifndef HP_STATS
+#define HP_STATS 0
+#endif
+
+/* A single board coordinate (row, col). */
+typedef struct
+{
+    int row;
+    int col;
+} Move;
+
+/* A trivial fixed-size container for generated legal moves. */
+typedef struct
+{
+    int count;
+    Move moves[MAX_MOVES];
+} MoveList;
+
+/* Helper constants used by the evaluation and search. */
+typedef enum
+{
+    AI_WIN_SCORE = 100,
+    PLAYER_WIN_SCORE = -100,
+    TIE_SCORE = 0,
+    CONTINUE_SCORE = 1,
+    INF = 101
+} HelperScores;
+
+/* Static evaluations stay strictly inside the proven win/loss scores. */
+#define HEURISTIC_LIMIT (AI_WIN_SCORE - 1)
+
+/*
+ * Remaining-ply limit of a search that runs to the end of the game. It is
+ * never decremented, so full searches skip all draft bookkeeping.
+ */
+#define SEARCH_DEPTH_FULL (MAX_MOVES + 1)
+
+/* Remaining-ply limit passed to the children of a node searched at depth. */
+static inline int searchChildDepth(int depth)
+{
+    return (depth >= SEARCH_DEPTH_FULL) ? depth : depth - 1;
+}
+
+/*
+ * Move ordering state of one search thread: the last two moves that caused a
+ * cutoff at each ply (killers) and, per player, a score for every cell that
+ * grows each time a move there causes a cutoff (history). Below the root,
+ * moves are searched killers first, then by history score.
+ */
+typedef struct
+{
+    uint8_t killers[MAX_MOVES][2];  /* Cell index + 1 per ply (plies = pieces on the board), 0 = none */
+    uint32_t history[2][MAX_MOVES]; /* [player: 0 = 'x', 1 = 'o'][cell index] */
+} MoveOrdering;
+
+/* Per-move results of one root search, in move list order. */
+typedef struct
+{
+    int count;
+    RootMoveScore moves[MAX_MOVES];
+} RootScoreList;
+
+/*
+ * State of one engine (see HyperPruneEngine in mini_max.h).
+ *  - keys, table: own_keys/own_table for engines from engineCreate, the
+ *                 default ones of transposition.h for engineDefault
+ *  - ordering:    killer/history tables of the thread that calls the engine.
+ *                 They persist across searches and games until
+ *                 engineResetMoveOrdering(); other search threads keep plain
+ *                 move order so the tables are never shared between threads.
+ *  - stop:        raised by engineRequestStop or an exhausted budget; every
+ *                 thread of a search polls it, and the search call that
+ *                 returns next clears it
+ */
+struct HyperPruneEngine
+{
+    ZobristKeys *keys;
+    TranspositionTable *table;
+    int thread_count;                 /* 1 = sequential search */
+    ParallelMode parallel_mode;       /* Used when thread_count > 1 */
+    SearchAlgorithm search_algorithm; /* Window strategy of the minimax core */
+    SearchEngine search_engine;       /* Root driver of getAiMove */
+    int symmetric_hashing;            /* Symmetry-canonical transposition table keys */
+    int solution_table;               /* getAiMove reads the built-in 3x3 solution table */
+    size_t proof_memory;              /* Cap of proof_table, allocated on first use if not yet */
+    size_t mcts_memory;               /* Cap of mcts_tree, allocated on first use */
+    MoveOrdering ordering;
+    int stop;                       /* Atomic */
+    RootScoreList last_root_scores; /* Root move scores of the most recent search */
+    Bitboard solution_root;         /* Position of a move read from the solution table */
+    char solution_player;           /* Its mover; 0 if last_root_scores holds real scores */
+    EngineStats stats;
+#if HP_STATS
+    SearchStats search_stats; /* Counters of the calling thread, and of helpers once joined */
+#endif
+    ZobristKeys own_keys;
+    TranspositionTable own_table;
+    ProofNumberTable proof_table; /* ENGINE_PROOF_NUMBER's table */
+    MctsTree mcts_tree;           /* engineGetAiMoveMcts's node pool */
+};
+
+/* Prepare out_scores for moves: every move starts as not searched. */
+void rootScoresReset(RootScoreList *out_scores, const MoveList *moves);
+
+/* Nodes between two clock reads of a time-limited search (power of two). */
+#define SEARCH_BUDGET_CHECK_INTERVAL 1024
+
+/*
+ * Node and wall-clock limits of a budgeted search. expired is the engine's
+ * stop flag, which the search context's stop pointer refers to as well, so
+ * a stop request ends the budget and an exhausted budget stops the search:
+ * either way every node unwinds through the usual abort path.
+ */
+typedef struct
+{
+    int *expired;       /* Atomic: set once a limit is reached */
+    uint64_t nodes;     /* Nodes visited so far */
+    uint64_t max_nodes; /* 0 = unlimited */
+    double max_seconds; /* <= 0 = unlimited */
+    HiResTimer start;
+} SearchBudget;
+
+/*
+ * Charge one node to the budget. Returns non-zero (without counting the node)
+ * once a limit is reached; the node must then return without searching.
+ */
+static inline int searchBudgetExhausted(SearchBudget *budget)
+{
+    if (atomic_load_int(budget->expired))
+        return 1;
+
+    if (budget->max_nodes != 0 && budget->nodes >= budget->max_nodes)
+    {
+        atomic_store_int(budget->expired, 1);
+        return 1;
+    }
+
+    if (budget->max_seconds > 0 && (budget->nodes & (SEARCH_BUDGET_CHECK_INTERVAL - 1)) == 0)
+    {
+        HiResTimer now;
+        if (timer_get(&now) == 0 && timer_diff_seconds(&budget->start, &now) >= budget->max_seconds)
+        {
+            atomic_store_int(budget->expired, 1);
+            return 1;
+        }
+    }
+
+    budget->nodes++;
+    return 0;
+}
+
+typedef struct SplitPoint SplitPoint;
+typedef struct YbwcPool YbwcPool;
+
+/*
+ * One sibling task of a YBWC split point being searched by a thread.
+ * Frames form a chain from the innermost split point to the root; the task
+ * is cancelled once its split point's cutoff_index drops below its index
+ * (a sibling produced a cutoff), or when any enclosing frame is cancelled.
+ */
+typedef struct TaskFrame
+{
+    SplitPoint *sp;
+    const int *cutoff_index;
+    int index;
+    const struct TaskFrame *parent;
+} TaskFrame;
+
+/*
+ * Per-thread search state threaded through the recursion.
+ *  - engine:       keys, table and settings of the search
+ *  - stop:         shared abort flag, NULL if the search cannot be interrupted.
+ *                  Once set, every node returns without touching the TT.
+ *  - order_offset: rotation applied to every generated move list. The main
+ *                  thread uses 0 (plain bit order); Lazy SMP helpers use
+ *                  distinct offsets so they explore different subtrees first.
+ *  - pool:         YBWC scheduler, NULL unless tree splitting is enabled
+ *  - frame:        innermost YBWC task this thread is executing (or NULL)
+ *  - thread_id:    index of this thread's work-stealing deque in pool
+ *  - budget:       node/time limits to charge every node to, or NULL
+ *  - ordering:     killer/history tables to order and record moves with, or
+ *                  NULL for plain move order (owned by this thread only)
+ *  - stats:        counters to charge every node to (HP_STATS builds), or
+ *                  NULL (owned by this thread only)
+ */
+typedef struct
+{
+    HyperPruneEngine *engine;
+    const int *stop;
+    int order_offset;
+    YbwcPool *pool;
+    const TaskFrame *frame;
+    int thread_id;
+    SearchBudget *budget;
+    MoveOrdering *ordering;
+    SearchStats *stats;
+} SearchContext;
+
+/*
+ * Statistics hooks of the search. Without HP_STATS they expand to nothing,
+ * arguments included, so the counters cost nothing unless built in.
+ *  - SEARCH_STATS_NODE(name, ctx, board): declare name as the counters of
+ *    board's ply in ctx (NULL if ctx collects none)
+ *  - SEARCH_STATS_ADD(name, field, n):    add n to that ply's field
+ */
+#if HP_STATS
+#define SEARCH_STATS_NODE(name, ctx, board) SearchPlyStats *name = searchStatsPly((ctx)->stats, (board))
+#define SEARCH_STATS_ADD(name, field, n)    \
+    do                                      \
+    {                                       \
+        if ((name) != NULL)                 \
+            (name)->field += (uint64_t)(n); \
+    } while (0)
+
+static inline SearchPlyStats *searchStatsPly(SearchStats *stats, Bitboard board)
+{
+    return (stats != NULL) ? &stats->ply[POPCOUNT64(board.x_pieces | board.o_pieces)] : NULL;
+}
+
+/* Slot of SearchPlyStats.cutoff_index counting a cutoff by the move at index. */
+static inline int searchStatsCutoffSlot(int index)
+{
+    return (index < SEARCH_STATS_CUTOFF_SLOTS) ? index : SEARCH_STATS_CUTOFF_SLOTS - 1;
+}
+
+/* Counters for the calling thread of engine's searches. */
+static inline SearchStats *searchStatsOf(HyperPruneEngine *engine)
+{
+    return &engine->search_stats;
+}
+
+/*
+ * Zeroed counters for count helper threads, or NULL if the allocation fails
+ * (the helpers then count nothing). searchStatsRelease adds them to engine's
+ * once the helpers are joined, and frees them.
+ */
+SearchStats *searchStatsAcquire(int count);
+void searchStatsRelease(HyperPruneEngine *engine, SearchStats *block, int count);
+#else
+#define SEARCH_STATS_NODE(name, ctx, board) ((void)0)
+#define SEARCH_STATS_ADD(name, field, n) ((void)0)
+
+static inline SearchStats *searchStatsOf(HyperPruneEngine *engine)
+{
+    (void)engine;
+    return NULL;
+}
+
+static inline SearchStats *searchStatsAcquire(int count)
+{
+    (void)count;
+    return NULL;
+}
+
+static inline void searchStatsRelease(HyperPruneEngine *engine, SearchStats *block, int count)
+{
+    (void)engine;
+    (void)block;
+    (void)count;
+}
+#endif
+
+/* Counters of helper thread index in a searchStatsAcquire block (NULL-safe). */
+static inline SearchStats *searchStatsSlot(SearchStats *block, int index)
+{
+    return (block != NULL) ? &block[index] : NULL;
+}
+
+/* Non-zero once the search running in ctx must unwind without storing. */
+static inline int searchAborted(const SearchContext *ctx)
+{
+    if (ctx->stop != NULL && atomic_load_int(ctx->stop))
+        return 1;
+
+    for (const TaskFrame *frame = ctx->frame; frame != NULL; frame = frame->parent)
+    {
+        if (frame->index > atomic_load_int(frame->cutoff_index))
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * Search one node below the root with player to move (negamax): the score,
+ * the window and the node's transposition table entry are all from player's
+ * point of view, so a parent negates the result and swaps -beta/-alpha. Nodes
+ * at depth 0 that are not terminal return a static evaluation within
+ * +-HEURISTIC_LIMIT.
+ */
+int searchNode(SearchContext *ctx, Bitboard board, char player, int alpha, int beta, int depth);
+
+/*
+ * Run the root loop of getAiMove over a prepared move list, depth plies deep
+ * (SEARCH_DEPTH_FULL to the end of the game).
+ * Returns the best score found and stores the corresponding move in out_best.
+ * Per-move scores go to out_scores when it is not NULL (offset 0 only).
+ * If ctx->stop was raised the return value is meaningless; out_best is the
+ * best of the moves that finished (the first move of the search order if
+ * none did) and out_scores lists only those.
+ */
+int searchRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves,
+               int depth, Move *out_best, RootScoreList *out_scores);
+
+/*
+ * Parallel root drivers. Each returns the same score and move as searchRoot
+ * with a zero order offset, independent of threadCount, and fills out_scores.
+ *  - Lazy SMP: helpers search the whole root with perturbed orders; the main
+ *    thread's result is returned
+ *  - Young Brothers Wait: the first root move is searched serially, the rest
+ *    become stealable tasks
+ *  - Root split: workers take root moves one at a time and share alpha
+ * Every thread polls engine->stop. Once it is raised they return the best
+ * move among the root moves that finished (out_scores lists them), or a
+ * move not yet searched if none did.
+ */
+int lazySmpSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                      int threadCount, Move *out_best, RootScoreList *out_scores);
+int ybwcSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                   int threadCount, Move *out_best, RootScoreList *out_scores);
+int rootSplitSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                        int threadCount, Move *out_best, RootScoreList *out_scores);
+
+/*
+ * Null-window probe of the root moves in the given search order: returns the
+ * index of the earliest listed move whose score exceeds alpha, or -1 if every
+ * move fails low (or the search was aborted). out_passed[i] is 1 if move i
+ * exceeded alpha, 0 if it failed low and -1 if it was not searched.
+ */
+typedef int (*RootProbe)(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves,
+                         const int *order, int alpha, int *out_passed);
+
+/* Sequential probe: the root moves one after another on the calling thread. */
+int probeRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves,
+              const int *order, int alpha, int *out_passed);
+
+/*
+ * Outcome-only root of ENGINE_SOLVER: a "win?" and a "tie?" probe decide the
+ * game value; returns it with the same move as searchRoot and fills
+ * out_scores. Moves are rotated by ctx->order_offset first. If ctx->stop was
+ * raised no move is scored and out_best is the first move of the search order.
+ */
+int solveRoot(SearchContext *ctx, Bitboard board, char aiPlayer, const MoveList *moves, RootProbe probe,
+              Move *out_best, RootScoreList *out_scores);
+
+/*
+ * Parallel solver roots: solveRoot with both probes run by one of the
+ * parallel modes. Each returns the same value and move as solveRoot with a
+ * zero order offset and stops like the root drivers above.
+ *  - Lazy SMP: helpers solve the whole root with perturbed orders
+ *  - Young Brothers Wait: the probes walk the root moves serially and split
+ *    the nodes below them
+ *  - Root split: workers probe root moves one at a time; a move that passes
+ *    cancels only the moves after it
+ */
+int lazySmpSolveRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                     int threadCount, Move *out_best, RootScoreList *out_scores);
+int ybwcSolveRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                  int threadCount, Move *out_best, RootScoreList *out_scores);
+int rootSplitSolveRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                       int threadCount, Move *out_best, RootScoreList *out_scores);
+
+/*
+ * Depth-first proof-number root (proof_number.c): proves whether aiPlayer
+ * wins, and if not whether it draws, and returns that value with a move
+ * that reaches it. Fills out_scores like the outcome-only solver. Uses the
+ * engine's keys and proof-number table. Once engine->stop is raised it
+ * returns the first move with every move not searched.
+ */
+int proofNumberSearchRoot(HyperPruneEngine *engine, Bitboard board, char aiPlayer, const MoveList *moves,
+                          Move *out_best, RootScoreList *out_scores);
+
+/*
+ * Tablebase root (tablebase.c): if a table is open and aiPlayer is the side
+ * to move by the piece counts, scores every move exactly from the table and
+ * returns non-zero with the first best move. Returns 0 otherwise.
+ */
+int tablebaseSearchRoot(Bitboard board, char aiPlayer, const MoveList *moves,
+                        Move *out_best, RootScoreList *out_scores);
+
+/*
+ * Solution table root (tablebase.c, 3x3 only): if aiPlayer is the side to
+ * move by the piece counts of a board prepareRoot accepted, returns
+ * non-zero with the first best move from the built-in table, building it
+ * on first use. Returns 0 otherwise, also while another thread builds it.
+ */
+int solutionTableSearchRoot(Bitboard board, char aiPlayer, Move *out_best);
+
+/*
+ * Exact score of move for aiPlayer from the solution table, which a
+ * successful solutionTableSearchRoot on board has built.
+ */
+int solutionTableMoveScore(Bitboard board, char aiPlayer, Move move);
+
+/*
+ * Opening book root (opening_book.c): if a book is open and holds the
+ * position with aiPlayer to move (proven, if requireProven is set), returns
+ * non-zero with the book move in out_best and the entry
+ * in out_result (when not NULL). Returns 0 otherwise.
+ */
+int openingBookSearchRoot(Bitboard board, char aiPlayer, int requireProven, Move *out_best,
+                          SearchResult *out_result);
+
+/*
+ * Search one position to the end of the game on ctx, for getAiMoveBatch:
+ * the same move and score as getAiMove with one thread, without touching
+ * getRootMoveScores or the opening book. The solver serves every engine
+ * other than ENGINE_MINIMAX. Terminal, invalid and empty boards get the
+ * results getAiMoveBudgeted gives them. If ctx->stop is raised the result
+ * is marked aborted, with the best move found so far and score 0.
+ */
+void searchPosition(SearchContext *ctx, Bitboard board, char aiPlayer, SearchResult *out_result);
+
+/* Non-zero if a node with this many empty cells should offer its siblings. */
+int ybwcShouldSplit(const SearchContext *ctx, int emptyCount);
+
+/*
+ * Search moves[first..count) of a node searched depth plies deep in parallel
+ * (the eldest brother has already been searched). player is the side to move;
+ * bestScore/alpha/beta are the node's state after the serial part, from
+ * player's point of view, and *inout_bestIndex is the index of bestScore's
+ * move. Returns the node's best score and updates *inout_bestIndex; the
+ * caller must check searchAborted() before using either.
+ */
+int ybwcSearchSiblings(SearchContext *ctx, Bitboard board, char player,
+                       const MoveList *moves, int first, int depth,
+                       int alpha, int beta, int bestScore, int *inout_bestIndex);
+
+#endif
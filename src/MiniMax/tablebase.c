@@ -0,0 +1,556 @@
+/*
+ * Retrograde tablebase
+ * --------------------
+ * See tablebase.h for the API and file layout.
+ *
+ * Generation keeps one byte per index and fills the layers from the full
+ * board down: a position with k pieces is lost if the last mover completed a
+ * line, drawn if the board is full, and otherwise takes the best of its
+ * children, which all have k + 1 pieces and are already solved. A child's
+ * index is the parent's plus the mover's digit times 3^cell, so no child is
+ * ever re-encoded. Within a layer, threads take the sets of x cells one at a
+ * time from a shared counter and solve every placement of o pieces around
+ * them; no two threads write the same index.
+ *
+ * The finished values are packed 4 per byte behind the header and written
+ * out. Lookups read the packed values straight from the mapped file.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "tablebase.h"
+#include "search.h"
+#include "bitops.h"
+#include "mapped_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Values per index, for the side to move */
+enum
+{
+    TABLEBASE_UNKNOWN = 0, /* Not a position of the game */
+    TABLEBASE_LOSS = 1,
+    TABLEBASE_DRAW = 2,
+    TABLEBASE_WIN = 3
+};
+
+#define TABLEBASE_MAGIC "HPTBASE"
+#define TABLEBASE_VERSION 1
+
+/* File header; the packed values follow at data_offset. */
+typedef struct
+{
+    char magic[8];       /* TABLEBASE_MAGIC */
+    uint32_t version;    /* TABLEBASE_VERSION */
+    uint32_t board_size; /* BOARD_SIZE of the generator */
+    uint64_t positions;  /* 3^MAX_MOVES */
+    uint64_t data_offset;
+} TablebaseHeader;
+
+_Static_assert(sizeof(TablebaseHeader) == 32, "TablebaseHeader must stay 32 bytes");
+
+#if TABLEBASE_SUPPORTED
+
+/* Cells of the board */
+#define TABLEBASE_BOARD_CELLS ((1ULL << MAX_MOVES) - 1)
+
+/* Base-3 weight 3^cell, and the weights of the cells in each byte of a cell mask */
+static uint32_t tablebase_pow3[MAX_MOVES];
+static uint32_t tablebase_low_weights[256];
+static uint32_t tablebase_high_weights[256];
+static uint32_t tablebase_positions = 0; /* 3^MAX_MOVES, 0 until initialized */
+
+/* Open table: the mapping and the packed values inside it */
+static const uint8_t *tablebase_values = NULL;
+static MappedFile tablebase_map;
+
+/* Shared state of one layer being generated. */
+typedef struct
+{
+    uint8_t *values;        /* One value per index */
+    const uint64_t *x_sets; /* Every set of x cells of the layer */
+    int x_count;
+    int o_pieces;           /* o pieces of every position in the layer */
+    int x_to_move;
+    int next;               /* Atomic: next x set to solve */
+} TablebaseLayer;
+
+/* Fill the index tables (once; before any thread uses them). */
+static void tablebaseInitIndex(void)
+{
+    if (tablebase_positions != 0)
+        return;
+
+    uint32_t weight = 1;
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+    {
+        tablebase_pow3[cell] = weight;
+        weight *= 3;
+    }
+    tablebase_positions = weight;
+
+    for (int byte = 0; byte < 256; byte++)
+    {
+        uint32_t low = 0;
+        uint32_t high = 0;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            if (!(byte & (1 << bit)))
+                continue;
+            if (bit < MAX_MOVES)
+                low += tablebase_pow3[bit];
+            if (bit + 8 < MAX_MOVES)
+                high += tablebase_pow3[bit + 8];
+        }
+        tablebase_low_weights[byte] = low;
+        tablebase_high_weights[byte] = high;
+    }
+}
+
+/* Base-3 index of a position: x cells count 1, o cells 2. */
+static inline uint32_t tablebaseIndex(uint64_t x_pieces, uint64_t o_pieces)
+{
+    uint32_t x = tablebase_low_weights[x_pieces & 0xff] + tablebase_high_weights[(x_pieces >> 8) & 0xff];
+    uint32_t o = tablebase_low_weights[o_pieces & 0xff] + tablebase_high_weights[(o_pieces >> 8) & 0xff];
+    return x + 2 * o;
+}
+
+/* Next larger mask with the same number of bits (Gosper's hack; set must be non-zero). */
+static inline uint64_t tablebaseNextSet(uint64_t set)
+{
+    uint64_t lowest = set & (~set + 1);
+    uint64_t ripple = set + lowest;
+    return (((ripple ^ set) >> 2) / lowest) | ripple;
+}
+
+/* Value of one position whose children are solved. */
+static uint8_t tablebaseSolve(const uint8_t *values, uint64_t x_pieces, uint64_t o_pieces, int x_to_move)
+{
+    uint64_t mover = x_to_move ? x_pieces : o_pieces;
+    uint64_t last = x_to_move ? o_pieces : x_pieces;
+    if (bitboard_has_won(mover))
+        return TABLEBASE_UNKNOWN; /* The game went on after the mover won */
+    if (bitboard_has_won(last))
+        return TABLEBASE_LOSS;
+
+    uint64_t empty = ~(x_pieces | o_pieces) & TABLEBASE_BOARD_CELLS;
+    if (empty == 0)
+        return TABLEBASE_DRAW;
+
+    uint32_t index = tablebaseIndex(x_pieces, o_pieces);
+    uint32_t digit = x_to_move ? 1 : 2;
+    uint8_t best = TABLEBASE_LOSS;
+    for (; empty; empty &= empty - 1)
+    {
+        uint8_t child = values[index + digit * tablebase_pow3[lowestCell(empty)]];
+        uint8_t value = (uint8_t)(TABLEBASE_WIN + TABLEBASE_LOSS - child);
+        if (value > best)
+        {
+            best = value;
+            if (best == TABLEBASE_WIN)
+                break;
+        }
+    }
+    return best;
+}
+
+/* Solve the layer's positions for the x sets taken from the shared counter. */
+static void tablebaseSolveLayer(TablebaseLayer *layer)
+{
+    for (;;)
+    {
+        int i = atomic_fetch_add_int(&layer->next, 1);
+        if (i >= layer->x_count)
+            break;
+
+        uint64_t x_pieces = layer->x_sets[i];
+        int free_cells[MAX_MOVES];
+        int free_count = 0;
+        for (uint64_t empty = ~x_pieces & TABLEBASE_BOARD_CELLS; empty; empty &= empty - 1)
+            free_cells[free_count++] = lowestCell(empty);
+
+        /* Every o_pieces-subset of the free cells, as a mask over free_cells */
+        uint64_t limit = 1ULL << free_count;
+        uint64_t set = (1ULL << layer->o_pieces) - 1;
+        while (set < limit)
+        {
+            uint64_t o_pieces = 0;
+            for (uint64_t bits = set; bits; bits &= bits - 1)
+                o_pieces |= 1ULL << free_cells[lowestCell(bits)];
+
+            layer->values[tablebaseIndex(x_pieces, o_pieces)] =
+                tablebaseSolve(layer->values, x_pieces, o_pieces, layer->x_to_move);
+
+            if (set == 0)
+                break;
+            set = tablebaseNextSet(set);
+        }
+    }
+}
+
+THREAD_FUNC(tablebaseWorkerMain, arg)
+{
+    tablebaseSolveLayer((TablebaseLayer *)arg);
+    THREAD_RETURN;
+}
+
+/* Every mask of count cells, in increasing order. Returns the number written. */
+static int tablebaseCellSets(int count, uint64_t *out_sets)
+{
+    int written = 0;
+    uint64_t set = (1ULL << count) - 1;
+    while (set <= TABLEBASE_BOARD_CELLS)
+    {
+        out_sets[written++] = set;
+        if (set == 0)
+            break;
+        set = tablebaseNextSet(set);
+    }
+    return written;
+}
+
+/* Pack values 4 per byte and write the file. Returns 0 on success. */
+static int tablebaseWrite(const char *path, const uint8_t *values)
+{
+    size_t bytes = ((size_t)tablebase_positions + 3) / 4;
+    uint8_t *packed = (uint8_t *)calloc(bytes, 1);
+    if (packed == NULL)
+    {
+        fprintf(stderr, "Error: Failed to allocate tablebase output (%zu bytes)\n", bytes);
+        return -1;
+    }
+    for (uint32_t i = 0; i < tablebase_positions; i++)
+        packed[i / 4] |= (uint8_t)(values[i] << ((i % 4) * 2));
+
+    TablebaseHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+    header.version = TABLEBASE_VERSION;
+    header.board_size = BOARD_SIZE;
+    header.positions = tablebase_positions;
+    header.data_offset = sizeof(header);
+
+    FILE *file = fopen(path, "wb");
+    int ok = file != NULL && fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(packed, 1, bytes, file) == bytes;
+    if (file != NULL && fclose(file) != 0)
+        ok = 0;
+    free(packed);
+    if (!ok)
+    {
+        fprintf(stderr, "Error: Failed to write tablebase '%s'\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Solve every position into values (zeroed, one byte per index), layer by
+ * layer; x_sets holds one layer, at most 2^MAX_MOVES sets of cells.
+ */
+static void tablebaseSolveAll(uint8_t *values, uint64_t *x_sets, int threads)
+{
+    for (int pieces = MAX_MOVES; pieces >= 0; pieces--)
+    {
+        TablebaseLayer layer;
+        layer.values = values;
+        layer.x_sets = x_sets;
+        layer.x_count = tablebaseCellSets((pieces + 1) / 2, x_sets);
+        layer.o_pieces = pieces / 2;
+        layer.x_to_move = (pieces % 2 == 0);
+        layer.next = 0;
+
+        ThreadHandle handles[MAX_SEARCH_THREADS];
+        int started = 0;
+        for (int t = 1; t < threads; t++)
+        {
+            /* Thread creation failure only costs parallelism, never correctness */
+            if (thread_create(&handles[started], tablebaseWorkerMain, &layer) != 0)
+                break;
+            started++;
+        }
+        tablebaseSolveLayer(&layer);
+        for (int t = 0; t < started; t++)
+            thread_join(handles[t]);
+    }
+}
+
+int tablebase_generate(const char *path, int threads)
+{
+    tablebaseInitIndex();
+    if (threads < 1)
+        threads = 1;
+    if (threads > MAX_SEARCH_THREADS)
+        threads = MAX_SEARCH_THREADS;
+
+    uint8_t *values = (uint8_t *)calloc(tablebase_positions, 1);
+    uint64_t *x_sets = (uint64_t *)malloc(sizeof(uint64_t) << MAX_MOVES);
+    if (values == NULL || x_sets == NULL)
+    {
+        fprintf(stderr, "Error: Failed to allocate tablebase generator (%u bytes)\n", tablebase_positions);
+        free(values);
+        free(x_sets);
+        return -1;
+    }
+
+    tablebaseSolveAll(values, x_sets, threads);
+    int result = tablebaseWrite(path, values);
+    free(values);
+    free(x_sets);
+    return result;
+}
+
+void tablebase_close(void)
+{
+    mapped_file_close(&tablebase_map);
+    tablebase_values = NULL;
+}
+
+int tablebase_open(const char *path)
+{
+    tablebase_close();
+    tablebaseInitIndex();
+
+    if (mapped_file_open(&tablebase_map, path, sizeof(TablebaseHeader)) != 0)
+    {
+        fprintf(stderr, "Error: Cannot open tablebase '%s'\n", path);
+        return -1;
+    }
+
+    TablebaseHeader header;
+    memcpy(&header, tablebase_map.data, sizeof(header));
+    size_t bytes = ((size_t)tablebase_positions + 3) / 4;
+    if (memcmp(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) != 0 ||
+        header.version != TABLEBASE_VERSION || header.board_size != BOARD_SIZE ||
+        header.positions != tablebase_positions || header.data_offset < sizeof(header) ||
+        header.data_offset > tablebase_map.size || tablebase_map.size - header.data_offset < bytes)
+    {
+        tablebase_close();
+        fprintf(stderr, "Error: '%s' is not a %dx%d tablebase\n", path, BOARD_SIZE, BOARD_SIZE);
+        return -1;
+    }
+    tablebase_values = (const uint8_t *)tablebase_map.data + header.data_offset;
+    return 0;
+}
+
+int tablebase_is_open(void)
+{
+    return tablebase_values != NULL;
+}
+
+/* Packed value of a position, TABLEBASE_UNKNOWN if it is not in the table. */
+static int tablebaseValue(Bitboard board)
+{
+    if (tablebase_values == NULL || (board.x_pieces & board.o_pieces) ||
+        ((board.x_pieces | board.o_pieces) & ~TABLEBASE_BOARD_CELLS))
+        return TABLEBASE_UNKNOWN;
+
+    int x_count = POPCOUNT64(board.x_pieces);
+    int o_count = POPCOUNT64(board.o_pieces);
+    if (x_count != o_count && x_count != o_count + 1)
+        return TABLEBASE_UNKNOWN;
+
+    uint32_t index = tablebaseIndex(board.x_pieces, board.o_pieces);
+    return (tablebase_values[index / 4] >> ((index % 4) * 2)) & 3;
+}
+
+#else
+
+int tablebase_generate(const char *path, int threads)
+{
+    (void)path;
+    (void)threads;
+    fprintf(stderr, "Error: Tablebases support boards up to 4x4 (this build: %dx%d)\n", BOARD_SIZE,
+            BOARD_SIZE);
+    return -1;
+}
+
+int tablebase_open(const char *path)
+{
+    return tablebase_generate(path, 1);
+}
+
+void tablebase_close(void)
+{
+}
+
+int tablebase_is_open(void)
+{
+    return 0;
+}
+
+static int tablebaseValue(Bitboard board)
+{
+    (void)board;
+    return TABLEBASE_UNKNOWN;
+}
+
+#endif
+
+/* Score of a packed value for the side to move. */
+static int tablebaseScore(int value)
+{
+    if (value == TABLEBASE_WIN)
+        return AI_WIN_SCORE;
+    return (value == TABLEBASE_DRAW) ? TIE_SCORE : PLAYER_WIN_SCORE;
+}
+
+int tablebase_probe(Bitboard board, int *out_score)
+{
+    int value = tablebaseValue(board);
+    if (value == TABLEBASE_UNKNOWN)
+        return 0;
+    *out_score = tablebaseScore(value);
+    return 1;
+}
+
+int tablebaseSearchRoot(Bitboard board, char aiPlayer, const MoveList *moves,
+                        Move *out_best, RootScoreList *out_scores)
+{
+    if (!tablebase_is_open())
+        return 0;
+
+    int scores[MAX_MOVES];
+    int best = 0;
+    for (int i = 0; i < moves->count; i++)
+    {
+        Bitboard child = board;
+        bitboard_make_move(&child, moves->moves[i].row, moves->moves[i].col, aiPlayer);
+        int value = tablebaseValue(child);
+        if (value == TABLEBASE_UNKNOWN)
+            return 0; /* aiPlayer is not the side to move by the piece counts */
+
+        scores[i] = -tablebaseScore(value);
+        if (scores[i] > scores[best])
+            best = i;
+    }
+
+    rootScoresReset(out_scores, moves);
+    for (int i = 0; i < moves->count; i++)
+    {
+        out_scores->moves[i].score = scores[i];
+        out_scores->moves[i].bound = ROOT_SCORE_EXACT;
+    }
+    *out_best = moves->moves[best];
+    return 1;
+}
+
+#if SOLUTION_TABLE_SUPPORTED
+
+/* 3^9 positions of the 3x3 board */
+#define SOLUTION_TABLE_POSITIONS 19683
+
+/* Bits of a solution table entry above the value: best move's cell plus one */
+#define SOLUTION_TABLE_MOVE_SHIFT 2
+
+/*
+ * Built-in solution table: the tablebase values solved in memory on first
+ * use, with the first best move of every position that is not over.
+ */
+static uint8_t solution_table[SOLUTION_TABLE_POSITIONS];
+static int solution_table_state = 0; /* Atomic: 0 not built, 1 building, 2 ready */
+
+/* Solve every position into solution_table, then add the best moves. */
+static void solutionTableBuild(void)
+{
+    uint64_t x_sets[1 << MAX_MOVES];
+    tablebaseInitIndex();
+    tablebaseSolveAll(solution_table, x_sets, 1);
+
+    for (uint32_t index = 0; index < SOLUTION_TABLE_POSITIONS; index++)
+    {
+        int value = solution_table[index];
+        if (value == TABLEBASE_UNKNOWN)
+            continue;
+
+        uint64_t x_pieces = 0;
+        uint64_t o_pieces = 0;
+        uint32_t digits = index;
+        for (int cell = 0; cell < MAX_MOVES; cell++, digits /= 3)
+        {
+            if (digits % 3 == 1)
+                x_pieces |= 1ULL << cell;
+            else if (digits % 3 == 2)
+                o_pieces |= 1ULL << cell;
+        }
+        if (bitboard_has_won(x_pieces) || bitboard_has_won(o_pieces))
+            continue;
+
+        /*
+         * The move the search selects: an immediate win, else the first
+         * cell in board order whose child has the position's value
+         */
+        int x_to_move = POPCOUNT64(x_pieces) == POPCOUNT64(o_pieces);
+        uint64_t empty = ~(x_pieces | o_pieces) & TABLEBASE_BOARD_CELLS;
+        uint64_t wins = bitboard_threat_cells(x_to_move ? x_pieces : o_pieces, empty);
+        if (wins)
+        {
+            solution_table[index] |= (uint8_t)((lowestCell(wins) + 1) << SOLUTION_TABLE_MOVE_SHIFT);
+            continue;
+        }
+        uint32_t digit = x_to_move ? 1 : 2;
+        for (; empty; empty &= empty - 1)
+        {
+            int cell = lowestCell(empty);
+            int child = solution_table[index + digit * tablebase_pow3[cell]] & 3;
+            if (TABLEBASE_WIN + TABLEBASE_LOSS - child == value)
+            {
+                solution_table[index] |= (uint8_t)((cell + 1) << SOLUTION_TABLE_MOVE_SHIFT);
+                break;
+            }
+        }
+    }
+}
+
+int solutionTableSearchRoot(Bitboard board, char aiPlayer, Move *out_best)
+{
+    if (atomic_load_acquire_int(&solution_table_state) != 2)
+    {
+        /* First use: one thread builds the table, the others search meanwhile */
+        if (!atomic_compare_exchange_int(&solution_table_state, 0, 1))
+            return 0;
+        solutionTableBuild();
+        atomic_compare_exchange_int(&solution_table_state, 1, 2);
+    }
+
+    int x_count = POPCOUNT64(board.x_pieces);
+    int o_count = POPCOUNT64(board.o_pieces);
+    if (aiPlayer != ((x_count == o_count) ? 'x' : 'o') || (x_count != o_count && x_count != o_count + 1))
+        return 0;
+
+    int cell = (solution_table[tablebaseIndex(board.x_pieces, board.o_pieces)] >> SOLUTION_TABLE_MOVE_SHIFT) - 1;
+    if (cell < 0)
+        return 0;
+    out_best->row = BIT_TO_ROW(cell);
+    out_best->col = BIT_TO_COL(cell);
+    return 1;
+}
+
+int solutionTableMoveScore(Bitboard board, char aiPlayer, Move move)
+{
+    bitboard_make_move(&board, move.row, move.col, aiPlayer);
+    return -tablebaseScore(solution_table[tablebaseIndex(board.x_pieces, board.o_pieces)] & 3);
+}
+
+#else
+
+int solutionTableSearchRoot(Bitboard board, char aiPlayer, Move *out_best)
+{
+    (void)board;
+    (void)aiPlayer;
+    (void)out_best;
+    return 0;
+}
+
+int solutionTableMoveScore(Bitboard board, char aiPlayer, Move move)
+{
+    (void)board;
+    (void)aiPlayer;
+    (void)move;
+    return TIE_SCORE;
+}
+
+#endif
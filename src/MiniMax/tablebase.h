@@ -0,0 +1,96 @@
+/*
+ * Retrograde tablebase (3x3 and 4x4)
+ * ----------------------------------
+ * The game value of every position, computed once and stored in a file that
+ * getAiMove answers from without searching.
+ *
+ * Key components:
+ *  - Generator: retrograde analysis by number of pieces, from full boards
+ *    down to the empty one; each layer only depends on the layer with one
+ *    piece more, so its positions are solved in parallel
+ *  - Index: base-3 number of the board (cell value 0 empty, 1 x, 2 o),
+ *    computed from the two bitboards with byte lookup tables; the side to
+ *    move follows from the piece counts (x moves first)
+ *  - File: a small header and 2 bits per index (unknown, loss, draw, win
+ *    for the side to move): 5 KB for 3x3, 11 MB for 4x4, native byte order
+ *  - Lookup: the file is memory-mapped read-only and probed in place, so
+ *    processes that open the same file share one copy in the page cache
+ *
+ * Usage:
+ *  1. Call init_win_masks() once at program startup
+ *  2. Once per board size: tablebase_generate(path, threads)
+ *  3. Call tablebase_open(path); getAiMove then uses the table
+ *  4. Call tablebase_close() at program exit
+ *
+ * Boards larger than 4x4 (3^25 positions for 5x5) are not supported: the
+ * functions report an error and getAiMove keeps searching.
+ *
+ * On 3x3 the same generator also builds a solution table in memory on the
+ * first getAiMove, without a file: one byte per index with the value and
+ * the best move, so a move is one index computation and one load.
+ */
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include "../TicTacToe/tic_tac_toe.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Non-zero if this board size has a tablebase */
+#define TABLEBASE_SUPPORTED (BOARD_SIZE <= 4)
+
+/* Non-zero if this board size has the built-in solution table (see setSolutionTable) */
+#define SOLUTION_TABLE_SUPPORTED (BOARD_SIZE == 3)
+
+    /**
+     * Solve every position and write the table to path.
+     *
+     * Parameters:
+     *  - path:    Output file (replaced if it exists)
+     *  - threads: Worker threads per layer, clamped to 1..MAX_SEARCH_THREADS
+     *
+     * Returns: 0 on success, -1 on error (message on stderr)
+     */
+    int tablebase_generate(const char *path, int threads);
+
+    /**
+     * Map a table written by tablebase_generate for this board size.
+     * Replaces any table already open.
+     *
+     * Returns: 0 on success, -1 if the file is missing or does not match
+     *          (message on stderr)
+     */
+    int tablebase_open(const char *path);
+
+    /**
+     * Unmap the open table.
+     * Safe to call even if none is open.
+     */
+    void tablebase_close(void);
+
+    /** Return non-zero if a table is open. */
+    int tablebase_is_open(void);
+
+    /**
+     * Look up a position's game value.
+     *
+     * Parameters:
+     *  - board:     Position with the side to move implied by the piece
+     *               counts ('x' if equal, 'o' if x has one more)
+     *  - out_score: Value for the side to move: +100 win, 0 draw, -100 loss
+     *
+     * Returns: 1 if the value was found, 0 if no table is open or the
+     *          position is not in it (invalid piece counts, overlapping
+     *          pieces, or a game that continued after a win)
+     */
+    int tablebase_probe(Bitboard board, int *out_score);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
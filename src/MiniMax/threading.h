@@ -0,0 +1,197 @@
+#ifndef THREADING_H
+#define THREADING_H
+
+/*
+ * Portable threads and atomics
+ * ----------------------------
+ * Minimal wrappers used by the parallel search drivers:
+ *  - POSIX threads and GCC/Clang __atomic builtins on Unix-like systems
+ *  - Win32 threads and Interlocked intrinsics on Windows (MSVC)
+ *
+ * All atomics are relaxed unless stated otherwise. The shared transposition
+ * table verifies entries itself (XOR check) and only needs tear-free 64-bit
+ * loads and stores; stop flags only need eventual visibility.
+ *
+ * Thread entry points are declared with THREAD_FUNC and must end with
+ * THREAD_RETURN so the same body compiles for both back ends.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+typedef HANDLE ThreadHandle;
+typedef CRITICAL_SECTION ThreadMutex;
+typedef LPTHREAD_START_ROUTINE ThreadEntry;
+#define THREAD_FUNC(name, arg) static DWORD WINAPI name(LPVOID arg)
+#define THREAD_RETURN return 0
+
+/* Returns 0 on success, -1 on failure. */
+static inline int thread_create(ThreadHandle *thread, ThreadEntry entry, void *arg)
+{
+    *thread = CreateThread(NULL, 0, entry, arg, 0, NULL);
+    return (*thread != NULL) ? 0 : -1;
+}
+
+static inline void thread_join(ThreadHandle thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static inline void thread_yield(void)
+{
+    SwitchToThread();
+}
+
+static inline void mutex_init(ThreadMutex *mutex)
+{
+    InitializeCriticalSection(mutex);
+}
+
+static inline void mutex_destroy(ThreadMutex *mutex)
+{
+    DeleteCriticalSection(mutex);
+}
+
+static inline void mutex_lock(ThreadMutex *mutex)
+{
+    EnterCriticalSection(mutex);
+}
+
+static inline void mutex_unlock(ThreadMutex *mutex)
+{
+    LeaveCriticalSection(mutex);
+}
+#else
+#include <pthread.h>
+#include <sched.h>
+
+typedef pthread_t ThreadHandle;
+typedef pthread_mutex_t ThreadMutex;
+typedef void *(*ThreadEntry)(void *);
+#define THREAD_FUNC(name, arg) static void *name(void *arg)
+#define THREAD_RETURN return NULL
+
+/* Returns 0 on success, -1 on failure. */
+static inline int thread_create(ThreadHandle *thread, ThreadEntry entry, void *arg)
+{
+    return (pthread_create(thread, NULL, entry, arg) == 0) ? 0 : -1;
+}
+
+static inline void thread_join(ThreadHandle thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static inline void thread_yield(void)
+{
+    sched_yield();
+}
+
+static inline void mutex_init(ThreadMutex *mutex)
+{
+    pthread_mutex_init(mutex, NULL);
+}
+
+static inline void mutex_destroy(ThreadMutex *mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+static inline void mutex_lock(ThreadMutex *mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+static inline void mutex_unlock(ThreadMutex *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+static inline int atomic_load_int(const int *ptr)
+{
+    return *(const volatile int *)ptr;
+}
+
+static inline void atomic_store_int(int *ptr, int value)
+{
+    *(volatile int *)ptr = value;
+}
+
+/* Acquire: sees every write made before a release of the same value. */
+static inline int atomic_load_acquire_int(const int *ptr)
+{
+    return *(const volatile int *)ptr;
+}
+
+/* Sequentially consistent; returns the previous value. */
+static inline int atomic_fetch_add_int(int *ptr, int delta)
+{
+    return (int)_InterlockedExchangeAdd((volatile long *)ptr, (long)delta);
+}
+
+/* Sequentially consistent; returns non-zero if *ptr was expected and is now desired. */
+static inline int atomic_compare_exchange_int(int *ptr, int expected, int desired)
+{
+    return _InterlockedCompareExchange((volatile long *)ptr, (long)desired, (long)expected) == (long)expected;
+}
+
+static inline uint64_t atomic_load_u64(const uint64_t *ptr)
+{
+    return *(const volatile uint64_t *)ptr;
+}
+
+static inline void atomic_store_u64(uint64_t *ptr, uint64_t value)
+{
+    *(volatile uint64_t *)ptr = value;
+}
+#else
+static inline int atomic_load_int(const int *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_store_int(int *ptr, int value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+
+/* Acquire: sees every write made before a release of the same value. */
+static inline int atomic_load_acquire_int(const int *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+/* Sequentially consistent; returns the previous value. */
+static inline int atomic_fetch_add_int(int *ptr, int delta)
+{
+    return __atomic_fetch_add(ptr, delta, __ATOMIC_SEQ_CST);
+}
+
+/* Sequentially consistent; returns non-zero if *ptr was expected and is now desired. */
+static inline int atomic_compare_exchange_int(int *ptr, int expected, int desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline uint64_t atomic_load_u64(const uint64_t *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+static inline void atomic_store_u64(uint64_t *ptr, uint64_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+#endif
+
+#endif
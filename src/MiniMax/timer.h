@@ -0,0 +1,53 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+/*
+ * Portable high-resolution timer
+ * ------------------------------
+ * Monotonic wall-clock timer used for self-play statistics and for the time
+ * budget of getAiMoveBudgeted:
+ *  - QueryPerformanceCounter on Windows (MSVC)
+ *  - clock_gettime(CLOCK_MONOTONIC) elsewhere; translation units including
+ *    this header must define _POSIX_C_SOURCE (199309L or later) before any
+ *    system header
+ */
+
+#ifdef _MSC_VER
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+typedef LARGE_INTEGER HiResTimer;
+
+static inline int timer_get(HiResTimer *t)
+{
+    return QueryPerformanceCounter(t) ? 0 : -1;
+}
+
+static inline double timer_diff_seconds(const HiResTimer *start, const HiResTimer *end)
+{
+    LARGE_INTEGER freq;
+    if (!QueryPerformanceFrequency(&freq))
+        return -1.0;
+    return (double)(end->QuadPart - start->QuadPart) / (double)freq.QuadPart;
+}
+#else
+#include <time.h>
+
+typedef struct timespec HiResTimer;
+
+static inline int timer_get(HiResTimer *t)
+{
+    return clock_gettime(CLOCK_MONOTONIC, t);
+}
+
+static inline double timer_diff_seconds(const HiResTimer *start, const HiResTimer *end)
+{
+    double sec = (double)(end->tv_sec - start->tv_sec);
+    double nsec = (double)(end->tv_nsec - start->tv_nsec);
+    return sec + (nsec / 1e9);
+}
+#endif
+
+#endif
@@ -6,41 +6,23 @@
 
 #include "transposition.h"
 #include "bitops.h"
+#include "threading.h"
 #include <stdlib.h>
 #include <stdio.h>
 
-/*
- * Zobrist keys: [row][col][player_index]
- * player_index: 0='x', 1='o'
- */
-static uint64_t zobrist_keys[BOARD_SIZE][BOARD_SIZE][2];
-
-/*
- * Zobrist keys for aiPlayer perspective.
- * XORed into hash to distinguish positions with different maximizing players.
- */
-static uint64_t zobrist_player_keys[2];
+_Static_assert(sizeof(TranspositionTableEntry) == 16,
+               "TranspositionTableEntry must stay 16 bytes");
 
-/*
- * Zobrist key for side-to-move.
- * XORed into hash when it's the opponent's turn (miniMaxLow).
- */
-static uint64_t zobrist_turn_key;
-
-/* Transposition table */
-static TranspositionTableEntry *transposition_table = NULL;
-static size_t transposition_table_size = 0;
-static size_t transposition_table_mask = 0; /* Bitmask for fast modulo (size - 1) */
-
-/* SplitMix64 PRNG state for Zobrist key generation */
-static uint64_t splitmix64_state = 0x9e3779b97f4a7c15ULL; /* Default seed (golden ratio) */
+/* Keys and table used by the functions without a context argument */
+static ZobristKeys default_keys = {.rng_state = ZOBRIST_DEFAULT_SEED};
+static TranspositionTable default_table = {NULL, 0, 0};
 
 /*
  * SplitMix64: High-quality 64-bit PRNG
  */
-static uint64_t splitmix64_next(void)
+static uint64_t splitmix64_next(uint64_t *state)
 {
-    uint64_t z = (splitmix64_state += 0x9e3779b97f4a7c15ULL);
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
     z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
     z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
     return z ^ (z >> 31);
@@ -76,18 +58,57 @@ static size_t round_up_power_of_2(size_t n)
     return n + 1;
 }
 
+/*
+ * Image of (row, col) under symmetry s: identity, the three rotations
+ * (90, 180, 270 degrees clockwise), then the mirror, flip, transpose and
+ * anti-transpose.
+ */
+static int symmetry_cell(int s, int row, int col)
+{
+    const int n = BOARD_SIZE - 1;
+    switch (s)
+    {
+    case 1:
+        return POS_TO_BIT(col, n - row);
+    case 2:
+        return POS_TO_BIT(n - row, n - col);
+    case 3:
+        return POS_TO_BIT(n - col, row);
+    case 4:
+        return POS_TO_BIT(row, n - col);
+    case 5:
+        return POS_TO_BIT(n - row, col);
+    case 6:
+        return POS_TO_BIT(col, row);
+    case 7:
+        return POS_TO_BIT(n - col, n - row);
+    default:
+        return POS_TO_BIT(row, col);
+    }
+}
+
 /* Map player symbol to index for Zobrist key lookup */
 static inline int player_to_index(char player)
 {
     return (player == 'x') ? 0 : 1;
 }
 
-void zobrist_set_seed(uint64_t seed)
+ZobristKeys *zobrist_default_keys(void)
 {
-    splitmix64_state = seed;
+    return &default_keys;
 }
 
-void zobrist_init(void)
+TranspositionTable *transposition_table_default(void)
+{
+    return &default_table;
+}
+
+void zobrist_set_seed_r(ZobristKeys *keys, uint64_t seed)
+{
+    keys->rng_state = seed;
+}
+
+void zobrist_init_r(ZobristKeys *keys)
 {
     /* Initialize piece keys using SplitMix64 */
     for (int r = 0; r < BOARD_SIZE; r++)
@@ -96,28 +117,39 @@ void zobrist_init(void)
         {
             for (int p = 0; p < 2; p++)
             {
-                zobrist_keys[r][c][p] = splitmix64_next();
+                keys->pieces[r][c][p] = splitmix64_next(&keys->rng_state);
             }
         }
     }
 
-    /* Initialize player perspective keys */
-    zobrist_player_keys[0] = splitmix64_next();
-    zobrist_player_keys[1] = splitmix64_next();
+    /* Initialize side-to-move keys */
+    keys->player[0] = splitmix64_next(&keys->rng_state);
+    keys->player[1] = splitmix64_next(&keys->rng_state);
+    keys->turn = keys->player[0] ^ keys->player[1];
 
-    /* Initialize side-to-move key */
-    zobrist_turn_key = splitmix64_next();
+    /* Symmetry tables (derived, no extra random keys) */
+    for (int s = 0; s < ZOBRIST_SYMMETRY_COUNT; s++)
+    {
+        for (int cell = 0; cell < MAX_MOVES; cell++)
+        {
+            int image = symmetry_cell(s, BIT_TO_ROW(cell), BIT_TO_COL(cell));
+            keys->symmetry_cells[s][cell] = (uint8_t)image;
+            keys->symmetry_inverse_cells[s][image] = (uint8_t)cell;
+            for (int p = 0; p < 2; p++)
+                keys->symmetric[cell][p][s] = keys->pieces[BIT_TO_ROW(image)][BIT_TO_COL(image)][p];
+        }
+    }
 }
 
-uint64_t zobrist_hash(Bitboard board, char aiPlayer)
+uint64_t zobrist_hash_r(const ZobristKeys *keys, Bitboard board, char player)
 {
     /*
-     * Hash encodes both position AND perspective (aiPlayer).
-     * This is critical because the minimax score for a position depends on
-     * who is maximizing. Without the aiPlayer key, we would return stale
-     * scores from the wrong perspective when games alternate starting player.
+     * Hash encodes both position AND side to move (player).
+     * This is critical because a stored score is relative to the side to
+     * move. Without the player key, the same pieces with the other side to
+     * move would return a score from the wrong perspective.
      */
-    uint64_t hash = zobrist_player_keys[player_to_index(aiPlayer)];
+    uint64_t hash = keys->player[player_to_index(player)];
 
 #ifdef HAS_CTZ64
     /* Hash X pieces using bit scanning */
@@ -127,7 +159,7 @@ uint64_t zobrist_hash(Bitboard board, char aiPlayer)
         int bit = CTZ64(x_pieces);
         int row = BIT_TO_ROW(bit);
         int col = BIT_TO_COL(bit);
-        hash ^= zobrist_keys[row][col][0];
+        hash ^= keys->pieces[row][col][0];
         x_pieces &= x_pieces - 1;
     }
 
@@ -138,7 +170,7 @@ uint64_t zobrist_hash(Bitboard board, char aiPlayer)
         int bit = CTZ64(o_pieces);
         int row = BIT_TO_ROW(bit);
         int col = BIT_TO_COL(bit);
-        hash ^= zobrist_keys[row][col][1];
+        hash ^= keys->pieces[row][col][1];
         o_pieces &= o_pieces - 1;
     }
 #else
@@ -150,7 +182,7 @@ uint64_t zobrist_hash(Bitboard board, char aiPlayer)
             char cell = bitboard_get_cell(board, r, c);
             if (cell != ' ')
             {
-                hash ^= zobrist_keys[r][c][player_to_index(cell)];
+                hash ^= keys->pieces[r][c][player_to_index(cell)];
             }
         }
     }
@@ -159,95 +191,166 @@ uint64_t zobrist_hash(Bitboard board, char aiPlayer)
     return hash;
 }
 
-uint64_t zobrist_toggle(uint64_t hash, int row, int col, char player)
+uint64_t zobrist_toggle_r(const ZobristKeys *keys, uint64_t hash, int row, int col, char player)
 {
-    return hash ^ zobrist_keys[row][col][player_to_index(player)];
+    return hash ^ keys->pieces[row][col][player_to_index(player)];
 }
 
-uint64_t zobrist_toggle_turn(uint64_t hash)
+uint64_t zobrist_toggle_turn_r(const ZobristKeys *keys, uint64_t hash)
 {
-    return hash ^ zobrist_turn_key;
+    return hash ^ keys->turn;
 }
 
-void transposition_table_init(size_t size)
+void zobrist_symmetric_hash_r(const ZobristKeys *keys, Bitboard board, char player,
+                              ZobristSymmetricHash *out_hash)
+{
+    for (int s = 0; s < ZOBRIST_SYMMETRY_COUNT; s++)
+        out_hash->keys[s] = keys->player[player_to_index(player)];
+
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+    {
+        char piece = bitboard_get_cell(board, BIT_TO_ROW(cell), BIT_TO_COL(cell));
+        if (piece != ' ')
+            zobrist_symmetric_toggle_r(keys, out_hash, BIT_TO_ROW(cell), BIT_TO_COL(cell), piece, 0);
+    }
+}
+
+void zobrist_symmetric_toggle_r(const ZobristKeys *keys, ZobristSymmetricHash *hash, int row, int col,
+                                char player, int toggle_turn)
+{
+    const uint64_t *cell_keys = keys->symmetric[POS_TO_BIT(row, col)][player_to_index(player)];
+    uint64_t turn = toggle_turn ? keys->turn : 0;
+    for (int s = 0; s < ZOBRIST_SYMMETRY_COUNT; s++)
+        hash->keys[s] ^= cell_keys[s] ^ turn;
+}
+
+uint64_t zobrist_canonical(const ZobristSymmetricHash *hash, int *out_symmetry)
+{
+    int best = 0;
+    for (int s = 1; s < ZOBRIST_SYMMETRY_COUNT; s++)
+    {
+        if (hash->keys[s] < hash->keys[best])
+            best = s;
+    }
+    *out_symmetry = best;
+    return hash->keys[best];
+}
+
+int zobrist_symmetry_map_r(const ZobristKeys *keys, int symmetry, int cell)
+{
+    return (cell < 0) ? -1 : keys->symmetry_cells[symmetry][cell];
+}
+
+int zobrist_symmetry_unmap_r(const ZobristKeys *keys, int symmetry, int cell)
+{
+    return (cell < 0) ? -1 : keys->symmetry_inverse_cells[symmetry][cell];
+}
+
+void transposition_table_init_r(TranspositionTable *table, size_t size)
 {
     /* Free existing table if reinitializing */
-    if (transposition_table != NULL)
+    if (table->entries != NULL)
     {
-        free(transposition_table);
-        transposition_table = NULL;
+        free(table->entries);
+        table->entries = NULL;
     }
 
     /* Handle size 0: disable TT entirely */
     if (size == 0)
     {
-        transposition_table = NULL;
-        transposition_table_size = 0;
-        transposition_table_mask = 0;
+        table->entries = NULL;
+        table->size = 0;
+        table->mask = 0;
         return;
     }
 
     /* Round up to power of 2 for efficient indexing */
-    transposition_table_size = round_up_power_of_2(size);
-    transposition_table_mask = transposition_table_size - 1;
+    table->size = round_up_power_of_2(size);
+    table->mask = table->size - 1;
 
-    transposition_table = (TranspositionTableEntry *)calloc(transposition_table_size, sizeof(TranspositionTableEntry));
+    table->entries = (TranspositionTableEntry *)calloc(table->size, sizeof(TranspositionTableEntry));
 
-    if (transposition_table == NULL)
+    if (table->entries == NULL)
     {
         const size_t requested_size = size;
-        double table_size_mb = ((double)transposition_table_size * (double)sizeof(TranspositionTableEntry)) / (1024.0 * 1024.0);
+        double table_size_mb = ((double)table->size * (double)sizeof(TranspositionTableEntry)) / (1024.0 * 1024.0);
         fprintf(stderr, "Warning: Failed to allocate transposition table (%zu entries requested, %zu actual, %.1f MB)\n",
-                requested_size, transposition_table_size,
+                requested_size, table->size,
                 table_size_mb);
         fprintf(stderr, "Continuing without transposition table.\n");
-        transposition_table_size = 0;
-        transposition_table_mask = 0;
+        table->size = 0;
+        table->mask = 0;
     }
 }
 
-void transposition_table_free(void)
+void transposition_table_free_r(TranspositionTable *table)
 {
-    if (transposition_table != NULL)
+    if (table->entries != NULL)
     {
-        free(transposition_table);
-        transposition_table = NULL;
+        free(table->entries);
+        table->entries = NULL;
     }
-    transposition_table_size = 0;
-    transposition_table_mask = 0;
+    table->size = 0;
+    table->mask = 0;
 }
 
-int transposition_table_probe(uint64_t hash, int alpha, int beta,
-                              int *restrict out_score)
+int transposition_table_probe_r(const TranspositionTable *table, uint64_t hash, int alpha, int beta,
+                                int *restrict out_score)
 {
-    if (transposition_table == NULL || transposition_table_size == 0)
+    return transposition_table_probe_depth_r(table, hash, TRANSPOSITION_TABLE_DEPTH_FULL, alpha, beta, out_score);
+}
+
+int transposition_table_probe_depth_r(const TranspositionTable *table, uint64_t hash, int depth,
+                                      int alpha, int beta, int *restrict out_score)
+{
+    int ignored;
+    return transposition_table_probe_move_r(table, hash, depth, alpha, beta, out_score, &ignored);
+}
+
+int transposition_table_probe_move_r(const TranspositionTable *table, uint64_t hash, int depth,
+                                     int alpha, int beta, int *restrict out_score, int *restrict out_move)
+{
+    *out_move = -1;
+    if (table->entries == NULL || table->size == 0)
     {
         return 0;
     }
 
-    size_t index = hash & transposition_table_mask;
-    const TranspositionTableEntry *entry = &transposition_table[index];
+    size_t index = hash & table->mask;
+    TranspositionTableEntry *slot = &table->entries[index];
+
+    /* Snapshot the entry; other search threads may be writing it */
+    TranspositionTableEntry entry;
+    entry.data = atomic_load_u64(&slot->data);
+    entry.hash = atomic_load_u64(&slot->hash) ^ entry.data;
 
     /* Empty slot */
-    if (entry->occupied == 0)
+    if (entry.occupied == 0)
     {
         return 0;
     }
 
-    /* Hash collision */
-    if (entry->hash != hash)
+    /* Hash collision (or an entry torn by a concurrent store) */
+    if (entry.hash != hash)
     {
         return 0;
     }
 
-    /* No depth check needed - scores are now depth-independent */
+    /* The move is a good first guess at any draft and bound */
+    *out_move = (int)entry.best_move - 1;
+
+    /* Game values do not depend on depth; only a shallower draft is unusable */
+    if (entry.depth < depth)
+    {
+        return 0;
+    }
 
-    int score = entry->score;
+    int score = entry.score;
 
     /* Use stored score based on node type and bounds */
-    if (entry->type == TRANSPOSITION_TABLE_EXACT ||
-        (entry->type == TRANSPOSITION_TABLE_LOWERBOUND && score >= beta) ||
-        (entry->type == TRANSPOSITION_TABLE_UPPERBOUND && score <= alpha))
+    if (entry.type == TRANSPOSITION_TABLE_EXACT ||
+        (entry.type == TRANSPOSITION_TABLE_LOWERBOUND && score >= beta) ||
+        (entry.type == TRANSPOSITION_TABLE_UPPERBOUND && score <= alpha))
     {
         *out_score = score;
         return 1;
@@ -256,19 +359,162 @@ int transposition_table_probe(uint64_t hash, int alpha, int beta,
     return 0;
 }
 
-void transposition_table_store(uint64_t hash, int score, TranspositionTableNodeType type)
+void transposition_table_store_r(TranspositionTable *table, uint64_t hash, int score,
+                                 TranspositionTableNodeType type)
+{
+    transposition_table_store_depth_r(table, hash, TRANSPOSITION_TABLE_DEPTH_FULL, score, type);
+}
+
+int transposition_table_best_move_r(const TranspositionTable *table, uint64_t hash)
+{
+    int score, move;
+    transposition_table_probe_move_r(table, hash, TRANSPOSITION_TABLE_DEPTH_FULL, 0, 0, &score, &move);
+    return move;
+}
+
+void transposition_table_store_depth_r(TranspositionTable *table, uint64_t hash, int depth, int score,
+                                       TranspositionTableNodeType type)
+{
+    transposition_table_store_move_r(table, hash, depth, score, type, -1);
+}
+
+void transposition_table_store_move_r(TranspositionTable *table, uint64_t hash, int depth, int score,
+                                      TranspositionTableNodeType type, int move)
 {
-    if (transposition_table == NULL || transposition_table_size == 0)
+    if (table->entries == NULL || table->size == 0)
     {
         return;
     }
 
-    size_t index = hash & transposition_table_mask;
-    TranspositionTableEntry *entry = &transposition_table[index];
+    size_t index = hash & table->mask;
+    TranspositionTableEntry *slot = &table->entries[index];
+
+    TranspositionTableEntry entry;
+    entry.data = 0;
+    entry.score = (int16_t)score;
+    entry.type = (uint8_t)type;
+    entry.occupied = 1;
+    entry.depth = (uint8_t)depth;
+    entry.best_move = (uint8_t)(move + 1);
+
+    /* Replacement strategy: always replace (lockless, key XOR data) */
+    atomic_store_u64(&slot->hash, hash ^ entry.data);
+    atomic_store_u64(&slot->data, entry.data);
+}
+
+TranspositionTableSlot transposition_table_peek_r(const TranspositionTable *table, uint64_t hash)
+{
+    if (table->entries == NULL || table->size == 0)
+    {
+        return TRANSPOSITION_TABLE_SLOT_EMPTY;
+    }
+
+    TranspositionTableEntry *slot = &table->entries[hash & table->mask];
+    TranspositionTableEntry entry;
+    entry.data = atomic_load_u64(&slot->data);
+    entry.hash = atomic_load_u64(&slot->hash) ^ entry.data;
+
+    if (entry.occupied == 0)
+    {
+        return TRANSPOSITION_TABLE_SLOT_EMPTY;
+    }
+    return (entry.hash == hash) ? TRANSPOSITION_TABLE_SLOT_MATCH : TRANSPOSITION_TABLE_SLOT_OTHER;
+}
+
+/* Functions without a context argument: the default keys and table */
+
+void zobrist_set_seed(uint64_t seed)
+{
+    zobrist_set_seed_r(&default_keys, seed);
+}
+
+void zobrist_init(void)
+{
+    zobrist_init_r(&default_keys);
+}
+
+uint64_t zobrist_hash(Bitboard board, char player)
+{
+    return zobrist_hash_r(&default_keys, board, player);
+}
+
+uint64_t zobrist_toggle(uint64_t hash, int row, int col, char player)
+{
+    return zobrist_toggle_r(&default_keys, hash, row, col, player);
+}
 
-    /* Replacement strategy: always replace */
-    entry->hash = hash;
-    entry->score = (int16_t)score;
-    entry->type = (uint8_t)type;
-    entry->occupied = 1;
+uint64_t zobrist_toggle_turn(uint64_t hash)
+{
+    return zobrist_toggle_turn_r(&default_keys, hash);
+}
+
+void zobrist_symmetric_hash(Bitboard board, char player, ZobristSymmetricHash *out_hash)
+{
+    zobrist_symmetric_hash_r(&default_keys, board, player, out_hash);
+}
+
+void zobrist_symmetric_toggle(ZobristSymmetricHash *hash, int row, int col, char player,
+                              int toggle_turn)
+{
+    zobrist_symmetric_toggle_r(&default_keys, hash, row, col, player, toggle_turn);
+}
+
+int zobrist_symmetry_map(int symmetry, int cell)
+{
+    return zobrist_symmetry_map_r(&default_keys, symmetry, cell);
+}
+
+int zobrist_symmetry_unmap(int symmetry, int cell)
+{
+    return zobrist_symmetry_unmap_r(&default_keys, symmetry, cell);
+}
+
+void transposition_table_init(size_t size)
+{
+    transposition_table_init_r(&default_table, size);
+}
+
+void transposition_table_free(void)
+{
+    transposition_table_free_r(&default_table);
+}
+
+int transposition_table_probe(uint64_t hash, int alpha, int beta,
+                              int *restrict out_score)
+{
+    return transposition_table_probe_r(&default_table, hash, alpha, beta, out_score);
+}
+
+int transposition_table_probe_depth(uint64_t hash, int depth, int alpha, int beta,
+                                    int *restrict out_score)
+{
+    return transposition_table_probe_depth_r(&default_table, hash, depth, alpha, beta, out_score);
+}
+
+int transposition_table_probe_move(uint64_t hash, int depth, int alpha, int beta,
+                                   int *restrict out_score, int *restrict out_move)
+{
+    return transposition_table_probe_move_r(&default_table, hash, depth, alpha, beta, out_score, out_move);
+}
+
+void transposition_table_store(uint64_t hash, int score, TranspositionTableNodeType type)
+{
+    transposition_table_store_r(&default_table, hash, score, type);
+}
+
+int transposition_table_best_move(uint64_t hash)
+{
+    return transposition_table_best_move_r(&default_table, hash);
+}
+
+void transposition_table_store_depth(uint64_t hash, int depth, int score,
+                                     TranspositionTableNodeType type)
+{
+    transposition_table_store_depth_r(&default_table, hash, depth, score, type);
+}
+
+void transposition_table_store_move(uint64_t hash, int depth, int score,
+                                    TranspositionTableNodeType type, int move)
+{
+    transposition_table_store_move_r(&default_table, hash, depth, score, type, move);
 }
@@ -6,8 +6,17 @@
  *
  * Key components:
  *  - Zobrist hashing: incremental position hashing via XOR
- *  - Transposition table storage: hash table mapping positions to (score, bounds)
+ *  - Transposition table storage: hash table mapping positions to (score, bounds, draft,
+ *    best move);
+ *    scores are relative to the side to move, so both players' searches
+ *    share entries
  *  - Replacement strategy: always-replace for hash collisions
+ *  - Lockless sharing: entries can be probed and stored concurrently by
+ *    several search threads (XOR-verified, no locks)
+ *  - Reentrant versions (suffix _r): the same functions on explicit
+ *    ZobristKeys and TranspositionTable objects, so independent engines
+ *    (see engineCreate in mini_max.h) never share state. The functions
+ *    without the suffix use the default keys and table.
  *
  * Usage:
  *  1. Call zobrist_init() once at program startup
@@ -29,10 +38,13 @@ extern "C"
 {
 #endif
 
+/* Seed of the Zobrist keys unless zobrist_set_seed() picks another (golden ratio) */
+#define ZOBRIST_DEFAULT_SEED 0x9e3779b97f4a7c15ULL
+
     /**
      * Set the seed for Zobrist key generation.
      * Call this before zobrist_init() to use a specific seed.
-     * Default seed: 0x9e3779b97f4a7c15 (deterministic)
+     * Default seed: ZOBRIST_DEFAULT_SEED (deterministic)
      *
      * Parameters:
      *  - seed: 64-bit seed value
@@ -51,11 +63,11 @@ extern "C"
      *
      * Parameters:
      *  - board: Current position (bitboard representation)
-     *  - aiPlayer: The maximizing player ('x' or 'o')
+     *  - player: The side to move ('x' or 'o')
      *
      * Returns: 64-bit Zobrist hash for this position
      */
-    uint64_t zobrist_hash(Bitboard board, char aiPlayer);
+    uint64_t zobrist_hash(Bitboard board, char player);
 
     /**
      * Incremental hash update: toggle a piece on/off.
@@ -75,7 +87,8 @@ extern "C"
 
     /**
      * Toggle the side-to-move component in the hash.
-     * Call this when transitioning between maximizing and minimizing plies.
+     * Call this after every move: zobrist_toggle_turn(zobrist_hash(board, 'x'))
+     * equals zobrist_hash(board, 'o').
      *
      * Parameters:
      *  - hash: Current position hash
@@ -84,6 +97,80 @@ extern "C"
      */
     uint64_t zobrist_toggle_turn(uint64_t hash);
 
+/* Symmetries of the square board: 4 rotations and 4 reflections. */
+#define ZOBRIST_SYMMETRY_COUNT 8
+
+    /**
+     * Zobrist hashes of a position under every board symmetry:
+     * keys[s] is the zobrist_hash of the board mapped through symmetry s
+     * (keys[0] = plain hash). Positions that are rotations or reflections of
+     * each other have the same set of keys, so the smallest one is a key
+     * shared by all of them (see zobrist_canonical).
+     */
+    typedef struct
+    {
+        uint64_t keys[ZOBRIST_SYMMETRY_COUNT];
+    } ZobristSymmetricHash;
+
+    /** Compute all symmetric hashes of a position from scratch. */
+    void zobrist_symmetric_hash(Bitboard board, char player, ZobristSymmetricHash *out_hash);
+
+    /**
+     * Incremental update of every symmetric hash for a piece toggled on or
+     * off (same usage as zobrist_toggle). Also toggles the side to move when
+     * toggle_turn is non-zero.
+     */
+    void zobrist_symmetric_toggle(ZobristSymmetricHash *hash, int row, int col, char player,
+                                  int toggle_turn);
+
+    /**
+     * Canonical key: the smallest symmetric hash. The symmetry that produced
+     * it goes to out_symmetry; moves stored under the key must be mapped
+     * through it (zobrist_symmetry_map) and mapped back when probed
+     * (zobrist_symmetry_unmap).
+     */
+    uint64_t zobrist_canonical(const ZobristSymmetricHash *hash, int *out_symmetry);
+
+    /** Cell index of cell under symmetry, and its inverse; -1 stays -1. */
+    int zobrist_symmetry_map(int symmetry, int cell);
+    int zobrist_symmetry_unmap(int symmetry, int cell);
+
+    /**
+     * One set of Zobrist keys and the symmetry cell maps derived from them.
+     * Filled by zobrist_init_r(); read-only afterwards, so any number of
+     * threads may hash with the same keys.
+     */
+    typedef struct ZobristKeys
+    {
+        uint64_t pieces[BOARD_SIZE][BOARD_SIZE][2]; /* [row][col][0 = 'x', 1 = 'o'] */
+        uint64_t player[2];                         /* Side to move */
+        uint64_t turn;                              /* player[0] ^ player[1] */
+        /* [cell][player][symmetry]: key of the cell's image under the symmetry */
+        uint64_t symmetric[MAX_MOVES][2][ZOBRIST_SYMMETRY_COUNT];
+        uint8_t symmetry_cells[ZOBRIST_SYMMETRY_COUNT][MAX_MOVES];
+        uint8_t symmetry_inverse_cells[ZOBRIST_SYMMETRY_COUNT][MAX_MOVES];
+        uint64_t rng_state; /* SplitMix64 state the next zobrist_init_r() draws from */
+    } ZobristKeys;
+
+    /** Keys used by the zobrist_* functions without a keys argument. */
+    ZobristKeys *zobrist_default_keys(void);
+
+    /*
+     * Reentrant versions of the functions above, on explicit keys. A
+     * zero-initialized ZobristKeys must be seeded before zobrist_init_r().
+     */
+    void zobrist_set_seed_r(ZobristKeys *keys, uint64_t seed);
+    void zobrist_init_r(ZobristKeys *keys);
+    uint64_t zobrist_hash_r(const ZobristKeys *keys, Bitboard board, char player);
+    uint64_t zobrist_toggle_r(const ZobristKeys *keys, uint64_t hash, int row, int col, char player);
+    uint64_t zobrist_toggle_turn_r(const ZobristKeys *keys, uint64_t hash);
+    void zobrist_symmetric_hash_r(const ZobristKeys *keys, Bitboard board, char player,
+                                  ZobristSymmetricHash *out_hash);
+    void zobrist_symmetric_toggle_r(const ZobristKeys *keys, ZobristSymmetricHash *hash, int row, int col,
+                                    char player, int toggle_turn);
+    int zobrist_symmetry_map_r(const ZobristKeys *keys, int symmetry, int cell);
+    int zobrist_symmetry_unmap_r(const ZobristKeys *keys, int symmetry, int cell);
+
     /**
      * Transposition table entry types (bound classification)
      */
@@ -94,6 +181,13 @@ extern "C"
         TRANSPOSITION_TABLE_UPPERBOUND  /* Score <= stored value (alpha cutoff: score <= alpha) */
     } TranspositionTableNodeType;
 
+/*
+ * Draft of an entry whose score is the exact game-theoretic bound (searched
+ * to the end of the game). Depth-limited searches store the number of plies
+ * they searched instead.
+ */
+#define TRANSPOSITION_TABLE_DEPTH_FULL 255
+
     /**
      * Transposition table entry.
      * Stores search results for a single position.
@@ -102,15 +196,29 @@ extern "C"
      * collision with legitimate zero-hash positions (1 in 2^64 probability).
      * This preserves full 64-bit hash entropy and prevents artificial collisions.
      *
+     * Lockless sharing: the payload fields overlay a single 64-bit word and
+     * 'hash' is stored as (Zobrist hash XOR data). A reader that observes a
+     * half-written entry from another thread sees a key that no longer matches
+     * and treats it as a miss, so torn entries are never used.
+     *
      * Total size: 16 bytes (16-byte aligned for memory efficiency)
      */
     typedef struct
     {
-        uint64_t hash;      /* Zobrist hash (full 64-bit, no encoding needed) */
-        int16_t score;      /* Stored score */
-        uint8_t type;       /* TranspositionTableNodeType */
-        uint8_t occupied;   /* 0 = empty slot, 1 = occupied */
-        uint8_t padding[4]; /* Padding for alignment */
+        uint64_t hash; /* Zobrist hash XOR data */
+        union
+        {
+            struct
+            {
+                int16_t score;      /* Stored score */
+                uint8_t type;       /* TranspositionTableNodeType */
+                uint8_t occupied;   /* 0 = empty slot, 1 = occupied */
+                uint8_t depth;      /* Draft in plies, or TRANSPOSITION_TABLE_DEPTH_FULL */
+                uint8_t best_move;  /* Best move's cell index + 1, 0 = none */
+                uint8_t padding[2]; /* Padding for alignment */
+            };
+            uint64_t data; /* Payload as one word for atomic access */
+        };
     } TranspositionTableEntry;
 
     /**
@@ -154,6 +262,105 @@ extern "C"
      */
     void transposition_table_store(uint64_t hash, int score, TranspositionTableNodeType type);
 
+    /**
+     * Probe for a result searched at least depth plies deep.
+     * transposition_table_probe() is the TRANSPOSITION_TABLE_DEPTH_FULL case:
+     * depth-limited entries never answer a full-depth probe.
+     *
+     * Parameters:
+     *  - hash: Position hash to look up
+     *  - depth: Required draft (0..TRANSPOSITION_TABLE_DEPTH_FULL)
+     *  - alpha, beta: Current alpha-beta bounds
+     *  - out_score: Output pointer for retrieved score (if found)
+     *
+     * Returns: 1 if a usable entry was found, 0 otherwise
+     */
+    int transposition_table_probe_depth(uint64_t hash, int depth, int alpha, int beta,
+                                        int *restrict out_score);
+
+    /**
+     * Store a result searched depth plies deep (TRANSPOSITION_TABLE_DEPTH_FULL
+     * for an exact game value, as transposition_table_store() does).
+     */
+    void transposition_table_store_depth(uint64_t hash, int depth, int score,
+                                         TranspositionTableNodeType type);
+
+    /**
+     * Probe like transposition_table_probe_depth() and also report the best
+     * move stored for the position, even when the entry is too shallow or its
+     * bound does not cut off (the move is still the best first guess).
+     *
+     * Parameters:
+     *  - hash, depth, alpha, beta, out_score: as transposition_table_probe_depth()
+     *  - out_move: Output for the best move's cell index (row * BOARD_SIZE + col),
+     *              or -1 if the position is not stored or has no move
+     *
+     * Returns: 1 if a usable score was found, 0 otherwise
+     */
+    int transposition_table_probe_move(uint64_t hash, int depth, int alpha, int beta,
+                                       int *restrict out_score, int *restrict out_move);
+
+    /**
+     * Return the best move stored for a position: its cell index, or -1 if
+     * the position is not stored or has no move.
+     */
+    int transposition_table_best_move(uint64_t hash);
+
+    /**
+     * Store a result like transposition_table_store_depth(), together with the
+     * node's best move (cell index, or -1 for none, e.g. terminal positions).
+     */
+    void transposition_table_store_move(uint64_t hash, int depth, int score,
+                                        TranspositionTableNodeType type, int move);
+
+    /**
+     * One transposition table. Zero-initialized it holds no entries (every
+     * probe misses, every store is dropped) until transposition_table_init_r().
+     * Probes and stores may run concurrently (lockless sharing); init and
+     * free must not overlap any other access.
+     */
+    typedef struct TranspositionTable
+    {
+        TranspositionTableEntry *entries;
+        size_t size; /* Entry count, a power of two (0 = no table) */
+        size_t mask; /* Bitmask for fast modulo (size - 1) */
+    } TranspositionTable;
+
+    /** What the slot of a hash holds (see transposition_table_peek_r). */
+    typedef enum
+    {
+        TRANSPOSITION_TABLE_SLOT_EMPTY, /* Nothing stored, or no table */
+        TRANSPOSITION_TABLE_SLOT_OTHER, /* Another position's entry */
+        TRANSPOSITION_TABLE_SLOT_MATCH  /* The position's own entry */
+    } TranspositionTableSlot;
+
+    /**
+     * Classify the slot of hash without using its entry: a store to a slot
+     * holding another position overwrites it, a probe of a matching slot
+     * hits. For search statistics (HP_STATS builds).
+     */
+    TranspositionTableSlot transposition_table_peek_r(const TranspositionTable *table, uint64_t hash);
+
+    /** Table used by the transposition_table_* functions without a table argument. */
+    TranspositionTable *transposition_table_default(void);
+
+    /* Reentrant versions of the functions above, on an explicit table. */
+    void transposition_table_init_r(TranspositionTable *table, size_t size);
+    void transposition_table_free_r(TranspositionTable *table);
+    int transposition_table_probe_r(const TranspositionTable *table, uint64_t hash, int alpha, int beta,
+                                    int *restrict out_score);
+    void transposition_table_store_r(TranspositionTable *table, uint64_t hash, int score,
+                                     TranspositionTableNodeType type);
+    int transposition_table_probe_depth_r(const TranspositionTable *table, uint64_t hash, int depth,
+                                          int alpha, int beta, int *restrict out_score);
+    void transposition_table_store_depth_r(TranspositionTable *table, uint64_t hash, int depth, int score,
+                                           TranspositionTableNodeType type);
+    int transposition_table_probe_move_r(const TranspositionTable *table, uint64_t hash, int depth,
+                                         int alpha, int beta, int *restrict out_score, int *restrict out_move);
+    int transposition_table_best_move_r(const TranspositionTable *table, uint64_t hash);
+    void transposition_table_store_move_r(TranspositionTable *table, uint64_t hash, int depth, int score,
+                                          TranspositionTableNodeType type, int move);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,9 +20,11 @@ char human_symbol = 'x';
 char ai_symbol = 'o';
 
 /* Win detection masks for rows, columns, and diagonals */
-#define WIN_MASK_COUNT (2 * BOARD_SIZE + 2)
 static uint64_t win_masks[WIN_MASK_COUNT];
 
+/* Cells with col - row = d, at index d + BOARD_SIZE - 1 (board transforms) */
+static uint64_t diagonal_masks[2 * BOARD_SIZE - 1];
+
 /* Consume the rest of the current input line (including newline). */
 static void discardLine(void)
 {
@@ -79,6 +81,15 @@ void init_win_masks(void)
     for (int i = 0; i < BOARD_SIZE; i++)
         mask |= BIT_MASK(i, BOARD_SIZE - 1 - i);
     win_masks[idx++] = mask;
+
+    /* Diagonals parallel to the main one, for transposing */
+    for (int d = 0; d < 2 * BOARD_SIZE - 1; d++)
+        diagonal_masks[d] = 0;
+    for (int r = 0; r < BOARD_SIZE; r++)
+    {
+        for (int c = 0; c < BOARD_SIZE; c++)
+            diagonal_masks[c - r + BOARD_SIZE - 1] |= BIT_MASK(r, c);
+    }
 }
 
 /* Check if a player has won using pre-computed masks */
@@ -92,6 +103,193 @@ int bitboard_has_won(uint64_t player_pieces)
     return 0;
 }
 
+/*
+ * Threat cells: a line missing at most one of player's pieces contributes its
+ * missing cell (a single bit, or nothing). Lines the opponent has entered miss
+ * an occupied cell, which the final mask with the empty cells drops.
+ */
+uint64_t bitboard_threat_cells(uint64_t player_pieces, uint64_t empty)
+{
+    uint64_t threats = 0;
+    for (int i = 0; i < WIN_MASK_COUNT; i++)
+    {
+        uint64_t missing = win_masks[i] & ~player_pieces;
+        if ((missing & (missing - 1)) == 0)
+            threats |= missing;
+    }
+    return threats & empty;
+}
+
+/*
+ * Live cells: the union of every line that does not yet hold pieces of both
+ * players. A line holding both can never be completed by either side.
+ */
+uint64_t bitboard_live_cells(Bitboard board)
+{
+    uint64_t live = 0;
+    for (int i = 0; i < WIN_MASK_COUNT; i++)
+    {
+        if ((win_masks[i] & board.x_pieces) == 0 || (win_masks[i] & board.o_pieces) == 0)
+            live |= win_masks[i];
+    }
+    return live;
+}
+
+void line_counts_init(LineCounts *lines, Bitboard board)
+{
+    lines->live = 0;
+    lines->threats[0] = 0;
+    lines->threats[1] = 0;
+    lines->completed[0] = 0;
+    lines->completed[1] = 0;
+    for (int i = 0; i < WIN_MASK_COUNT; i++)
+    {
+        /* Start empty, then add the line's pieces to get its bits right */
+        lines->count[0][i] = 0;
+        lines->count[1][i] = 0;
+        line_counts_add(lines, i, 0, 0);
+        uint64_t x = board.x_pieces & win_masks[i];
+        uint64_t o = board.o_pieces & win_masks[i];
+        for (; x; x &= x - 1)
+            line_counts_add(lines, i, 0, 1);
+        for (; o; o &= o - 1)
+            line_counts_add(lines, i, 1, 1);
+    }
+}
+
+/* A threat line holds every cell but one for player and none of the opponent's. */
+uint64_t line_counts_threat_cells(const LineCounts *lines, char player, uint64_t player_pieces)
+{
+    uint64_t threats = 0;
+    uint32_t bits = lines->threats[(player == 'x') ? 0 : 1];
+    for (int i = 0; bits != 0; i++, bits >>= 1)
+    {
+        if (bits & 1)
+            threats |= win_masks[i] & ~player_pieces;
+    }
+    return threats;
+}
+
+uint64_t line_counts_live_cells(const LineCounts *lines)
+{
+    uint64_t live = 0;
+    uint32_t bits = lines->live;
+    for (int i = 0; bits != 0; i++, bits >>= 1)
+    {
+        if (bits & 1)
+            live |= win_masks[i];
+    }
+    return live;
+}
+
+/* Shift cells left by a signed bit count (right if negative). */
+static inline uint64_t shiftCells(uint64_t cells, int bits)
+{
+    return (bits >= 0) ? cells << bits : cells >> -bits;
+}
+
+/* Row r moves to row n - r: each row shifts as a block. */
+static uint64_t flipRows(uint64_t cells)
+{
+    uint64_t out = 0;
+    for (int r = 0; r < BOARD_SIZE; r++)
+        out |= shiftCells(cells & win_masks[r], (BOARD_SIZE - 1 - 2 * r) * BOARD_SIZE);
+    return out;
+}
+
+/* Column c moves to column n - c: each column shifts as a block. */
+static uint64_t mirrorColumns(uint64_t cells)
+{
+    uint64_t out = 0;
+    for (int c = 0; c < BOARD_SIZE; c++)
+        out |= shiftCells(cells & win_masks[BOARD_SIZE + c], BOARD_SIZE - 1 - 2 * c);
+    return out;
+}
+
+/* (r, c) moves to (c, r): the diagonal with c - r = d shifts by d * (n - 1). */
+static uint64_t transposeCells(uint64_t cells)
+{
+    uint64_t out = 0;
+    for (int d = 1 - BOARD_SIZE; d < BOARD_SIZE; d++)
+        out |= shiftCells(cells & diagonal_masks[d + BOARD_SIZE - 1], d * (BOARD_SIZE - 1));
+    return out;
+}
+
+uint64_t bitboard_transform(uint64_t cells, int symmetry)
+{
+    switch (symmetry)
+    {
+    case 1:
+        return mirrorColumns(transposeCells(cells));
+    case 2:
+        return flipRows(mirrorColumns(cells));
+    case 3:
+        return flipRows(transposeCells(cells));
+    case 4:
+        return mirrorColumns(cells);
+    case 5:
+        return flipRows(cells);
+    case 6:
+        return transposeCells(cells);
+    case 7:
+        return flipRows(mirrorColumns(transposeCells(cells)));
+    default:
+        return cells;
+    }
+}
+
+/*
+ * The three base transforms of each side's pieces are computed once; the
+ * rotations and the anti-transpose are compositions of them.
+ */
+unsigned bitboard_symmetries(Bitboard board)
+{
+    uint64_t x_mirror = mirrorColumns(board.x_pieces);
+    uint64_t o_mirror = mirrorColumns(board.o_pieces);
+    uint64_t x_transpose = transposeCells(board.x_pieces);
+    uint64_t o_transpose = transposeCells(board.o_pieces);
+    uint64_t x_images[BITBOARD_SYMMETRY_COUNT] = {
+        board.x_pieces, mirrorColumns(x_transpose), flipRows(x_mirror), flipRows(x_transpose),
+        x_mirror, flipRows(board.x_pieces), x_transpose, flipRows(mirrorColumns(x_transpose))};
+    uint64_t o_images[BITBOARD_SYMMETRY_COUNT] = {
+        board.o_pieces, mirrorColumns(o_transpose), flipRows(o_mirror), flipRows(o_transpose),
+        o_mirror, flipRows(board.o_pieces), o_transpose, flipRows(mirrorColumns(o_transpose))};
+
+    unsigned symmetries = 0;
+    for (int s = 0; s < BITBOARD_SYMMETRY_COUNT; s++)
+    {
+        if (x_images[s] == board.x_pieces && o_images[s] == board.o_pieces)
+            symmetries |= 1u << s;
+    }
+    return symmetries;
+}
+
+/* Walk the cells lowest first; each kept cell drops its images from the rest. */
+uint64_t bitboard_unique_cells(uint64_t cells, unsigned symmetries)
+{
+    if (symmetries <= 1)
+        return cells;
+
+    uint64_t unique = 0;
+    while (cells)
+    {
+        uint64_t cell = cells & (~cells + 1);
+        unique |= cell;
+        for (int s = 1; s < BITBOARD_SYMMETRY_COUNT; s++)
+        {
+            if (symmetries & (1u << s))
+                cells &= ~bitboard_transform(cell, s);
+        }
+        cells &= ~cell;
+    }
+    return unique;
+}
+
+const uint64_t *bitboard_win_masks(void)
+{
+    return win_masks;
+}
+
 /* Win check based on last move */
 int bitboard_did_last_move_win(uint64_t player_pieces, int row, int col)
 {
@@ -40,6 +40,9 @@ extern "C"
 
 #define MAX_MOVES ((BOARD_SIZE) * (BOARD_SIZE))
 
+/* Number of winning lines: every row, every column and both diagonals */
+#define WIN_MASK_COUNT (2 * BOARD_SIZE + 2)
+
     /* Bitboard representation: two uint64_t bitboards for x and o pieces */
     typedef struct
     {
@@ -162,12 +165,132 @@ extern "C"
      */
     int bitboard_has_won(uint64_t player_pieces);
 
+    /**
+     * Empty cells that would complete a line for player_pieces (immediate
+     * wins if player is to move, cells to block otherwise), as a bitmask.
+     *
+     * Parameters:
+     *  - player_pieces: Pieces of the player to test
+     *  - empty:         Empty cells of the board
+     */
+    uint64_t bitboard_threat_cells(uint64_t player_pieces, uint64_t empty);
+
+    /**
+     * Cells on at least one line that either player can still complete, as a
+     * bitmask. Zero once every line holds pieces of both players: the game
+     * can only end in a tie.
+     */
+    uint64_t bitboard_live_cells(Bitboard board);
+
+    /**
+     * Pre-computed winning line masks (WIN_MASK_COUNT entries: rows, then
+     * columns, then the main and anti-diagonal). Valid after init_win_masks().
+     */
+    const uint64_t *bitboard_win_masks(void);
+
+/*
+ * Symmetries of the square board, numbered as the transposition table's
+ * symmetric keys: 0 identity, 1-3 rotations by 90/180/270 degrees clockwise,
+ * 4 left-right mirror, 5 top-bottom flip, 6 transpose, 7 anti-transpose.
+ */
+#define BITBOARD_SYMMETRY_COUNT 8
+
+    /**
+     * Map a cell mask through a board symmetry with row, column and diagonal
+     * shifts (no per-cell loop). Valid after init_win_masks().
+     */
+    uint64_t bitboard_transform(uint64_t cells, int symmetry);
+
+    /**
+     * Symmetries that map the position onto itself, as a bitmask with bit s
+     * set for symmetry s (bit 0 is always set).
+     */
+    unsigned bitboard_symmetries(Bitboard board);
+
+    /**
+     * Keep the lowest cell of every group of cells that the given symmetries
+     * (a bitboard_symmetries mask) map onto each other. If the symmetries
+     * preserve the position, moves on the dropped cells are equivalent to a
+     * kept one.
+     */
+    uint64_t bitboard_unique_cells(uint64_t cells, unsigned symmetries);
+
     /**
      * Win check based on last move.
      * Only checks relevant patterns (row, col, diagonals if applicable).
      */
     int bitboard_did_last_move_win(uint64_t player_pieces, int row, int col);
 
+    /* Incremental line state for search code */
+
+    /**
+     * Per-line piece counts of a position, kept in step with its Bitboard by
+     * line_counts_make/line_counts_unmake. Wins, dead lines and threats are
+     * then updated from the (at most four) lines through the moved cell
+     * instead of scanning every win mask. Line i is bitboard_win_masks()[i].
+     */
+    typedef struct
+    {
+        uint8_t count[2][WIN_MASK_COUNT]; /* Pieces per line [0 = 'x', 1 = 'o'][line] */
+        uint32_t live;                    /* Bit per line without pieces of both players */
+        uint32_t threats[2];              /* Bit per line one piece short of completion for a player */
+        int completed[2];                 /* Completed lines per player */
+    } LineCounts;
+
+    /** Fill lines from a board with a full scan. */
+    void line_counts_init(LineCounts *lines, Bitboard board);
+
+    /* Add delta pieces of player index p to one line and refresh its bits. */
+    static inline void line_counts_add(LineCounts *lines, int line, int p, int delta)
+    {
+        int count = lines->count[p][line] + delta;
+        lines->count[p][line] = (uint8_t)count;
+        if (count == BOARD_SIZE)
+            lines->completed[p]++;
+        else if (delta < 0 && count == BOARD_SIZE - 1)
+            lines->completed[p]--;
+
+        int x = lines->count[0][line];
+        int o = lines->count[1][line];
+        uint32_t bit = 1u << line;
+        lines->live = (lines->live & ~bit) | ((x == 0 || o == 0) ? bit : 0);
+        lines->threats[0] = (lines->threats[0] & ~bit) | ((o == 0 && x == BOARD_SIZE - 1) ? bit : 0);
+        lines->threats[1] = (lines->threats[1] & ~bit) | ((x == 0 && o == BOARD_SIZE - 1) ? bit : 0);
+    }
+
+    /* Apply delta to every line through (row, col). */
+    static inline void line_counts_update(LineCounts *lines, int row, int col, char player, int delta)
+    {
+        int p = (player == 'x') ? 0 : 1;
+        line_counts_add(lines, row, p, delta);
+        line_counts_add(lines, BOARD_SIZE + col, p, delta);
+        if (row == col)
+            line_counts_add(lines, 2 * BOARD_SIZE, p, delta);
+        if (row + col == BOARD_SIZE - 1)
+            line_counts_add(lines, 2 * BOARD_SIZE + 1, p, delta);
+    }
+
+    /** Count a piece of player placed on (row, col). */
+    static inline void line_counts_make(LineCounts *lines, int row, int col, char player)
+    {
+        line_counts_update(lines, row, col, player, 1);
+    }
+
+    /** Remove a piece of player from (row, col). */
+    static inline void line_counts_unmake(LineCounts *lines, int row, int col, char player)
+    {
+        line_counts_update(lines, row, col, player, -1);
+    }
+
+    /**
+     * Same as bitboard_threat_cells for player, using only the lines flagged
+     * in lines->threats (player_pieces: player's pieces on the board).
+     */
+    uint64_t line_counts_threat_cells(const LineCounts *lines, char player, uint64_t player_pieces);
+
+    /** Same as bitboard_live_cells, using only the lines flagged in lines->live. */
+    uint64_t line_counts_live_cells(const LineCounts *lines);
+
 #ifdef __cplusplus
 }
 #endif
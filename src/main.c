@@ -7,15 +7,32 @@
  *   * --quiet/-q suppresses all self-play output
  *   * --tt-size/-t overrides transposition table size
  *   * --seed sets PRNG seed for Zobrist keys (deterministic by default)
+ * - --threads N enables parallel search in both modes
+ * - --parallel lazy|ybwc|root selects the parallel algorithm (default: lazy)
+ * - --search ab|pvs selects plain alpha-beta or Principal Variation Search
+ * - --engine minimax|solver|dfpn|mcts selects the full-window search, the
+ *   outcome-only solver (default from 5x5 up), depth-first proof-number search
+ *   or Monte Carlo Tree Search (anytime; --time/--nodes bound its playouts)
+ * - --pn-memory MB caps the proof-number table of --engine dfpn
+ * - --mcts-memory MB caps the search tree of --engine mcts
+ * - --tablebase-build FILE solves every position (3x3/4x4) into FILE and exits;
+ *   --tablebase FILE maps it so the AI answers from the table
+ * - --book-build FILE [--book-plies N] searches every position of the first
+ *   N plies (within --time/--nodes if given) into FILE and exits; --book FILE
+ *   maps it so the AI plays those positions without searching
+ * - --symmetry on|off keys the transposition table by board symmetry
+ *   (default: on up to 4x4)
+ * - --solution-table on|off answers 3x3 moves from the built-in solution
+ *   table instead of searching (default: on)
+ * - --ponder on|off searches the human's likely replies in the background
+ *   while they think in interactive mode (default: on)
+ * - --time MS / --nodes N limit every AI move (iterative deepening, see
+ *   getAiMoveBudgeted); without them the AI searches to the end of the game
  */
 
-/* Platform-specific high-resolution timer */
-#ifdef _MSC_VER
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#else
-#define _POSIX_C_SOURCE 199309L
-#include <time.h>
+/* clock_gettime for the high-resolution timer (see MiniMax/timer.h) and POSIX threads for pondering */
+#ifndef _MSC_VER
+#define _POSIX_C_SOURCE 200112L
 #endif
 
 #include <stdio.h>
@@ -28,45 +45,65 @@
 #include "TicTacToe/tic_tac_toe.h"
 #include "MiniMax/mini_max.h"
 #include "MiniMax/transposition.h"
+#include "MiniMax/proof_number.h"
+#include "MiniMax/mcts.h"
+#include "MiniMax/tablebase.h"
+#include "MiniMax/opening_book.h"
+#include "MiniMax/timer.h"
+#include "MiniMax/threading.h"
 
-/* Portable high-resolution timer */
-#ifdef _MSC_VER
-typedef LARGE_INTEGER HiResTimer;
+/*
+ * Maximum transposition table size (entry count).
+ * This caps the allocation when BOARD_SIZE is large.
+ * At 16 bytes per entry: 250M entries = 4 GB memory
+ */
+#define MAX_TRANSPOSITION_TABLE_SIZE 250000000
 
-static int timer_get(HiResTimer *t)
-{
-    return QueryPerformanceCounter(t) ? 0 : -1;
-}
+/* Maximum --pn-memory value in MiB (4 GB, the same as the TT cap) */
+#define MAX_PROOF_NUMBER_MEMORY_MB 4096
 
-static double timer_diff_seconds(const HiResTimer *start, const HiResTimer *end)
-{
-    LARGE_INTEGER freq;
-    if (!QueryPerformanceFrequency(&freq))
-        return -1.0;
-    return (double)(end->QuadPart - start->QuadPart) / (double)freq.QuadPart;
-}
-#else
-typedef struct timespec HiResTimer;
+/* Maximum --mcts-memory value in MiB */
+#define MAX_MCTS_MEMORY_MB 4096
 
-static int timer_get(HiResTimer *t)
-{
-    return clock_gettime(CLOCK_MONOTONIC, t);
-}
+/* Plies of --book-build when --book-plies is not given */
+#define DEFAULT_BOOK_PLIES 4
 
-static double timer_diff_seconds(const HiResTimer *start, const HiResTimer *end)
-{
-    double sec = (double)(end->tv_sec - start->tv_sec);
-    double nsec = (double)(end->tv_nsec - start->tv_nsec);
-    return sec + (nsec / 1e9);
-}
-#endif
+/* Boards up to this size ponder every human reply; larger ones the likeliest few */
+#define PONDER_ALL_REPLIES_MAX_SIZE 5
+#define PONDER_LIKELY_REPLIES 4
+
+/* Node budget of the search that ranks the human's replies before pondering */
+#define PONDER_RANKING_NODES 100000
+
+/* Per-move search budget from --time/--nodes (all zero: full-depth search). */
+static SearchLimits move_limits = {0, 0};
+
+/* --engine mcts: AI moves come from getAiMoveMcts; playouts and time add up for the stats */
+static int use_mcts = 0;
+static uint64_t mcts_playouts = 0;
+static double mcts_seconds = 0.0;
+
+/* --ponder: search during the human's turn in interactive mode */
+static int ponder_enabled = 1;
 
 /*
- * Maximum transposition table size (entry count).
- * This caps the allocation when BOARD_SIZE is large.
- * At 16 bytes per entry: 250M entries = 4 GB memory
+ * Pondering: while the human thinks, a background thread runs the AI's
+ * search on the positions after the human's replies, so the shared
+ * transposition table already holds the answer when the move arrives.
+ * Only the ponder thread searches while it runs; the game loop stops and
+ * joins it before its own search.
  */
-#define MAX_TRANSPOSITION_TABLE_SIZE 250000000
+typedef struct
+{
+    Bitboard board; /* Position with the human to move */
+    char human;
+    char ai;
+    int stop;    /* Atomic: the human has moved */
+    int running; /* A thread was started and not joined yet */
+    ThreadHandle thread;
+} Ponder;
+
+static Ponder ponder;
 
 /* Return non-zero if arg is a recognized CLI option flag. */
 static int isKnownOption(const char *arg)
@@ -79,7 +116,150 @@ static int isKnownOption(const char *arg)
            strcmp(arg, "-q") == 0 ||
            strcmp(arg, "--tt-size") == 0 ||
            strcmp(arg, "-t") == 0 ||
-           strcmp(arg, "--seed") == 0;
+           strcmp(arg, "--seed") == 0 ||
+           strcmp(arg, "--threads") == 0 ||
+           strcmp(arg, "--parallel") == 0 ||
+           strcmp(arg, "--time") == 0 ||
+           strcmp(arg, "--nodes") == 0 ||
+           strcmp(arg, "--search") == 0 ||
+           strcmp(arg, "--engine") == 0 ||
+           strcmp(arg, "--pn-memory") == 0 ||
+           strcmp(arg, "--mcts-memory") == 0 ||
+           strcmp(arg, "--tablebase") == 0 ||
+           strcmp(arg, "--tablebase-build") == 0 ||
+           strcmp(arg, "--book") == 0 ||
+           strcmp(arg, "--book-build") == 0 ||
+           strcmp(arg, "--book-plies") == 0 ||
+           strcmp(arg, "--symmetry") == 0 ||
+           strcmp(arg, "--solution-table") == 0 ||
+           strcmp(arg, "--ponder") == 0;
+}
+
+/* Select the AI move, within move_limits when a budget was given. */
+static void chooseAiMove(Bitboard board, char aiPlayer, int *out_row, int *out_col)
+{
+    if (use_mcts)
+    {
+        MctsResult mcts;
+        getAiMoveMcts(board, aiPlayer, &move_limits, &mcts);
+        mcts_playouts += mcts.playouts;
+        mcts_seconds += mcts.seconds;
+        *out_row = mcts.row;
+        *out_col = mcts.col;
+        return;
+    }
+
+    if (move_limits.max_time_ms == 0 && move_limits.max_nodes == 0)
+    {
+        getAiMove(board, aiPlayer, out_row, out_col);
+        return;
+    }
+
+    SearchResult result;
+    getAiMoveBudgeted(board, aiPlayer, &move_limits, &result);
+    *out_row = result.row;
+    *out_col = result.col;
+}
+
+/*
+ * Return non-zero if reply a is likelier than b: higher score for the human
+ * (skipped moves last), then closer to the center, as on the empty board.
+ */
+static int ponderLikelier(const RootMoveScore *a, const RootMoveScore *b)
+{
+    int score_a = (a->bound == ROOT_SCORE_NOT_SEARCHED) ? INT_MIN : a->score;
+    int score_b = (b->bound == ROOT_SCORE_NOT_SEARCHED) ? INT_MIN : b->score;
+    if (score_a != score_b)
+        return score_a > score_b;
+    int center_a = abs(2 * a->row - (BOARD_SIZE - 1)) + abs(2 * a->col - (BOARD_SIZE - 1));
+    int center_b = abs(2 * b->row - (BOARD_SIZE - 1)) + abs(2 * b->col - (BOARD_SIZE - 1));
+    return center_a < center_b;
+}
+
+/*
+ * Ponder thread: rank the human's replies with a short budgeted search for
+ * the human, then run the AI's search on each reply, likeliest first.
+ */
+THREAD_FUNC(ponderMain, arg)
+{
+    Ponder *p = (Ponder *)arg;
+    int row, col;
+
+    RootMoveScore replies[MAX_MOVES];
+    SearchLimits ranking = {0, PONDER_RANKING_NODES};
+    SearchResult ranked;
+    getAiMoveBudgeted(p->board, p->human, &ranking, &ranked);
+    int count = getRootMoveScores(replies, MAX_MOVES);
+    if (count == 0)
+    {
+        /* Empty board or book position: every empty cell */
+        for (int cell = 0; cell < MAX_MOVES; cell++)
+        {
+            if (bitboard_is_empty(p->board, BIT_TO_ROW(cell), BIT_TO_COL(cell)))
+            {
+                replies[count].row = BIT_TO_ROW(cell);
+                replies[count].col = BIT_TO_COL(cell);
+                replies[count].bound = ROOT_SCORE_EXACT;
+                replies[count].score = 0;
+                count++;
+            }
+        }
+    }
+
+    /* Insertion sort, likeliest reply first */
+    for (int i = 1; i < count; i++)
+    {
+        RootMoveScore reply = replies[i];
+        int j = i;
+        while (j > 0 && ponderLikelier(&reply, &replies[j - 1]))
+        {
+            replies[j] = replies[j - 1];
+            j--;
+        }
+        replies[j] = reply;
+    }
+
+    if (BOARD_SIZE > PONDER_ALL_REPLIES_MAX_SIZE && count > PONDER_LIKELY_REPLIES)
+        count = PONDER_LIKELY_REPLIES;
+    for (int i = 0; i < count && !atomic_load_int(&p->stop); i++)
+    {
+        Bitboard next = p->board;
+        bitboard_make_move(&next, replies[i].row, replies[i].col, p->human);
+        chooseAiMove(next, p->ai, &row, &col);
+    }
+    THREAD_RETURN;
+}
+
+/*
+ * Start pondering on board with the human to move. Does nothing with
+ * --ponder off, with --engine mcts (its tree is not kept between moves) or
+ * with a tablebase or the 3x3 solution table (the answer costs no search).
+ */
+static void ponderStart(Bitboard board)
+{
+    if (!ponder_enabled || use_mcts || tablebase_is_open() || (SOLUTION_TABLE_SUPPORTED && getSolutionTable()))
+        return;
+
+    ponder.board = board;
+    ponder.human = human_symbol;
+    ponder.ai = ai_symbol;
+    atomic_store_int(&ponder.stop, 0);
+    /* Thread creation failure only costs the head start, never correctness */
+    ponder.running = thread_create(&ponder.thread, ponderMain, &ponder) == 0;
+}
+
+/* Stop and join the ponder thread, if one runs. */
+static void ponderStop(void)
+{
+    if (!ponder.running)
+        return;
+
+    atomic_store_int(&ponder.stop, 1);
+    requestSearchStop();
+    thread_join(ponder.thread);
+    /* The thread may have finished its last search before the request */
+    cancelSearchStop();
+    ponder.running = 0;
 }
 
 /*
@@ -101,7 +281,10 @@ static void playGame(void)
 
             if (player_turn == human_symbol)
             {
-                if (getMove(&row, &col) == -1)
+                ponderStart(board_state);
+                int eof = getMove(&row, &col) == -1;
+                ponderStop();
+                if (eof)
                 {
                     printf("\nEOF received. Exiting game.\n");
                     return; /* Clean exit on EOF */
@@ -119,7 +302,7 @@ static void playGame(void)
             else
             {
                 int ai_row, ai_col;
-                getAiMove(board_state, ai_symbol, &ai_row, &ai_col);
+                chooseAiMove(board_state, ai_symbol, &ai_row, &ai_col);
 
                 /* Defensive: getAiMove returns (-1, -1) for terminal positions */
                 if (ai_row == -1 || ai_col == -1)
@@ -149,10 +332,80 @@ static void playGame(void)
     }
 }
 
+/* Percentage of part in whole, 0 for an empty whole. */
+static double percentOf(uint64_t part, uint64_t whole)
+{
+    return whole ? (100.0 * (double)part) / (double)whole : 0.0;
+}
+
+/* Moves searched per expanded node, 0 if none was expanded. */
+static double branchingFactor(const SearchPlyStats *stats)
+{
+    return stats->expanded ? (double)stats->moves_searched / (double)stats->expanded : 0.0;
+}
+
+/*
+ * Print the search statistics of a self-play run (builds with HP_STATS):
+ * totals, then one line per ply that was searched. When the solution table
+ * answered every move, say so instead.
+ *
+ * Parameters:
+ *  - elapsed: seconds the run took, or a negative value if unknown
+ */
+static void printSearchStats(double elapsed)
+{
+    SearchStats stats;
+    SearchPlyStats total;
+    if (!getSearchStats(&stats))
+        return;
+    searchStatsTotal(&stats, &total);
+    if (total.nodes == 0)
+    {
+        /* On 3x3 the solution table answers every move by default */
+        EngineStats engine_stats;
+        engineGetStats(engineDefault(), &engine_stats);
+        if (engine_stats.solution_table_hits > 0)
+        {
+            printf("  Search statistics\n");
+            printf("    No search ran: %llu moves came from the solution table\n",
+                   (unsigned long long)engine_stats.solution_table_hits);
+            printf("    (use --solution-table off to search them)\n");
+            printf("\n");
+        }
+        return;
+    }
+
+    printf("  Search statistics\n");
+    printf("    Nodes:       %12llu\n", (unsigned long long)total.nodes);
+    if (elapsed > 0)
+        printf("    Nodes/s:     %12.2f M\n", (double)total.nodes / elapsed / 1000000.0);
+    printf("    Terminal:    %12.1f%%\n", percentOf(total.terminal, total.nodes));
+    printf("    EBF:         %12.2f\n", branchingFactor(&total));
+    printf("    TT hits:     %12.1f%%  (usable %.1f%% of probes)\n", percentOf(total.tt_hits, total.tt_probes),
+           percentOf(total.tt_cutoffs, total.tt_probes));
+    printf("    TT stores:   %12llu  (%.1f%% overwrites)\n", (unsigned long long)total.tt_stores,
+           percentOf(total.tt_overwrites, total.tt_stores));
+    printf("    Cutoffs:     %12llu  (%.1f%% by the first move)\n", (unsigned long long)total.beta_cutoffs,
+           percentOf(total.cutoff_index[0], total.beta_cutoffs));
+    printf("    Fail-lows:   %12llu\n", (unsigned long long)total.fail_lows);
+    printf("\n");
+    printf("    Ply        Nodes     EBF  TT hit  First cut\n");
+    for (int p = 0; p <= MAX_MOVES; p++)
+    {
+        const SearchPlyStats *ply = &stats.ply[p];
+        if (ply->nodes == 0)
+            continue;
+        printf("    %3d %12llu  %6.2f  %5.1f%%     %5.1f%%\n", p, (unsigned long long)ply->nodes,
+               branchingFactor(ply), percentOf(ply->tt_hits, ply->tt_probes),
+               percentOf(ply->cutoff_index[0], ply->beta_cutoffs));
+    }
+    printf("\n");
+}
+
 /*
  * Self-play mode: runs gameCount AI vs AI games starting from an empty
  * board, alternating turns. Collects win/tie stats and (optionally) prints
- * timing and throughput.
+ * timing, throughput and search statistics.
  *
  * Parameters:
  *  - gameCount: number of games to run
@@ -166,6 +419,7 @@ static int selfPlay(int gameCount, int quiet)
     HiResTimer startTime = {0};
     int timing_available = 0;
 
+    resetSearchStats();
     if (!quiet)
     {
         if (timer_get(&startTime) != 0)
@@ -189,7 +443,7 @@ static int selfPlay(int gameCount, int quiet)
             int currentCol = -1;
             char currentPlayer = player_turn;
 
-            getAiMove(board_state, currentPlayer, &currentRow, &currentCol);
+            chooseAiMove(board_state, currentPlayer, &currentRow, &currentCol);
 
             /* Defensive: getAiMove returns (-1, -1) for terminal positions */
             if (currentRow == -1 || currentCol == -1)
@@ -263,6 +517,23 @@ static int selfPlay(int gameCount, int quiet)
         printf("    Ties:    %8d  (%5.1f%%)\n", ties, tie_pct);
         printf("\n");
 
+        if (tablebase_is_open() || (SOLUTION_TABLE_SUPPORTED && getSolutionTable()))
+        {
+            EngineStats stats;
+            engineGetStats(engineDefault(), &stats);
+            printf("  Tables\n");
+            printf("    Tablebase hits:       %8llu\n", (unsigned long long)stats.tablebase_hits);
+            printf("    Solution table hits:  %8llu\n", (unsigned long long)stats.solution_table_hits);
+            printf("\n");
+        }
+
+        if (opening_book_is_open())
+        {
+            printf("  Opening book\n");
+            printf("    Hits:    %8llu\n", (unsigned long long)opening_book_hits());
+            printf("\n");
+        }
+
         /* Print performance stats (only if timing available) */
         if (timing_available)
         {
@@ -274,9 +545,20 @@ static int selfPlay(int gameCount, int quiet)
                 printf("    Throughput:  %8.2f K games/s\n", throughput / 1000.0);
             else
                 printf("    Throughput:  %8.1f games/s\n", throughput);
+            if (use_mcts && mcts_seconds > 0)
+            {
+                double playout_rate = (double)mcts_playouts / mcts_seconds;
+                printf("    Playouts:    %8llu\n", (unsigned long long)mcts_playouts);
+                if (playout_rate >= 1000000.0)
+                    printf("    Playouts/s:  %8.2f M\n", playout_rate / 1000000.0);
+                else
+                    printf("    Playouts/s:  %8.2f K\n", playout_rate / 1000.0);
+            }
             printf("\n");
         }
 
+        printSearchStats(timing_available ? elapsed : -1.0);
+
         printf("===============================================================\n");
         printf("\n");
     }
@@ -300,14 +582,49 @@ int main(int argc, char **argv)
             printf("Play Tic-Tac-Toe against a perfect minimax AI or run self-play simulations.\n\n");
             printf("OPTIONS:\n");
             printf("  Interactive Mode (default):\n");
-            printf("    Start an interactive game against the AI.\n\n");
+            printf("    Start an interactive game against the AI.\n");
+            printf("    --ponder on|off           Search the likely replies while you think\n");
+            printf("                              (default: on)\n\n");
             printf("  Self-Play Mode:\n");
             printf("    --selfplay, -s [GAMES]    Run self-play simulations (default: 1000 games)\n");
             printf("    --quiet, -q               Suppress output\n\n");
             printf("  Configuration:\n");
             printf("    --tt-size SIZE, -t SIZE   Transposition table size in entries\n");
             printf("                              (0 disables TT, default: auto-sized, max: %d)\n", MAX_TRANSPOSITION_TABLE_SIZE);
-            printf("    --seed SEED               PRNG seed for Zobrist keys (default: deterministic)\n\n");
+            printf("    --seed SEED               PRNG seed for Zobrist keys (default: deterministic)\n");
+            printf("    --threads N               Search threads (default: 1, max: %d)\n", MAX_SEARCH_THREADS);
+            printf("    --parallel MODE           Parallel search: lazy (Lazy SMP, default) or\n");
+            printf("                              ybwc (Young Brothers Wait tree splitting) or\n");
+            printf("                              root (root moves split across threads)\n");
+            printf("    --search ALGO             Minimax windows: ab (alpha-beta) or pvs\n");
+            printf("                              (Principal Variation Search)\n");
+            printf("    --engine NAME             Root search: minimax (full window), solver\n");
+            printf("                              (win/tie null-window probes;\n");
+            printf("                              default: %s), dfpn (proof-number search) or\n",
+                   BOARD_SIZE >= 5 ? "solver" : "minimax");
+            printf("                              mcts (Monte Carlo Tree Search, anytime)\n");
+            printf("    --pn-memory MB            Proof-number table cap for dfpn (default: %d)\n",
+                   (int)(PROOF_NUMBER_DEFAULT_MEMORY >> 20));
+            printf("    --mcts-memory MB          Search tree cap for mcts (default: %d)\n",
+                   (int)(MCTS_DEFAULT_MEMORY >> 20));
+            printf("    --tablebase-build FILE    Solve every position into FILE and exit\n");
+            printf("                              (3x3 and 4x4; uses --threads)\n");
+            printf("    --tablebase FILE          Answer AI moves from a table built with\n");
+            printf("                              --tablebase-build (memory-mapped)\n");
+            printf("    --book-build FILE         Search every position of the first plies into\n");
+            printf("                              FILE and exit (within --time/--nodes if given)\n");
+            printf("    --book-plies N            Plies of --book-build (default: %d, max: %d)\n",
+                   DEFAULT_BOOK_PLIES, OPENING_BOOK_MAX_PLIES);
+            printf("    --book FILE               Play book positions without searching\n");
+            printf("    --symmetry on|off         Share transposition table entries between\n");
+            printf("                              rotated/reflected positions (default: %s)\n",
+                   BOARD_SIZE <= 4 ? "on" : "off");
+            printf("    --solution-table on|off   Answer 3x3 moves from a table built on first use\n");
+            printf("                              instead of searching (3x3 only, default: on)\n");
+            printf("    --time MS                 Time budget per AI move in milliseconds\n");
+            printf("    --nodes N                 Node budget per AI move (playouts with mcts)\n");
+            printf("                              (iterative deepening; default: search to game end,\n");
+            printf("                              %d playouts with mcts)\n\n", MCTS_DEFAULT_PLAYOUTS);
             printf("  Help:\n");
             printf("    --help, -h                Show this help message and exit\n\n");
             printf("EXAMPLES:\n");
@@ -316,6 +633,17 @@ int main(int argc, char **argv)
             printf("  ttt --selfplay 10000 -q      # Run 10000 games, quiet output\n");
             printf("  ttt --seed 42 -s 1000        # Deterministic game with seed 42\n");
             printf("  ttt --tt-size 0 -s 1000      # Benchmark without transposition table\n");
+            printf("  ttt --threads 8 -s 10        # Self-play with 8 search threads\n");
+            printf("  ttt --threads 8 --parallel ybwc -s 10\n");
+            printf("  ttt --search pvs -s 10       # Benchmark PVS against the default\n");
+            printf("  ttt --engine solver -s 10    # Outcome-only solver\n");
+            printf("  ttt --engine dfpn -s 10      # Proof-number search\n");
+            printf("  ttt --engine mcts --time 100 -s 10\n");
+            printf("  ttt --tablebase-build ttt.tb # Solve the board once\n");
+            printf("  ttt --tablebase ttt.tb -s 10 # Self-play from the table\n");
+            printf("  ttt --book-build book.bin --book-plies 3\n");
+            printf("  ttt --book book.bin -s 10    # Self-play with the opening book\n");
+            printf("  ttt --time 100 -s 10         # 100 ms per move (large boards)\n");
             return 0;
         }
     }
@@ -327,7 +655,15 @@ int main(int argc, char **argv)
 
         if (strcmp(arg, "--seed") == 0 || strcmp(arg, "--tt-size") == 0 ||
             strcmp(arg, "-t") == 0 || strcmp(arg, "--selfplay") == 0 ||
-            strcmp(arg, "-s") == 0)
+            strcmp(arg, "-s") == 0 || strcmp(arg, "--threads") == 0 ||
+            strcmp(arg, "--parallel") == 0 || strcmp(arg, "--time") == 0 ||
+            strcmp(arg, "--nodes") == 0 || strcmp(arg, "--search") == 0 ||
+            strcmp(arg, "--engine") == 0 || strcmp(arg, "--symmetry") == 0 ||
+            strcmp(arg, "--pn-memory") == 0 || strcmp(arg, "--mcts-memory") == 0 ||
+            strcmp(arg, "--tablebase") == 0 || strcmp(arg, "--tablebase-build") == 0 ||
+            strcmp(arg, "--book") == 0 || strcmp(arg, "--book-build") == 0 ||
+            strcmp(arg, "--book-plies") == 0 || strcmp(arg, "--ponder") == 0 ||
+            strcmp(arg, "--solution-table") == 0)
         {
             if (i + 1 < argc)
             {
@@ -489,8 +825,366 @@ int main(int argc, char **argv)
 
     transposition_table_init(transposition_table_size);
 
+    /* Parse --threads flag (Lazy SMP thread count) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0)
+        {
+            char *endptr;
+            errno = 0;
+            long val = (i + 1 < argc) ? strtol(argv[i + 1], &endptr, 10) : 0;
+            if (i + 1 >= argc || endptr == argv[i + 1] || *endptr != '\0' ||
+                errno == ERANGE || val < 1 || val > MAX_SEARCH_THREADS)
+            {
+                fprintf(stderr, "Error: --threads requires a value from 1 to %d\n", MAX_SEARCH_THREADS);
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            setSearchThreads((int)val);
+            break;
+        }
+    }
+
+    /* Parse --parallel flag (parallel search algorithm) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--parallel") == 0)
+        {
+            const char *mode = (i + 1 < argc) ? argv[i + 1] : "";
+            if (strcmp(mode, "lazy") == 0)
+            {
+                setParallelMode(PARALLEL_LAZY_SMP);
+            }
+            else if (strcmp(mode, "ybwc") == 0)
+            {
+                setParallelMode(PARALLEL_YBWC);
+            }
+            else if (strcmp(mode, "root") == 0)
+            {
+                setParallelMode(PARALLEL_ROOT_SPLIT);
+            }
+            else
+            {
+                fprintf(stderr, "Error: --parallel requires 'lazy', 'ybwc' or 'root'\n");
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --search flag (minimax window strategy) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--search") == 0)
+        {
+            const char *algorithm = (i + 1 < argc) ? argv[i + 1] : "";
+            if (strcmp(algorithm, "ab") == 0)
+            {
+                setSearchAlgorithm(SEARCH_ALPHA_BETA);
+            }
+            else if (strcmp(algorithm, "pvs") == 0)
+            {
+                setSearchAlgorithm(SEARCH_PVS);
+            }
+            else
+            {
+                fprintf(stderr, "Error: --search requires 'ab' or 'pvs'\n");
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --engine flag (root search of getAiMove) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--engine") == 0)
+        {
+            const char *engine = (i + 1 < argc) ? argv[i + 1] : "";
+            if (strcmp(engine, "minimax") == 0)
+            {
+                setSearchEngine(ENGINE_MINIMAX);
+            }
+            else if (strcmp(engine, "solver") == 0)
+            {
+                setSearchEngine(ENGINE_SOLVER);
+            }
+            else if (strcmp(engine, "dfpn") == 0)
+            {
+                setSearchEngine(ENGINE_PROOF_NUMBER);
+            }
+            else if (strcmp(engine, "mcts") == 0)
+            {
+                use_mcts = 1;
+            }
+            else
+            {
+                fprintf(stderr, "Error: --engine requires 'minimax', 'solver', 'dfpn' or 'mcts'\n");
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --symmetry flag (symmetry-canonical transposition table keys) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--symmetry") == 0)
+        {
+            const char *symmetry = (i + 1 < argc) ? argv[i + 1] : "";
+            if (strcmp(symmetry, "on") == 0)
+            {
+                setSymmetricHashing(1);
+            }
+            else if (strcmp(symmetry, "off") == 0)
+            {
+                setSymmetricHashing(0);
+            }
+            else
+            {
+                fprintf(stderr, "Error: --symmetry requires 'on' or 'off'\n");
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --solution-table flag (3x3 moves from the built-in table) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--solution-table") == 0)
+        {
+            const char *value = (i + 1 < argc) ? argv[i + 1] : "";
+            if (strcmp(value, "on") == 0)
+            {
+                setSolutionTable(1);
+            }
+            else if (strcmp(value, "off") == 0)
+            {
+                setSolutionTable(0);
+            }
+            else
+            {
+                fprintf(stderr, "Error: --solution-table requires 'on' or 'off'\n");
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --ponder flag (background search during the human's turn) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ponder") == 0)
+        {
+            const char *value = (i + 1 < argc) ? argv[i + 1] : "";
+            if (strcmp(value, "on") == 0)
+            {
+                ponder_enabled = 1;
+            }
+            else if (strcmp(value, "off") == 0)
+            {
+                ponder_enabled = 0;
+            }
+            else
+            {
+                fprintf(stderr, "Error: --ponder requires 'on' or 'off'\n");
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --time and --nodes flags (per-move search budget) */
+    for (int i = 1; i < argc; i++)
+    {
+        int is_time = strcmp(argv[i], "--time") == 0;
+        if (is_time || strcmp(argv[i], "--nodes") == 0)
+        {
+            char *endptr;
+            errno = 0;
+            long long val = (i + 1 < argc) ? strtoll(argv[i + 1], &endptr, 10) : 0;
+            if (i + 1 >= argc || endptr == argv[i + 1] || *endptr != '\0' ||
+                errno == ERANGE || val < 1 || (is_time && val > LONG_MAX))
+            {
+                fprintf(stderr, "Error: %s requires a positive integer\n", argv[i]);
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            if (is_time)
+                move_limits.max_time_ms = (long)val;
+            else
+                move_limits.max_nodes = (uint64_t)val;
+        }
+    }
+
+    /* Parse --pn-memory flag (proof-number table cap in MiB) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pn-memory") == 0)
+        {
+            char *endptr;
+            errno = 0;
+            long val = (i + 1 < argc) ? strtol(argv[i + 1], &endptr, 10) : 0;
+            if (i + 1 >= argc || endptr == argv[i + 1] || *endptr != '\0' ||
+                errno == ERANGE || val < 1 || val > MAX_PROOF_NUMBER_MEMORY_MB)
+            {
+                fprintf(stderr, "Error: --pn-memory requires a value from 1 to %d (MiB)\n",
+                        MAX_PROOF_NUMBER_MEMORY_MB);
+                transposition_table_free();
+                exit(EXIT_FAILURE);
+            }
+            setProofNumberMemory((size_t)val << 20);
+            break;
+        }
+    }
+
+    /* Parse --mcts-memory flag (MCTS node pool cap in MiB) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--mcts-memory") == 0)
+        {
+            char *endptr;
+            errno = 0;
+            long val = (i + 1 < argc) ? strtol(argv[i + 1], &endptr, 10) : 0;
+            if (i + 1 >= argc || endptr == argv[i + 1] || *endptr != '\0' ||
+                errno == ERANGE || val < 1 || val > MAX_MCTS_MEMORY_MB)
+            {
+                fprintf(stderr, "Error: --mcts-memory requires a value from 1 to %d (MiB)\n",
+                        MAX_MCTS_MEMORY_MB);
+                transposition_table_free();
+                proof_number_table_free();
+                exit(EXIT_FAILURE);
+            }
+            setMctsMemory((size_t)val << 20);
+            break;
+        }
+    }
+
     int ret_code = 0;
 
+    /* Parse --tablebase-build flag (solve the board into a file, then exit) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--tablebase-build") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '-')
+            {
+                fprintf(stderr, "Error: --tablebase-build requires a file name\n");
+                ret_code = EXIT_FAILURE;
+            }
+            else
+            {
+                HiResTimer start, end;
+                int timed = timer_get(&start) == 0;
+                ret_code = tablebase_generate(argv[i + 1], getSearchThreads()) == 0 ? 0 : EXIT_FAILURE;
+                if (ret_code == 0 && timed && timer_get(&end) == 0)
+                    printf("Tablebase written to %s in %.2f s\n", argv[i + 1],
+                           timer_diff_seconds(&start, &end));
+            }
+            transposition_table_free();
+            proof_number_table_free();
+            mcts_tree_free();
+            return ret_code;
+        }
+    }
+
+    /* Parse --tablebase flag (answer AI moves from a memory-mapped table) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--tablebase") == 0)
+        {
+            int missing = i + 1 >= argc || argv[i + 1][0] == '-';
+            if (missing)
+                fprintf(stderr, "Error: --tablebase requires a file name\n");
+            if (missing || tablebase_open(argv[i + 1]) != 0)
+            {
+                transposition_table_free();
+                proof_number_table_free();
+                mcts_tree_free();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
+    /* Parse --book-build and --book-plies flags (search the opening into a file, then exit) */
+    int book_plies = DEFAULT_BOOK_PLIES;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--book-plies") == 0)
+        {
+            char *endptr;
+            errno = 0;
+            long val = (i + 1 < argc) ? strtol(argv[i + 1], &endptr, 10) : 0;
+            if (i + 1 >= argc || endptr == argv[i + 1] || *endptr != '\0' ||
+                errno == ERANGE || val < 1 || val > OPENING_BOOK_MAX_PLIES)
+            {
+                fprintf(stderr, "Error: --book-plies requires a value from 1 to %d\n",
+                        OPENING_BOOK_MAX_PLIES);
+                transposition_table_free();
+                proof_number_table_free();
+                mcts_tree_free();
+                tablebase_close();
+                exit(EXIT_FAILURE);
+            }
+            book_plies = (int)val;
+            break;
+        }
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--book-build") == 0)
+        {
+            if (i + 1 >= argc || argv[i + 1][0] == '-')
+            {
+                fprintf(stderr, "Error: --book-build requires a file name\n");
+                ret_code = EXIT_FAILURE;
+            }
+            else
+            {
+                HiResTimer start, end;
+                int timed = timer_get(&start) == 0;
+                long entries = opening_book_generate(argv[i + 1], book_plies, &move_limits);
+                ret_code = (entries >= 0) ? 0 : EXIT_FAILURE;
+                if (ret_code == 0 && timed && timer_get(&end) == 0)
+                    printf("Opening book written to %s: %ld positions in %.2f s\n", argv[i + 1], entries,
+                           timer_diff_seconds(&start, &end));
+            }
+            transposition_table_free();
+            proof_number_table_free();
+            mcts_tree_free();
+            tablebase_close();
+            return ret_code;
+        }
+    }
+
+    /* Parse --book flag (play book positions from a memory-mapped file) */
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--book") == 0)
+        {
+            int missing = i + 1 >= argc || argv[i + 1][0] == '-';
+            if (missing)
+                fprintf(stderr, "Error: --book requires a file name\n");
+            if (missing || opening_book_open(argv[i + 1]) != 0)
+            {
+                transposition_table_free();
+                proof_number_table_free();
+                mcts_tree_free();
+                tablebase_close();
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+    }
+
     /* Check if --selfplay is present anywhere in argv (order-independent) */
     int selfplay_mode = 0;
     int selfplay_idx = -1;
@@ -527,7 +1221,23 @@ int main(int argc, char **argv)
             }
             else if (!((strcmp(argv[selfplay_idx + 1], "--quiet") == 0 || strcmp(argv[selfplay_idx + 1], "-q") == 0) ||
                        (strcmp(argv[selfplay_idx + 1], "--tt-size") == 0 || strcmp(argv[selfplay_idx + 1], "-t") == 0) ||
-                       strcmp(argv[selfplay_idx + 1], "--seed") == 0))
+                       strcmp(argv[selfplay_idx + 1], "--seed") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--threads") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--parallel") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--time") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--nodes") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--search") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--engine") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--pn-memory") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--mcts-memory") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--tablebase") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--tablebase-build") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--book") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--book-build") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--book-plies") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--symmetry") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--ponder") == 0 ||
+                       strcmp(argv[selfplay_idx + 1], "--solution-table") == 0))
             {
                 /* Not a valid game count and not a recognized flag, warn */
                 fprintf(stderr, "Warning: Invalid --selfplay value '%s', using default %d\n",
@@ -562,7 +1272,11 @@ int main(int argc, char **argv)
         playGame();
     }
 
-    /* Clean up transposition table */
+    /* Clean up transposition and proof-number tables, the MCTS tree, the tablebase and the book */
     transposition_table_free();
+    proof_number_table_free();
+    mcts_tree_free();
+    tablebase_close();
+    opening_book_close();
     return ret_code;
 }
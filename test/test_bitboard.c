@@ -76,9 +76,151 @@ void test_cell_operations(void)
     TEST_ASSERT_EQUAL('o', bitboard_get_cell(board, 1, 1));
 }
 
+// Test threat cells: empty cells that complete a line the player nearly owns
+void test_threat_cells(void)
+{
+    init_win_masks();
+    Bitboard board = {0, 0};
+    uint64_t empty = ~(board.x_pieces | board.o_pieces);
+    TEST_ASSERT_EQUAL_UINT64(0, bitboard_threat_cells(board.x_pieces, empty));
+
+    // Row 0 short of its last cell: that cell is the only threat
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+    {
+        bitboard_make_move(&board, 0, c, 'x');
+    }
+    empty = ~(board.x_pieces | board.o_pieces);
+    uint64_t last = BIT_MASK(0, BOARD_SIZE - 1);
+    TEST_ASSERT_EQUAL_UINT64(last, bitboard_threat_cells(board.x_pieces, empty));
+    TEST_ASSERT_EQUAL_UINT64(0, bitboard_threat_cells(board.o_pieces, empty));
+
+    // Once the opponent takes the cell the line is no longer a threat
+    bitboard_make_move(&board, 0, BOARD_SIZE - 1, 'o');
+    empty = ~(board.x_pieces | board.o_pieces);
+    TEST_ASSERT_EQUAL_UINT64(0, bitboard_threat_cells(board.x_pieces, empty));
+}
+
+// Test live cells: lines holding both symbols drop out, none left means a dead draw
+void test_live_cells(void)
+{
+    init_win_masks();
+    Bitboard board = {0, 0};
+    uint64_t last = BIT_MASK(BOARD_SIZE - 1, BOARD_SIZE - 1);
+    TEST_ASSERT_EQUAL_UINT64(last | (last - 1), bitboard_live_cells(board));
+
+    // Alternate symbols along every row with a shift per row: every row,
+    // column and diagonal holds both, so nothing is live
+    board = (Bitboard){0, 0};
+    for (int r = 0; r < BOARD_SIZE; r++)
+    {
+        for (int c = 0; c < BOARD_SIZE; c++)
+        {
+            int k = (c + (r / 2)) % 2;
+            bitboard_make_move(&board, r, c, k ? 'o' : 'x');
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT64(0, bitboard_live_cells(board));
+}
+
+static void assertLineCountsEqual(const LineCounts *expected, const LineCounts *actual)
+{
+    TEST_ASSERT_EQUAL_MEMORY(expected->count, actual->count, sizeof(expected->count));
+    TEST_ASSERT_EQUAL_UINT32(expected->live, actual->live);
+    TEST_ASSERT_EQUAL_UINT32(expected->threats[0], actual->threats[0]);
+    TEST_ASSERT_EQUAL_UINT32(expected->threats[1], actual->threats[1]);
+    TEST_ASSERT_EQUAL(expected->completed[0], actual->completed[0]);
+    TEST_ASSERT_EQUAL(expected->completed[1], actual->completed[1]);
+}
+
+// Test incremental line counts match a full scan through a whole game and back
+void test_line_counts_incremental(void)
+{
+    init_win_masks();
+    Bitboard board = {0, 0};
+    LineCounts lines, scanned;
+    line_counts_init(&lines, board);
+
+    // Fill the board in a scrambled order (step coprime to MAX_MOVES)
+    int cells[MAX_MOVES];
+    char players[MAX_MOVES];
+    for (int i = 0; i < MAX_MOVES; i++)
+    {
+        cells[i] = (i * 11 + 3) % MAX_MOVES;
+        players[i] = (i % 2) ? 'o' : 'x';
+        int r = BIT_TO_ROW(cells[i]), c = BIT_TO_COL(cells[i]);
+        bitboard_make_move(&board, r, c, players[i]);
+        line_counts_make(&lines, r, c, players[i]);
+
+        line_counts_init(&scanned, board);
+        assertLineCountsEqual(&scanned, &lines);
+        TEST_ASSERT_EQUAL(bitboard_has_won(board.x_pieces), lines.completed[0] > 0);
+        TEST_ASSERT_EQUAL(bitboard_has_won(board.o_pieces), lines.completed[1] > 0);
+
+        uint64_t empty = ~(board.x_pieces | board.o_pieces);
+        TEST_ASSERT_EQUAL_UINT64(bitboard_live_cells(board), line_counts_live_cells(&lines));
+        TEST_ASSERT_EQUAL_UINT64(bitboard_threat_cells(board.x_pieces, empty),
+                                 line_counts_threat_cells(&lines, 'x', board.x_pieces));
+        TEST_ASSERT_EQUAL_UINT64(bitboard_threat_cells(board.o_pieces, empty),
+                                 line_counts_threat_cells(&lines, 'o', board.o_pieces));
+    }
+
+    // Unmake everything: back to the empty board's counts
+    for (int i = MAX_MOVES - 1; i >= 0; i--)
+    {
+        int r = BIT_TO_ROW(cells[i]), c = BIT_TO_COL(cells[i]);
+        bitboard_unmake_move(&board, r, c, players[i]);
+        line_counts_unmake(&lines, r, c, players[i]);
+    }
+    line_counts_init(&scanned, board);
+    assertLineCountsEqual(&scanned, &lines);
+}
+
+// Test board transforms move every cell like the matching rotation/reflection and detect symmetric positions
+void test_board_symmetries(void)
+{
+    init_win_masks();
+    const int n = BOARD_SIZE - 1;
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+    {
+        int r = BIT_TO_ROW(cell), c = BIT_TO_COL(cell);
+        const uint64_t images[BITBOARD_SYMMETRY_COUNT] = {
+            BIT_MASK(r, c), BIT_MASK(c, n - r), BIT_MASK(n - r, n - c), BIT_MASK(n - c, r),
+            BIT_MASK(r, n - c), BIT_MASK(n - r, c), BIT_MASK(c, r), BIT_MASK(n - c, n - r)};
+        for (int s = 0; s < BITBOARD_SYMMETRY_COUNT; s++)
+            TEST_ASSERT_EQUAL_UINT64(images[s], bitboard_transform(1ULL << cell, s));
+    }
+
+    // Empty board: every symmetry; corner, edge and center groups on 3x3
+    Bitboard board = {0, 0};
+    TEST_ASSERT_EQUAL_UINT(0xFF, bitboard_symmetries(board));
+    uint64_t all = ~0ULL >> (64 - MAX_MOVES);
+    uint64_t unique = bitboard_unique_cells(all, bitboard_symmetries(board));
+    if (BOARD_SIZE == 3)
+        TEST_ASSERT_EQUAL_UINT64(BIT_MASK(0, 0) | BIT_MASK(0, 1) | BIT_MASK(1, 1), unique);
+
+    // Corner piece: only the transpose through it remains
+    bitboard_make_move(&board, 0, 0, 'x');
+    TEST_ASSERT_EQUAL_UINT(0x41, bitboard_symmetries(board));
+    unique = bitboard_unique_cells(all & ~board.x_pieces, 0x41);
+    TEST_ASSERT_TRUE(unique & BIT_MASK(0, 1));
+    TEST_ASSERT_FALSE(unique & BIT_MASK(1, 0));
+    int kept = 0;
+    for (uint64_t cells = unique; cells; cells &= cells - 1)
+        kept++;
+    TEST_ASSERT_EQUAL(MAX_MOVES - 1 - BOARD_SIZE * (BOARD_SIZE - 1) / 2, kept);
+
+    // Different symbols on mirrored cells: no symmetry left
+    bitboard_make_move(&board, 0, n, 'o');
+    TEST_ASSERT_EQUAL_UINT(0x01, bitboard_symmetries(board));
+}
+
 void test_bitboard_suite(void)
 {
     RUN_TEST(test_all_win_patterns);
     RUN_TEST(test_make_unmake_symmetry);
     RUN_TEST(test_cell_operations);
+    RUN_TEST(test_threat_cells);
+    RUN_TEST(test_live_cells);
+    RUN_TEST(test_line_counts_incremental);
+    RUN_TEST(test_board_symmetries);
 }
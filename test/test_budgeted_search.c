@@ -0,0 +1,229 @@
+#include "unity/unity.h"
+#include "../src/MiniMax/mini_max.h"
+#include "../src/MiniMax/transposition.h"
+#include "../src/TicTacToe/tic_tac_toe.h"
+
+// Test an unlimited budgeted search proves the same value as getAiMove
+void test_budgeted_unlimited_matches_full_search(void)
+{
+#if BOARD_SIZE <= 4
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+
+    int row, col;
+    getAiMove(board, 'x', &row, &col);
+    RootMoveScore scores[MAX_MOVES];
+    int count = getRootMoveScores(scores, MAX_MOVES);
+    int full_score = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (scores[i].row == row && scores[i].col == col)
+            full_score = scores[i].score;
+    }
+
+    SearchResult result;
+    getAiMoveBudgeted(board, 'x', NULL, &result);
+
+    TEST_ASSERT_EQUAL(1, result.proven);
+    TEST_ASSERT_EQUAL(0, result.aborted);
+    TEST_ASSERT_EQUAL(full_score, result.score);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+    TEST_ASSERT_TRUE(result.depth >= 1);
+
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+// Test the node budget stops the search and still yields a legal move
+void test_budgeted_node_limit(void)
+{
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+
+    SearchLimits limits = {0, 50};
+    SearchResult result;
+    getAiMoveBudgeted(board, 'o', &limits, &result);
+
+    TEST_ASSERT_TRUE(result.nodes <= limits.max_nodes);
+    TEST_ASSERT_TRUE(result.row >= 0 && result.row < BOARD_SIZE);
+    TEST_ASSERT_TRUE(result.col >= 0 && result.col < BOARD_SIZE);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+    TEST_ASSERT_EQUAL(0, result.proven);
+    TEST_ASSERT_EQUAL(1, result.aborted);
+    TEST_ASSERT_TRUE(result.score > -100 && result.score < 100);
+
+    transposition_table_free();
+}
+
+// Test an immediate win is found and flagged as proven within a tiny budget
+void test_budgeted_immediate_win_proven(void)
+{
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    // X owns row 1 except its last cell; O has scattered pieces on row 0
+    Bitboard board = {0, 0};
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+        bitboard_make_move(&board, 1, c, 'x');
+    for (int c = 0; c < BOARD_SIZE - 1; c += 2)
+        bitboard_make_move(&board, 0, c, 'o');
+
+    SearchLimits limits = {0, 10000};
+    SearchResult result;
+    getAiMoveBudgeted(board, 'x', &limits, &result);
+
+    TEST_ASSERT_EQUAL(1, result.proven);
+    TEST_ASSERT_EQUAL(100, result.score);
+    TEST_ASSERT_EQUAL(1, result.row);
+    TEST_ASSERT_EQUAL(BOARD_SIZE - 1, result.col);
+
+    transposition_table_free();
+}
+
+// Test a finished game is reported as proven without a move
+void test_budgeted_terminal_board(void)
+{
+    init_win_masks();
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    for (int c = 0; c < BOARD_SIZE; c++)
+        bitboard_make_move(&board, 0, c, 'o');
+
+    SearchResult result;
+    getAiMoveBudgeted(board, 'x', NULL, &result);
+
+    TEST_ASSERT_EQUAL(-1, result.row);
+    TEST_ASSERT_EQUAL(-1, result.col);
+    TEST_ASSERT_EQUAL(1, result.proven);
+    TEST_ASSERT_EQUAL(-100, result.score);
+}
+
+// Test a time budget completes at least one iteration and returns a legal move
+void test_budgeted_time_limit(void)
+{
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, BOARD_SIZE - 1, BOARD_SIZE - 1, 'o');
+
+    SearchLimits limits = {20, 0};
+    SearchResult result;
+    getAiMoveBudgeted(board, 'x', &limits, &result);
+
+    TEST_ASSERT_TRUE(result.depth >= 1);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+
+    transposition_table_free();
+}
+
+/* Entries in use in an engine's transposition table. */
+static int occupiedEntries(HyperPruneEngine *engine)
+{
+    const TranspositionTable *table = engineTranspositionTable(engine);
+    int count = 0;
+    for (size_t i = 0; i < table->size; i++)
+        count += (table->entries[i].data != 0);
+    return count;
+}
+
+// Test a stop request aborts every kind of search cleanly, once
+void test_stop_request_aborts_search(void)
+{
+    init_win_masks();
+    HyperPruneEngine *engine = engineCreate(4096);
+    TEST_ASSERT_NOT_NULL(engine);
+    engineSetSolutionTable(engine, 0); // Search, even on 3x3
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+
+    static const SearchEngine engines[] = {ENGINE_MINIMAX, ENGINE_SOLVER, ENGINE_PROOF_NUMBER};
+    static const ParallelMode modes[] = {PARALLEL_LAZY_SMP, PARALLEL_YBWC, PARALLEL_ROOT_SPLIT};
+    for (int k = 0; k < 6; k++)
+    {
+        engineSetSearchEngine(engine, (k < 3) ? engines[k] : ENGINE_MINIMAX);
+        engineSetParallelMode(engine, (k < 3) ? PARALLEL_LAZY_SMP : modes[k - 3]);
+        engineSetSearchThreads(engine, (k < 3) ? 1 : 3);
+
+        // Stopped before it starts: a legal move, no table entries, no root scores
+        int row, col;
+        engineRequestStop(engine);
+        TEST_ASSERT_NOT_EQUAL(0, engineGetAiMove(engine, board, 'o', &row, &col));
+        TEST_ASSERT_TRUE(bitboard_is_empty(board, row, col));
+        TEST_ASSERT_EQUAL(0, occupiedEntries(engine));
+        RootMoveScore scores[MAX_MOVES];
+        int count = engineGetRootMoveScores(engine, scores, MAX_MOVES);
+        for (int i = 0; i < count; i++)
+            TEST_ASSERT_EQUAL(ROOT_SCORE_NOT_SEARCHED, scores[i].bound);
+    }
+
+    // The request was used up: the next search runs to the end
+    engineSetSearchEngine(engine, ENGINE_MINIMAX);
+    engineSetSearchThreads(engine, 1);
+    int row, col, expected_row, expected_col;
+    TEST_ASSERT_EQUAL(0, engineGetAiMove(engine, board, 'o', &row, &col));
+    transposition_table_init(4096);
+    getAiMove(board, 'o', &expected_row, &expected_col);
+    TEST_ASSERT_EQUAL(expected_row, row);
+    TEST_ASSERT_EQUAL(expected_col, col);
+    transposition_table_free();
+
+    // Budgeted: no iteration finished, aborted with the first legal move
+    SearchResult result;
+    engineRequestStop(engine);
+    engineGetAiMoveBudgeted(engine, board, 'o', NULL, &result);
+    TEST_ASSERT_EQUAL(1, result.aborted);
+    TEST_ASSERT_EQUAL(0, result.proven);
+    TEST_ASSERT_EQUAL(0, result.depth);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+
+    // Batch: every searched position is aborted, unsearched ones are not
+    Bitboard boards[2] = {board, {0, 0}};
+    char players[2] = {'o', 'x'};
+    SearchResult results[2];
+    engineRequestStop(engine);
+    engineGetAiMoveBatch(engine, boards, players, 2, results);
+    TEST_ASSERT_EQUAL(1, results[0].aborted);
+    TEST_ASSERT_EQUAL(0, results[0].proven);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, results[0].row, results[0].col));
+    TEST_ASSERT_EQUAL(0, results[1].aborted);
+    engineGetAiMoveBatch(engine, boards, players, 1, results);
+    TEST_ASSERT_EQUAL(0, results[0].aborted);
+    TEST_ASSERT_EQUAL(1, results[0].proven);
+
+    // A withdrawn request does not reach the next search
+    engineRequestStop(engine);
+    engineCancelStop(engine);
+    engineGetAiMoveBudgeted(engine, board, 'o', NULL, &result);
+    TEST_ASSERT_EQUAL(0, result.aborted);
+    TEST_ASSERT_EQUAL(1, result.proven);
+
+    engineDestroy(engine);
+}
+
+void test_budgeted_search_suite(void)
+{
+    RUN_TEST(test_budgeted_unlimited_matches_full_search);
+    RUN_TEST(test_budgeted_node_limit);
+    RUN_TEST(test_budgeted_immediate_win_proven);
+    RUN_TEST(test_budgeted_terminal_board);
+    RUN_TEST(test_budgeted_time_limit);
+    RUN_TEST(test_stop_request_aborts_search);
+}
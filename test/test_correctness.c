@@ -7,6 +7,8 @@
 // Helper: Play a complete game
 int play_full_game(char first_player, uint64_t seed)
 {
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
     zobrist_set_seed(seed);
     zobrist_init();
     transposition_table_init(100000);
@@ -33,6 +35,7 @@ int play_full_game(char first_player, uint64_t seed)
         if (bitboard_did_last_move_win(pieces, row, col))
         {
             transposition_table_free();
+            setSolutionTable(solution);
             return (current == 'x') ? 1 : -1; // 1=X wins, -1=O wins
         }
 
@@ -40,6 +43,7 @@ int play_full_game(char first_player, uint64_t seed)
     }
 
     transposition_table_free();
+    setSolutionTable(solution);
     return 0; // Tie
 }
 
@@ -130,6 +134,8 @@ void test_optimal_play_o_first(void)
 void test_cross_game_tt_no_reinit(void)
 {
 #if BOARD_SIZE == 3
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
     zobrist_set_seed(17);
     zobrist_init();
     transposition_table_init(100000);
@@ -163,6 +169,7 @@ void test_cross_game_tt_no_reinit(void)
 
     TEST_ASSERT_EQUAL(0, wins);
     transposition_table_free();
+    setSolutionTable(solution);
 #endif
 }
 
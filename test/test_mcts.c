@@ -0,0 +1,270 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "unity/unity.h"
+#include "../src/MiniMax/mini_max.h"
+#include "../src/MiniMax/mcts.h"
+#include "../src/MiniMax/threading.h"
+#include "../src/MiniMax/transposition.h"
+#include "../src/TicTacToe/tic_tac_toe.h"
+
+// Test the playout budget is spent exactly and yields a legal, unproven move
+void test_mcts_playout_limit(void)
+{
+    init_win_masks();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+
+    SearchLimits limits = {0, 2000};
+    MctsResult result;
+    getAiMoveMcts(board, 'o', &limits, &result);
+
+    TEST_ASSERT_EQUAL_UINT64(2000, result.playouts);
+    TEST_ASSERT_TRUE(result.nodes > 1);
+    TEST_ASSERT_TRUE(result.row >= 0 && result.row < BOARD_SIZE);
+    TEST_ASSERT_TRUE(result.col >= 0 && result.col < BOARD_SIZE);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+    TEST_ASSERT_TRUE(result.score > -100 && result.score < 100);
+
+    mcts_tree_free();
+}
+
+// Test one thread with a playout budget always selects the same move
+void test_mcts_deterministic(void)
+{
+    init_win_masks();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 1, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+
+    SearchLimits limits = {0, 5000};
+    MctsResult first, second;
+    getAiMoveMcts(board, 'x', &limits, &first);
+    getAiMoveMcts(board, 'x', &limits, &second);
+
+    TEST_ASSERT_EQUAL(first.row, second.row);
+    TEST_ASSERT_EQUAL(first.col, second.col);
+    TEST_ASSERT_EQUAL(first.score, second.score);
+    TEST_ASSERT_EQUAL_UINT64(first.nodes, second.nodes);
+
+    mcts_tree_free();
+}
+
+// Test wins are taken and single threats blocked without playouts
+void test_mcts_forced_moves(void)
+{
+    init_win_masks();
+
+    // X owns row 1 except its last cell; O has scattered pieces on row 0
+    Bitboard board = {0, 0};
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+        bitboard_make_move(&board, 1, c, 'x');
+    for (int c = 0; c < BOARD_SIZE - 1; c += 2)
+        bitboard_make_move(&board, 0, c, 'o');
+
+    MctsResult result;
+    getAiMoveMcts(board, 'x', NULL, &result);
+    TEST_ASSERT_EQUAL(1, result.row);
+    TEST_ASSERT_EQUAL(BOARD_SIZE - 1, result.col);
+    TEST_ASSERT_EQUAL(100, result.score);
+    TEST_ASSERT_EQUAL(1, result.proven);
+    TEST_ASSERT_EQUAL_UINT64(0, result.playouts);
+
+    getAiMoveMcts(board, 'o', NULL, &result);
+    TEST_ASSERT_EQUAL(1, result.row);
+    TEST_ASSERT_EQUAL(BOARD_SIZE - 1, result.col);
+    TEST_ASSERT_EQUAL_UINT64(0, result.playouts);
+}
+
+// Test terminal and invalid boards return no move and the empty board the center
+void test_mcts_terminal_and_empty(void)
+{
+    init_win_masks();
+
+    Bitboard board = {0, 0};
+    for (int c = 0; c < BOARD_SIZE; c++)
+        bitboard_make_move(&board, 0, c, 'x');
+
+    MctsResult result;
+    getAiMoveMcts(board, 'o', NULL, &result);
+    TEST_ASSERT_EQUAL(-1, result.row);
+    TEST_ASSERT_EQUAL(-1, result.col);
+
+    Bitboard overlap = {1ULL, 1ULL};
+    getAiMoveMcts(overlap, 'x', NULL, &result);
+    TEST_ASSERT_EQUAL(-1, result.row);
+
+    Bitboard empty = {0, 0};
+    getAiMoveMcts(empty, 'x', NULL, &result);
+    TEST_ASSERT_EQUAL(BOARD_SIZE / 2, result.row);
+    TEST_ASSERT_EQUAL(BOARD_SIZE / 2, result.col);
+    TEST_ASSERT_EQUAL_UINT64(0, result.playouts);
+}
+
+// One engineGetAiMoveMcts call on its own thread
+typedef struct
+{
+    HyperPruneEngine *engine;
+    Bitboard board;
+    MctsResult result;
+} EngineMcts;
+
+THREAD_FUNC(engineMctsMain, arg)
+{
+    EngineMcts *call = (EngineMcts *)arg;
+    SearchLimits limits = {0, 5000};
+    engineGetAiMoveMcts(call->engine, call->board, 'x', &limits, &call->result);
+    THREAD_RETURN;
+}
+
+// Test engines run MCTS side by side, each in its own pool, with the default engine's result
+void test_mcts_engines_search_concurrently(void)
+{
+    init_win_masks();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 1, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+
+    SearchLimits limits = {0, 5000};
+    MctsResult expected;
+    getAiMoveMcts(board, 'x', &limits, &expected);
+    mcts_tree_free();
+
+    EngineMcts calls[3];
+    ThreadHandle handles[3];
+    for (int i = 0; i < 3; i++)
+    {
+        calls[i].engine = engineCreate(0);
+        TEST_ASSERT_NOT_NULL(calls[i].engine);
+        calls[i].board = board;
+    }
+    engineSetMctsMemory(calls[2].engine, 4096); // A full pool must not spill into another engine's
+    TEST_ASSERT_EQUAL(4096, engineGetMctsMemory(calls[2].engine));
+    TEST_ASSERT_EQUAL(MCTS_DEFAULT_MEMORY, engineGetMctsMemory(calls[0].engine));
+
+    for (int i = 0; i < 3; i++)
+        TEST_ASSERT_EQUAL(0, thread_create(&handles[i], engineMctsMain, &calls[i]));
+    for (int i = 0; i < 3; i++)
+        thread_join(handles[i]);
+
+    for (int i = 0; i < 2; i++)
+    {
+        TEST_ASSERT_EQUAL(expected.row, calls[i].result.row);
+        TEST_ASSERT_EQUAL(expected.col, calls[i].result.col);
+        TEST_ASSERT_EQUAL(expected.score, calls[i].result.score);
+        TEST_ASSERT_EQUAL_UINT64(expected.nodes, calls[i].result.nodes);
+    }
+    TEST_ASSERT_EQUAL_UINT64(5000, calls[2].result.playouts);
+    TEST_ASSERT_TRUE(calls[2].result.nodes <= 4096 / 24);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, calls[2].result.row, calls[2].result.col));
+
+    for (int i = 0; i < 3; i++)
+        engineDestroy(calls[i].engine);
+}
+
+// Test several threads on a pool too small to grow still spend the budget on legal moves
+void test_mcts_threads_small_tree(void)
+{
+    init_win_masks();
+    int original = getSearchThreads();
+    size_t memory = getMctsMemory();
+    setSearchThreads(4);
+    setMctsMemory(4096);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+
+    SearchLimits limits = {0, 3000};
+    MctsResult result;
+    getAiMoveMcts(board, 'o', &limits, &result);
+
+    TEST_ASSERT_EQUAL_UINT64(3000, result.playouts);
+    TEST_ASSERT_TRUE(result.nodes <= 4096 / 24);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+
+    setMctsMemory(memory);
+    mcts_tree_free();
+    setSearchThreads(original);
+}
+
+// Test the time budget stops the search
+void test_mcts_time_limit(void)
+{
+    init_win_masks();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+
+    SearchLimits limits = {20, 0};
+    MctsResult result;
+    getAiMoveMcts(board, 'o', &limits, &result);
+
+    TEST_ASSERT_TRUE(result.playouts > 0);
+    TEST_ASSERT_TRUE(result.seconds < 5.0);
+    TEST_ASSERT_TRUE(bitboard_is_empty(board, result.row, result.col));
+
+    mcts_tree_free();
+}
+
+// Test MCTS never loses to perfect play on small boards, as either side
+void test_mcts_holds_perfect_play(void)
+{
+#if BOARD_SIZE <= 4
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    SearchLimits limits = {0, 20000};
+    for (int game = 0; game < 2; game++)
+    {
+        char mcts_player = (game == 0) ? 'x' : 'o';
+        Bitboard board = {0, 0};
+        char current = 'x';
+
+        for (int ply = 0; ply < MAX_MOVES; ply++)
+        {
+            int row, col;
+            if (current == mcts_player)
+            {
+                MctsResult result;
+                getAiMoveMcts(board, current, &limits, &result);
+                row = result.row;
+                col = result.col;
+            }
+            else
+            {
+                getAiMove(board, current, &row, &col);
+            }
+            TEST_ASSERT_TRUE(row >= 0);
+
+            bitboard_make_move(&board, row, col, current);
+            uint64_t pieces = (current == 'x') ? board.x_pieces : board.o_pieces;
+            if (bitboard_has_won(pieces))
+            {
+                TEST_ASSERT_EQUAL(mcts_player, current);
+                break;
+            }
+            current = (current == 'x') ? 'o' : 'x';
+        }
+    }
+
+    transposition_table_free();
+    mcts_tree_free();
+#endif
+}
+
+void test_mcts_suite(void)
+{
+    RUN_TEST(test_mcts_playout_limit);
+    RUN_TEST(test_mcts_deterministic);
+    RUN_TEST(test_mcts_forced_moves);
+    RUN_TEST(test_mcts_terminal_and_empty);
+    RUN_TEST(test_mcts_engines_search_concurrently);
+    RUN_TEST(test_mcts_threads_small_tree);
+    RUN_TEST(test_mcts_time_limit);
+    RUN_TEST(test_mcts_holds_perfect_play);
+}
@@ -1,6 +1,7 @@
 #include "unity/unity.h"
 #include "../src/MiniMax/mini_max.h"
 #include "../src/MiniMax/transposition.h"
+#include "../src/MiniMax/proof_number.h"
 #include "../src/TicTacToe/tic_tac_toe.h"
 
 // Test empty board plays center
@@ -134,6 +135,543 @@ void test_terminal_opponent_o_wins(void)
     transposition_table_free();
 }
 
+// Test the search algorithm setting round-trips
+void test_search_algorithm_setting(void)
+{
+    SearchAlgorithm original = getSearchAlgorithm();
+
+    setSearchAlgorithm(SEARCH_PVS);
+    TEST_ASSERT_EQUAL(SEARCH_PVS, getSearchAlgorithm());
+    setSearchAlgorithm(SEARCH_ALPHA_BETA);
+    TEST_ASSERT_EQUAL(SEARCH_ALPHA_BETA, getSearchAlgorithm());
+
+    setSearchAlgorithm(original);
+}
+
+// Test PVS selects the same move as plain alpha-beta along a whole game
+void test_pvs_matches_alpha_beta(void)
+{
+#if BOARD_SIZE <= 4
+    SearchAlgorithm original = getSearchAlgorithm();
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    char current = 'o';
+
+    for (int m = 1; m < MAX_MOVES; m++)
+    {
+        int ab_row, ab_col, pvs_row, pvs_col;
+
+        setSearchAlgorithm(SEARCH_ALPHA_BETA);
+        transposition_table_init(100000);
+        getAiMove(board, current, &ab_row, &ab_col);
+
+        setSearchAlgorithm(SEARCH_PVS);
+        transposition_table_init(100000);
+        getAiMove(board, current, &pvs_row, &pvs_col);
+
+        TEST_ASSERT_EQUAL(ab_row, pvs_row);
+        TEST_ASSERT_EQUAL(ab_col, pvs_col);
+        if (ab_row == -1)
+            break;
+
+        bitboard_make_move(&board, ab_row, ab_col, current);
+        current = (current == 'x') ? 'o' : 'x';
+    }
+
+    transposition_table_free();
+    setSearchAlgorithm(original);
+    setSolutionTable(solution);
+#endif
+}
+
+// Test engine selection round-trips
+void test_search_engine_setting(void)
+{
+    SearchEngine original = getSearchEngine();
+
+    setSearchEngine(ENGINE_SOLVER);
+    TEST_ASSERT_EQUAL(ENGINE_SOLVER, getSearchEngine());
+    setSearchEngine(ENGINE_MINIMAX);
+    TEST_ASSERT_EQUAL(ENGINE_MINIMAX, getSearchEngine());
+    setSearchEngine(ENGINE_PROOF_NUMBER);
+    TEST_ASSERT_EQUAL(ENGINE_PROOF_NUMBER, getSearchEngine());
+
+    setSearchEngine(original);
+}
+
+#if BOARD_SIZE <= 4
+// Score of (row, col) in the last search's root scores
+static int rootScoreOf(int row, int col)
+{
+    RootMoveScore scores[MAX_MOVES];
+    int count = getRootMoveScores(scores, MAX_MOVES);
+    for (int i = 0; i < count; i++)
+    {
+        if (scores[i].row == row && scores[i].col == col)
+            return scores[i].score;
+    }
+    return -1;
+}
+#endif
+
+// Test the outcome-only solver selects the minimax move and value along a whole game
+void test_solver_matches_minimax(void)
+{
+#if BOARD_SIZE <= 4
+    SearchEngine original = getSearchEngine();
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    char current = 'o';
+
+    for (int m = 1; m < MAX_MOVES; m++)
+    {
+        int mm_row, mm_col, solver_row, solver_col;
+
+        setSearchEngine(ENGINE_MINIMAX);
+        transposition_table_init(100000);
+        getAiMove(board, current, &mm_row, &mm_col);
+        int mm_score = rootScoreOf(mm_row, mm_col);
+
+        setSearchEngine(ENGINE_SOLVER);
+        transposition_table_init(100000);
+        getAiMove(board, current, &solver_row, &solver_col);
+
+        TEST_ASSERT_EQUAL(mm_row, solver_row);
+        TEST_ASSERT_EQUAL(mm_col, solver_col);
+        if (mm_row == -1)
+            break;
+        TEST_ASSERT_EQUAL(mm_score, rootScoreOf(solver_row, solver_col));
+
+        bitboard_make_move(&board, mm_row, mm_col, current);
+        current = (current == 'x') ? 'o' : 'x';
+    }
+
+    transposition_table_free();
+    setSearchEngine(original);
+    setSolutionTable(solution);
+#endif
+}
+
+// Test learned killer/history tables never change the selected move
+void test_move_ordering_keeps_moves(void)
+{
+#if BOARD_SIZE <= 4
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    resetMoveOrdering();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 1, 1, 'x');
+    char current = 'o';
+
+    for (int m = 1; m < MAX_MOVES; m++)
+    {
+        int warm_row, warm_col, cold_row, cold_col;
+
+        /* Tables carry over from every earlier search of this game */
+        transposition_table_init(100000);
+        getAiMove(board, current, &warm_row, &warm_col);
+
+        resetMoveOrdering();
+        transposition_table_init(100000);
+        getAiMove(board, current, &cold_row, &cold_col);
+
+        TEST_ASSERT_EQUAL(cold_row, warm_row);
+        TEST_ASSERT_EQUAL(cold_col, warm_col);
+        if (cold_row == -1)
+            break;
+
+        bitboard_make_move(&board, cold_row, cold_col, current);
+        current = (current == 'x') ? 'o' : 'x';
+    }
+
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+// Test a stored root move is searched first without changing which tied move wins
+void test_root_tt_move_keeps_choice(void)
+{
+#if BOARD_SIZE <= 4
+    int symmetric = getSymmetricHashing();
+    int solution = getSolutionTable();
+    setSymmetricHashing(0); // Plain keys: the root entry is found by zobrist_hash
+    setSolutionTable(0);    // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+
+    int row, col;
+    getAiMove(board, 'x', &row, &col);
+
+    // Point the root entry at the last empty cell and search again
+    uint64_t hash = zobrist_hash(board, 'x');
+    int last = POS_TO_BIT(BOARD_SIZE - 1, BOARD_SIZE - 1);
+    TEST_ASSERT_EQUAL(POS_TO_BIT(row, col), transposition_table_best_move(hash));
+    transposition_table_store_move(hash, 0, 0, TRANSPOSITION_TABLE_EXACT, last);
+
+    int again_row, again_col;
+    getAiMove(board, 'x', &again_row, &again_col);
+    TEST_ASSERT_EQUAL(row, again_row);
+    TEST_ASSERT_EQUAL(col, again_col);
+
+    transposition_table_free();
+    setSymmetricHashing(symmetric);
+    setSolutionTable(solution);
+#endif
+}
+
+// Test a forced block is played and an unstoppable double threat scores as a loss
+void test_threats_force_block_and_loss(void)
+{
+#if BOARD_SIZE == 3
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(10000);
+
+    // X threatens (0,2); O must block
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+    bitboard_make_move(&board, 0, 1, 'x');
+
+    int row, col;
+    getAiMove(board, 'o', &row, &col);
+    TEST_ASSERT_EQUAL(0, row);
+    TEST_ASSERT_EQUAL(2, col);
+
+    // X threatens (0,2) and (2,0); O cannot stop both
+    board = (Bitboard){0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+    bitboard_make_move(&board, 0, 1, 'x');
+    bitboard_make_move(&board, 1, 2, 'o');
+    bitboard_make_move(&board, 1, 0, 'x');
+
+    getAiMove(board, 'o', &row, &col);
+    RootMoveScore scores[MAX_MOVES];
+    int count = getRootMoveScores(scores, MAX_MOVES);
+    TEST_ASSERT_EQUAL(4, count);
+    for (int i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(-100, scores[i].score);
+    }
+
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+// Test a position where every line holds both symbols is scored as a tie before the board fills
+void test_dead_lines_score_tie(void)
+{
+#if BOARD_SIZE >= 4
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(10000);
+
+    // Shifted alternating pattern on all but the last two cells
+    Bitboard board = {0, 0};
+    for (int cell = 0; cell < MAX_MOVES - 2; cell++)
+    {
+        int r = BIT_TO_ROW(cell), c = BIT_TO_COL(cell);
+        bitboard_make_move(&board, r, c, ((c + r / 2) % 2) ? 'o' : 'x');
+    }
+    TEST_ASSERT_EQUAL_UINT64(0, bitboard_live_cells(board));
+
+    int row, col;
+    getAiMove(board, 'x', &row, &col);
+    TEST_ASSERT_EQUAL(BOARD_SIZE - 1, row);
+    TEST_ASSERT_EQUAL(BOARD_SIZE - 2, col);
+
+    RootMoveScore scores[MAX_MOVES];
+    int count = getRootMoveScores(scores, MAX_MOVES);
+    TEST_ASSERT_EQUAL(2, count);
+    for (int i = 0; i < count; i++)
+    {
+        TEST_ASSERT_EQUAL(0, scores[i].score);
+    }
+
+    transposition_table_free();
+#endif
+}
+
+// Test a finished position reached by the search is recognized without a transposition table entry
+void test_terminal_nodes_not_stored(void)
+{
+    int symmetric = getSymmetricHashing();
+    setSymmetricHashing(0); // Plain keys: entries are found by zobrist_hash
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(10000);
+
+    // X owns row 1 except its last cell; O has scattered pieces on row 0
+    Bitboard board = {0, 0};
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+        bitboard_make_move(&board, 1, c, 'x');
+    for (int c = 0; c < BOARD_SIZE - 1; c += 2)
+        bitboard_make_move(&board, 0, c, 'o');
+
+    int row, col;
+    getAiMove(board, 'x', &row, &col);
+    TEST_ASSERT_EQUAL(1, row);
+    TEST_ASSERT_EQUAL(BOARD_SIZE - 1, col);
+
+    // The root is stored with its winning move; the won position is not stored
+    TEST_ASSERT_EQUAL(POS_TO_BIT(row, col), transposition_table_best_move(zobrist_hash(board, 'x')));
+    bitboard_make_move(&board, row, col, 'x');
+    int score;
+    TEST_ASSERT_FALSE(transposition_table_probe(zobrist_hash(board, 'o'), -101, 101, &score));
+
+    transposition_table_free();
+    setSymmetricHashing(symmetric);
+    setSolutionTable(solution);
+}
+
+// Test symmetric transposition table keys select the same moves and scores as plain keys
+void test_symmetric_hashing_matches_plain(void)
+{
+#if BOARD_SIZE <= 4
+    int symmetric = getSymmetricHashing();
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 1, 'x');
+    char current = 'o';
+
+    for (int m = 1; m < MAX_MOVES; m++)
+    {
+        int plain_row, plain_col, sym_row, sym_col;
+        RootMoveScore plain[MAX_MOVES], sym[MAX_MOVES];
+
+        setSymmetricHashing(0);
+        transposition_table_init(100000);
+        getAiMove(board, current, &plain_row, &plain_col);
+        int plain_count = getRootMoveScores(plain, MAX_MOVES);
+
+        // Keep the plain entries: both key kinds share one table
+        setSymmetricHashing(1);
+        getAiMove(board, current, &sym_row, &sym_col);
+        int sym_count = getRootMoveScores(sym, MAX_MOVES);
+
+        TEST_ASSERT_EQUAL(plain_row, sym_row);
+        TEST_ASSERT_EQUAL(plain_col, sym_col);
+        TEST_ASSERT_EQUAL(plain_count, sym_count);
+        for (int i = 0; i < plain_count; i++)
+        {
+            if (plain[i].bound == ROOT_SCORE_EXACT && sym[i].bound == ROOT_SCORE_EXACT)
+                TEST_ASSERT_EQUAL(plain[i].score, sym[i].score);
+        }
+        if (plain_row == -1)
+            break;
+
+        bitboard_make_move(&board, plain_row, plain_col, current);
+        current = (current == 'x') ? 'o' : 'x';
+    }
+
+    transposition_table_free();
+    setSymmetricHashing(symmetric);
+    setSolutionTable(solution);
+#endif
+}
+
+// Test a symmetric root searches one move per group but still reports a score for every move
+void test_symmetric_root_scores(void)
+{
+#if BOARD_SIZE <= 4
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    // Corner piece: the board is symmetric about the main diagonal
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+
+    int row, col;
+    getAiMove(board, 'o', &row, &col);
+    TEST_ASSERT_TRUE(row <= col); // First best move comes from the kept half
+
+    RootMoveScore scores[MAX_MOVES];
+    int count = getRootMoveScores(scores, MAX_MOVES);
+    TEST_ASSERT_EQUAL(MAX_MOVES - 1, count);
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < count; j++)
+        {
+            if (scores[j].row == scores[i].col && scores[j].col == scores[i].row)
+            {
+                TEST_ASSERT_EQUAL(scores[i].score, scores[j].score);
+                TEST_ASSERT_EQUAL(scores[i].bound, scores[j].bound);
+            }
+        }
+    }
+
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+// Test proof-number search proves the minimax value and plays a move of that value
+void test_proof_number_matches_minimax(void)
+{
+#if BOARD_SIZE <= 4
+    SearchEngine original = getSearchEngine();
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    char current = 'o';
+
+    for (int m = 1; m < MAX_MOVES; m++)
+    {
+        int mm_row, mm_col, pn_row, pn_col, pn_score;
+
+        setSearchEngine(ENGINE_MINIMAX);
+        transposition_table_init(100000);
+        getAiMove(board, current, &mm_row, &mm_col);
+        // The last empty cell is played without a search (no root scores)
+        if (mm_row == -1 || getRootMoveScores(NULL, 0) == 0)
+            break;
+        int mm_score = rootScoreOf(mm_row, mm_col);
+
+        TEST_ASSERT_EQUAL(1, proof_number_solve(board, current, 0, &pn_score));
+        TEST_ASSERT_EQUAL(mm_score, pn_score);
+
+        setSearchEngine(ENGINE_PROOF_NUMBER);
+        getAiMove(board, current, &pn_row, &pn_col);
+        TEST_ASSERT_NOT_EQUAL(-1, pn_row);
+        TEST_ASSERT_TRUE(bitboard_is_empty(board, pn_row, pn_col));
+        TEST_ASSERT_EQUAL(mm_score, rootScoreOf(pn_row, pn_col));
+
+        bitboard_make_move(&board, mm_row, mm_col, current);
+        current = (current == 'x') ? 'o' : 'x';
+    }
+
+    transposition_table_free();
+    proof_number_table_free();
+    setSearchEngine(original);
+    setSolutionTable(solution);
+#endif
+}
+
+// Test a node budget stops the proof search and a tiny table still proves values
+void test_proof_number_budget_and_memory(void)
+{
+    init_win_masks();
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    int score = 12345;
+    TEST_ASSERT_EQUAL(0, proof_number_solve(board, 'x', 1, &score));
+    TEST_ASSERT_EQUAL(12345, score);
+
+    // x to move completes the top row
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+    {
+        bitboard_make_move(&board, 0, c, 'x');
+        bitboard_make_move(&board, 1, c, 'o');
+    }
+    size_t memory = getProofNumberMemory();
+    setProofNumberMemory(1024);
+    TEST_ASSERT_EQUAL(1024, getProofNumberMemory());
+    TEST_ASSERT_EQUAL(1, proof_number_solve(board, 'x', 0, &score));
+    TEST_ASSERT_EQUAL(100, score);
+
+#if BOARD_SIZE == 3
+    // Empty 3x3 is a draw, even when the table holds only a few dozen entries
+    Bitboard empty = {0, 0};
+    TEST_ASSERT_EQUAL(1, proof_number_solve(empty, 'x', 0, &score));
+    TEST_ASSERT_EQUAL(0, score);
+#endif
+
+    setProofNumberMemory(memory);
+    proof_number_table_free();
+}
+
+// Test search statistics add up when built in (make STATS=1) and stay zero otherwise
+void test_search_stats(void)
+{
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(10000);
+    resetSearchStats();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    int row, col;
+    getAiMove(board, 'o', &row, &col);
+
+    SearchStats stats;
+    SearchPlyStats total;
+    int collected = getSearchStats(&stats);
+    searchStatsTotal(&stats, &total);
+    if (!collected)
+    {
+        TEST_ASSERT_EQUAL_UINT64(0, total.nodes);
+        TEST_ASSERT_EQUAL_UINT64(0, total.tt_probes);
+        transposition_table_free();
+        setSolutionTable(solution);
+        return;
+    }
+
+    // Nodes below the root only; every one is terminal, answered by the table or expanded
+    TEST_ASSERT_TRUE(total.nodes > 0);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.ply[0].nodes + stats.ply[1].nodes);
+    for (int p = 0; p <= MAX_MOVES; p++)
+    {
+        const SearchPlyStats *ply = &stats.ply[p];
+        TEST_ASSERT_EQUAL_UINT64(ply->nodes, ply->terminal + ply->tt_cutoffs + ply->expanded);
+        TEST_ASSERT_TRUE(ply->tt_cutoffs <= ply->tt_hits && ply->tt_hits <= ply->tt_probes);
+        TEST_ASSERT_EQUAL_UINT64(ply->expanded, ply->tt_stores);
+        TEST_ASSERT_TRUE(ply->tt_overwrites <= ply->tt_stores);
+        TEST_ASSERT_TRUE(ply->moves_searched >= ply->expanded);
+        TEST_ASSERT_TRUE(ply->beta_cutoffs + ply->fail_lows <= ply->expanded);
+        uint64_t cutoffs = 0;
+        for (int i = 0; i < SEARCH_STATS_CUTOFF_SLOTS; i++)
+            cutoffs += ply->cutoff_index[i];
+        TEST_ASSERT_EQUAL_UINT64(ply->beta_cutoffs, cutoffs);
+    }
+
+    resetSearchStats();
+    getSearchStats(&stats);
+    searchStatsTotal(&stats, &total);
+    TEST_ASSERT_EQUAL_UINT64(0, total.nodes);
+
+    transposition_table_free();
+    setSolutionTable(solution);
+}
+
 void test_minimax_suite(void)
 {
     RUN_TEST(test_empty_board_plays_center);
@@ -142,4 +680,18 @@ void test_minimax_suite(void)
     RUN_TEST(test_terminal_ai_x_wins);
     RUN_TEST(test_terminal_ai_o_wins);
     RUN_TEST(test_terminal_opponent_o_wins);
+    RUN_TEST(test_search_algorithm_setting);
+    RUN_TEST(test_pvs_matches_alpha_beta);
+    RUN_TEST(test_search_engine_setting);
+    RUN_TEST(test_solver_matches_minimax);
+    RUN_TEST(test_move_ordering_keeps_moves);
+    RUN_TEST(test_root_tt_move_keeps_choice);
+    RUN_TEST(test_threats_force_block_and_loss);
+    RUN_TEST(test_dead_lines_score_tie);
+    RUN_TEST(test_terminal_nodes_not_stored);
+    RUN_TEST(test_symmetric_hashing_matches_plain);
+    RUN_TEST(test_symmetric_root_scores);
+    RUN_TEST(test_proof_number_matches_minimax);
+    RUN_TEST(test_proof_number_budget_and_memory);
+    RUN_TEST(test_search_stats);
 }
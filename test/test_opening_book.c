@@ -0,0 +1,161 @@
+#include "unity/unity.h"
+#include <stdio.h>
+#include "../src/MiniMax/mini_max.h"
+#include "../src/MiniMax/opening_book.h"
+#include "../src/MiniMax/transposition.h"
+#include "../src/TicTacToe/tic_tac_toe.h"
+
+#define OPENING_BOOK_TEST_FILE "test_opening_book.bin"
+
+#if BOARD_SIZE <= 4
+/* Cell index of a single-cell mask. */
+static int bookTestCell(uint64_t mask)
+{
+    int cell = 0;
+    while (!(mask & 1ULL))
+    {
+        mask >>= 1;
+        cell++;
+    }
+    return cell;
+}
+#endif
+
+// Test a two-ply book maps its move into every orientation of a position
+void test_opening_book_probe_symmetries(void)
+{
+#if BOARD_SIZE <= 4
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    long entries = opening_book_generate(OPENING_BOOK_TEST_FILE, 2, NULL);
+    TEST_ASSERT_TRUE(entries > 0);
+    TEST_ASSERT_EQUAL(0, opening_book_open(OPENING_BOOK_TEST_FILE));
+
+    SearchResult result;
+    Bitboard empty = {0, 0};
+    TEST_ASSERT_EQUAL(0, opening_book_probe(empty, &result));
+
+    // No symmetry maps this position onto itself
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 0, 1, 'o');
+    TEST_ASSERT_EQUAL(1, opening_book_probe(board, &result));
+    TEST_ASSERT_EQUAL(1, result.proven);
+    TEST_ASSERT_EQUAL_UINT64(0, result.nodes);
+    uint64_t move = BIT_MASK(result.row, result.col);
+
+    for (int s = 1; s < BITBOARD_SYMMETRY_COUNT; s++)
+    {
+        Bitboard mapped = {bitboard_transform(board.x_pieces, s), bitboard_transform(board.o_pieces, s)};
+        SearchResult mapped_result;
+        TEST_ASSERT_EQUAL(1, opening_book_probe(mapped, &mapped_result));
+        int cell = bookTestCell(bitboard_transform(move, s));
+        TEST_ASSERT_EQUAL(BIT_TO_ROW(cell), mapped_result.row);
+        TEST_ASSERT_EQUAL(BIT_TO_COL(cell), mapped_result.col);
+        TEST_ASSERT_EQUAL(result.score, mapped_result.score);
+    }
+
+    opening_book_close();
+    TEST_ASSERT_FALSE(opening_book_is_open());
+    TEST_ASSERT_EQUAL(0, opening_book_probe(board, &result));
+    transposition_table_free();
+#endif
+}
+
+// Test getAiMove plays book moves of the searched value and counts the hits
+void test_opening_book_get_ai_move(void)
+{
+#if BOARD_SIZE <= 4
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+    TEST_ASSERT_EQUAL(0, opening_book_open(OPENING_BOOK_TEST_FILE));
+
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+    {
+        Bitboard board = {0, 0};
+        bitboard_make_move(&board, BIT_TO_ROW(cell), BIT_TO_COL(cell), 'x');
+
+        uint64_t hits = opening_book_hits();
+        int row, col;
+        getAiMove(board, 'o', &row, &col);
+        TEST_ASSERT_EQUAL_UINT64(hits + 1, opening_book_hits());
+        TEST_ASSERT_EQUAL(0, getRootMoveScores(NULL, 0));
+        TEST_ASSERT_TRUE(bitboard_is_empty(board, row, col));
+
+        // The searched score of the book move is the best score
+        SearchResult entry;
+        TEST_ASSERT_EQUAL(1, opening_book_probe(board, &entry));
+        opening_book_close();
+        int search_row, search_col;
+        getAiMove(board, 'o', &search_row, &search_col);
+        RootMoveScore scores[MAX_MOVES];
+        int count = getRootMoveScores(scores, MAX_MOVES);
+        int best = -100;
+        int book_score = -101;
+        for (int i = 0; i < count; i++)
+        {
+            if (scores[i].score > best)
+                best = scores[i].score;
+            if (scores[i].row == row && scores[i].col == col)
+                book_score = scores[i].score;
+        }
+        TEST_ASSERT_EQUAL(best, book_score);
+        TEST_ASSERT_EQUAL(best, entry.score);
+        TEST_ASSERT_EQUAL(0, opening_book_open(OPENING_BOOK_TEST_FILE));
+    }
+
+    // Positions past the book's plies, or with the wrong side to move, are searched
+    Bitboard deep = {0, 0};
+    bitboard_make_move(&deep, 0, 0, 'x');
+    bitboard_make_move(&deep, 1, 1, 'o');
+    bitboard_make_move(&deep, 0, 1, 'x');
+    uint64_t hits = opening_book_hits();
+    int row, col;
+    getAiMove(deep, 'o', &row, &col);
+    Bitboard single = {0, 0};
+    bitboard_make_move(&single, 0, 0, 'x');
+    getAiMove(single, 'x', &row, &col);
+    TEST_ASSERT_EQUAL_UINT64(hits, opening_book_hits());
+
+    // Budgeted searches take the book move too
+    SearchLimits limits = {0, 1000};
+    SearchResult result;
+    getAiMoveBudgeted(single, 'o', &limits, &result);
+    TEST_ASSERT_EQUAL_UINT64(hits + 1, opening_book_hits());
+    TEST_ASSERT_EQUAL(1, result.proven);
+    TEST_ASSERT_EQUAL_UINT64(0, result.nodes);
+
+    opening_book_close();
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+// Test missing and foreign files and out-of-range plies are rejected
+void test_opening_book_rejects_bad_input(void)
+{
+    init_win_masks();
+    TEST_ASSERT_EQUAL(-1, opening_book_open("test_opening_book_missing.bin"));
+    TEST_ASSERT_EQUAL(-1, opening_book_generate(OPENING_BOOK_TEST_FILE, 0, NULL));
+    TEST_ASSERT_EQUAL(-1, opening_book_generate(OPENING_BOOK_TEST_FILE, OPENING_BOOK_MAX_PLIES + 1, NULL));
+
+    FILE *file = fopen(OPENING_BOOK_TEST_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    fputs("not an opening book, but longer than the header", file);
+    fclose(file);
+    TEST_ASSERT_EQUAL(-1, opening_book_open(OPENING_BOOK_TEST_FILE));
+    TEST_ASSERT_FALSE(opening_book_is_open());
+    remove(OPENING_BOOK_TEST_FILE);
+}
+
+void test_opening_book_suite(void)
+{
+    RUN_TEST(test_opening_book_probe_symmetries);
+    RUN_TEST(test_opening_book_get_ai_move);
+    RUN_TEST(test_opening_book_rejects_bad_input);
+}
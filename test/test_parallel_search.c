@@ -0,0 +1,624 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "unity/unity.h"
+#include "../src/MiniMax/mini_max.h"
+#include "../src/MiniMax/threading.h"
+#include "../src/MiniMax/transposition.h"
+#include "../src/TicTacToe/tic_tac_toe.h"
+
+#if BOARD_SIZE <= 4
+// Helper: play one self-play game on engine and record every move.
+// Returns the number of moves played.
+static int play_game(HyperPruneEngine *engine, char first_player, int rows[MAX_MOVES], int cols[MAX_MOVES])
+{
+    Bitboard board = {0, 0};
+    char current = first_player;
+    int moves = 0;
+
+    while (moves < MAX_MOVES)
+    {
+        int row, col;
+        engineGetAiMove(engine, board, current, &row, &col);
+        if (row == -1)
+            break;
+
+        rows[moves] = row;
+        cols[moves] = col;
+        bitboard_make_move(&board, row, col, current);
+        moves++;
+
+        uint64_t pieces = (current == 'x') ? board.x_pieces : board.o_pieces;
+        if (bitboard_did_last_move_win(pieces, row, col))
+            break;
+        current = (current == 'x') ? 'o' : 'x';
+    }
+    return moves;
+}
+
+// Helper: play one self-play game with the current thread setting on the
+// default engine, with a fresh table. Returns the number of moves played.
+static int record_game(char first_player, int rows[MAX_MOVES], int cols[MAX_MOVES])
+{
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    zobrist_set_seed(7);
+    zobrist_init();
+    transposition_table_init(100000);
+    init_win_masks();
+
+    int moves = play_game(engineDefault(), first_player, rows, cols);
+
+    transposition_table_free();
+    setSolutionTable(solution);
+    return moves;
+}
+
+// A self-play game of one engine on its own thread
+typedef struct
+{
+    HyperPruneEngine *engine;
+    int rows[MAX_MOVES];
+    int cols[MAX_MOVES];
+    int moves;
+} EngineGame;
+
+THREAD_FUNC(engineGameMain, arg)
+{
+    EngineGame *game = (EngineGame *)arg;
+    game->moves = play_game(game->engine, 'x', game->rows, game->cols);
+    THREAD_RETURN;
+}
+#endif
+
+// One engineGetAiMove call on its own thread
+typedef struct
+{
+    HyperPruneEngine *engine;
+    Bitboard board;
+    int row;
+    int col;
+    int stopped;
+    int done; /* Atomic */
+} EngineMove;
+
+THREAD_FUNC(engineMoveMain, arg)
+{
+    EngineMove *call = (EngineMove *)arg;
+    call->stopped = engineGetAiMove(call->engine, call->board, 'o', &call->row, &call->col);
+    atomic_store_int(&call->done, 1);
+    THREAD_RETURN;
+}
+
+// Test thread count is clamped to the supported range
+void test_search_threads_clamped(void)
+{
+    setSearchThreads(0);
+    TEST_ASSERT_EQUAL(1, getSearchThreads());
+
+    setSearchThreads(MAX_SEARCH_THREADS + 1);
+    TEST_ASSERT_EQUAL(MAX_SEARCH_THREADS, getSearchThreads());
+
+    setSearchThreads(4);
+    TEST_ASSERT_EQUAL(4, getSearchThreads());
+
+    setSearchThreads(1);
+}
+
+// Test Lazy SMP plays exactly the same game as the sequential search
+void test_lazy_smp_matches_sequential(void)
+{
+#if BOARD_SIZE <= 4
+    int seq_rows[MAX_MOVES], seq_cols[MAX_MOVES];
+    int par_rows[MAX_MOVES], par_cols[MAX_MOVES];
+
+    for (int first = 0; first < 2; first++)
+    {
+        char first_player = (first == 0) ? 'x' : 'o';
+
+        setSearchThreads(1);
+        int seq_moves = record_game(first_player, seq_rows, seq_cols);
+
+        setSearchThreads(4);
+        int par_moves = record_game(first_player, par_rows, par_cols);
+
+        TEST_ASSERT_EQUAL(seq_moves, par_moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(seq_rows, par_rows, seq_moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(seq_cols, par_cols, seq_moves);
+    }
+
+    setSearchThreads(1);
+#endif
+}
+
+// Test YBWC plays exactly the same game as the sequential search for any thread count
+void test_ybwc_matches_sequential(void)
+{
+#if BOARD_SIZE <= 4
+    int seq_rows[MAX_MOVES], seq_cols[MAX_MOVES];
+    int par_rows[MAX_MOVES], par_cols[MAX_MOVES];
+
+    setParallelMode(PARALLEL_YBWC);
+    for (int first = 0; first < 2; first++)
+    {
+        char first_player = (first == 0) ? 'x' : 'o';
+
+        setSearchThreads(1);
+        int seq_moves = record_game(first_player, seq_rows, seq_cols);
+
+        for (int threads = 2; threads <= 5; threads += 3)
+        {
+            setSearchThreads(threads);
+            int par_moves = record_game(first_player, par_rows, par_cols);
+
+            TEST_ASSERT_EQUAL(seq_moves, par_moves);
+            TEST_ASSERT_EQUAL_INT_ARRAY(seq_rows, par_rows, seq_moves);
+            TEST_ASSERT_EQUAL_INT_ARRAY(seq_cols, par_cols, seq_moves);
+        }
+    }
+
+    setParallelMode(PARALLEL_LAZY_SMP);
+    setSearchThreads(1);
+#endif
+}
+
+// Test YBWC picks the same winning root move as the sequential search when
+// several root moves win (later winners must not pre-empt an earlier one)
+void test_ybwc_root_win_matches_sequential(void)
+{
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+
+    // X completes row 1 at its last cell; O threatens row 0
+    Bitboard board = {0, 0};
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+    {
+        bitboard_make_move(&board, 1, c, 'x');
+        bitboard_make_move(&board, 0, c, 'o');
+    }
+
+    int seq_row, seq_col;
+    transposition_table_init(10000);
+    setSearchThreads(1);
+    getAiMove(board, 'x', &seq_row, &seq_col);
+    transposition_table_free();
+
+    int row, col;
+    transposition_table_init(10000);
+    setParallelMode(PARALLEL_YBWC);
+    setSearchThreads(4);
+    getAiMove(board, 'x', &row, &col);
+
+    TEST_ASSERT_EQUAL(seq_row, row);
+    TEST_ASSERT_EQUAL(seq_col, col);
+
+    setParallelMode(PARALLEL_LAZY_SMP);
+    setSearchThreads(1);
+    transposition_table_free();
+    setSolutionTable(solution);
+}
+
+// Test Lazy SMP keeps perfect play on 3x3 when the TT is shared across games
+void test_lazy_smp_perfect_play_3x3(void)
+{
+#if BOARD_SIZE == 3
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    zobrist_set_seed(99);
+    zobrist_init();
+    transposition_table_init(100000);
+    init_win_masks();
+    setSearchThreads(3);
+
+    int wins = 0;
+    for (int g = 0; g < 10; g++)
+    {
+        Bitboard board = {0, 0};
+        char current = (g % 2 == 0) ? 'x' : 'o';
+
+        for (int m = 0; m < MAX_MOVES; m++)
+        {
+            int row, col;
+            getAiMove(board, current, &row, &col);
+            if (row == -1)
+                break;
+
+            bitboard_make_move(&board, row, col, current);
+            uint64_t pieces = (current == 'x') ? board.x_pieces : board.o_pieces;
+            if (bitboard_did_last_move_win(pieces, row, col))
+            {
+                wins++;
+                break;
+            }
+            current = (current == 'x') ? 'o' : 'x';
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, wins);
+    setSearchThreads(1);
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+// Test root splitting plays exactly the same game as the sequential search
+void test_root_split_matches_sequential(void)
+{
+#if BOARD_SIZE <= 4
+    int seq_rows[MAX_MOVES], seq_cols[MAX_MOVES];
+    int par_rows[MAX_MOVES], par_cols[MAX_MOVES];
+
+    setParallelMode(PARALLEL_ROOT_SPLIT);
+    for (int first = 0; first < 2; first++)
+    {
+        char first_player = (first == 0) ? 'x' : 'o';
+
+        setSearchThreads(1);
+        int seq_moves = record_game(first_player, seq_rows, seq_cols);
+
+        setSearchThreads(3);
+        int par_moves = record_game(first_player, par_rows, par_cols);
+
+        TEST_ASSERT_EQUAL(seq_moves, par_moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(seq_rows, par_rows, seq_moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(seq_cols, par_cols, seq_moves);
+    }
+
+    setParallelMode(PARALLEL_LAZY_SMP);
+    setSearchThreads(1);
+#endif
+}
+
+// Test root move scores: one entry per empty cell, the chosen move is exact
+// and no exact score beats it
+void test_root_move_scores_reported(void)
+{
+#if BOARD_SIZE <= 4
+    init_win_masks();
+    zobrist_init();
+
+    // X on (0,0), O on (1,1): a regular mid-game root with many moves
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        transposition_table_init(100000);
+        setParallelMode(mode == 0 ? PARALLEL_LAZY_SMP : PARALLEL_ROOT_SPLIT);
+        setSearchThreads(mode == 0 ? 1 : 4);
+
+        int row, col;
+        getAiMove(board, 'x', &row, &col);
+
+        RootMoveScore scores[MAX_MOVES];
+        int count = getRootMoveScores(scores, MAX_MOVES);
+        TEST_ASSERT_EQUAL(MAX_MOVES - 2, count);
+        TEST_ASSERT_EQUAL(count, getRootMoveScores(NULL, 0));
+
+        int chosen = -1;
+        for (int i = 0; i < count; i++)
+        {
+            if (scores[i].row == row && scores[i].col == col)
+                chosen = i;
+        }
+        TEST_ASSERT_TRUE(chosen >= 0);
+        TEST_ASSERT_EQUAL(ROOT_SCORE_EXACT, scores[chosen].bound);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (scores[i].bound != ROOT_SCORE_NOT_SEARCHED)
+                TEST_ASSERT_TRUE(scores[i].score <= scores[chosen].score);
+        }
+
+        transposition_table_free();
+    }
+
+    setParallelMode(PARALLEL_LAZY_SMP);
+    setSearchThreads(1);
+#endif
+}
+
+// Test batch results match getAiMove for every position of a game, with any
+// thread count, and special boards come back without a search
+void test_batch_matches_get_ai_move(void)
+{
+#if BOARD_SIZE <= 4
+    int rows[MAX_MOVES], cols[MAX_MOVES];
+    setSearchThreads(1);
+    int moves = record_game('x', rows, cols);
+
+    // Every position of the game after the first move, last position first
+    Bitboard boards[MAX_MOVES + 3];
+    char players[MAX_MOVES + 3];
+    Bitboard board = {0, 0};
+    char current = 'x';
+    for (int i = 0; i < moves; i++)
+    {
+        bitboard_make_move(&board, rows[i], cols[i], current);
+        current = (current == 'x') ? 'o' : 'x';
+        boards[moves - 1 - i] = board;
+        players[moves - 1 - i] = current;
+    }
+    int count = moves;
+    Bitboard overlap = {1ULL, 1ULL};
+    Bitboard empty = {0, 0};
+    boards[count] = overlap;
+    players[count++] = 'x';
+    boards[count] = boards[count - 2];
+    players[count++] = '?';
+    boards[count] = empty;
+    players[count++] = 'x';
+
+    zobrist_init();
+    transposition_table_init(100000);
+    SearchResult expected[MAX_MOVES + 3];
+    for (int i = 0; i < count; i++)
+    {
+        expected[i] = (SearchResult){-1, -1, 0, 0, 0, 0, 0};
+        getAiMove(boards[i], players[i], &expected[i].row, &expected[i].col);
+        RootMoveScore scores[MAX_MOVES];
+        int scored = getRootMoveScores(scores, MAX_MOVES);
+        for (int j = 0; j < scored; j++)
+        {
+            if (scores[j].row == expected[i].row && scores[j].col == expected[i].col)
+                expected[i].score = scores[j].score;
+        }
+    }
+    transposition_table_free();
+
+    for (int threads = 1; threads <= 4; threads += 3)
+    {
+        transposition_table_init(100000);
+        setSearchThreads(threads);
+        SearchResult results[MAX_MOVES + 3];
+        getAiMoveBatch(boards, players, count, results);
+
+        // The game's final position is over; a win for the side that just moved
+        TEST_ASSERT_EQUAL(-1, results[0].row);
+        TEST_ASSERT_EQUAL(1, results[0].proven);
+        for (int i = 1; i < moves; i++)
+        {
+            TEST_ASSERT_EQUAL(expected[i].row, results[i].row);
+            TEST_ASSERT_EQUAL(expected[i].col, results[i].col);
+            TEST_ASSERT_EQUAL(expected[i].score, results[i].score);
+            TEST_ASSERT_EQUAL(1, results[i].proven);
+            TEST_ASSERT_EQUAL(MAX_MOVES - (moves - i), results[i].depth);
+        }
+
+        // Invalid board, invalid side to move, empty board
+        TEST_ASSERT_EQUAL(-1, results[moves].row);
+        TEST_ASSERT_EQUAL(0, results[moves].proven);
+        TEST_ASSERT_EQUAL(-1, results[moves + 1].row);
+        TEST_ASSERT_EQUAL(0, results[moves + 1].proven);
+        TEST_ASSERT_EQUAL(BOARD_SIZE / 2, results[moves + 2].row);
+        TEST_ASSERT_EQUAL(BOARD_SIZE / 2, results[moves + 2].col);
+
+        transposition_table_free();
+    }
+
+    setSearchThreads(1);
+#endif
+}
+
+// Test engines with different settings play the default engine's game
+// concurrently, without touching its settings or table
+void test_engines_search_concurrently(void)
+{
+#if BOARD_SIZE <= 4
+    int rows[MAX_MOVES], cols[MAX_MOVES];
+    setSearchThreads(1);
+    int moves = record_game('x', rows, cols);
+
+    EngineGame games[3];
+    for (int i = 0; i < 3; i++)
+    {
+        games[i].engine = engineCreate(100000);
+        TEST_ASSERT_NOT_NULL(games[i].engine);
+        engineSetSolutionTable(games[i].engine, 0); // Search the moves the default engine may read from the 3x3 table
+    }
+    engineSetSearchThreads(games[1].engine, 3);
+    engineSetParallelMode(games[1].engine, PARALLEL_ROOT_SPLIT);
+    engineSetSearchAlgorithm(games[2].engine, SEARCH_PVS);
+    engineSetSymmetricHashing(games[2].engine, !getSymmetricHashing());
+    engineSetSearchEngine(games[2].engine, ENGINE_SOLVER);
+    TEST_ASSERT_EQUAL(1, getSearchThreads());
+    TEST_ASSERT_EQUAL(3, engineGetSearchThreads(games[1].engine));
+    TEST_ASSERT_EQUAL(PARALLEL_LAZY_SMP, getParallelMode());
+
+    ThreadHandle handles[3];
+    for (int i = 0; i < 3; i++)
+        TEST_ASSERT_EQUAL(0, thread_create(&handles[i], engineGameMain, &games[i]));
+    for (int i = 0; i < 3; i++)
+        thread_join(handles[i]);
+
+    for (int i = 0; i < 3; i++)
+    {
+        TEST_ASSERT_EQUAL(moves, games[i].moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(rows, games[i].rows, moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(cols, games[i].cols, moves);
+
+        EngineStats stats;
+        engineGetStats(games[i].engine, &stats);
+        TEST_ASSERT_TRUE(stats.searches > 0);
+        TEST_ASSERT_EQUAL_UINT64(0, stats.book_hits);
+        TEST_ASSERT_NOT_NULL(engineTranspositionTable(games[i].engine)->entries);
+        engineDestroy(games[i].engine);
+    }
+
+    // The default engine is never freed; its table was released by record_game
+    engineDestroy(NULL);
+    engineDestroy(engineDefault());
+    TEST_ASSERT_NULL(engineTranspositionTable(engineDefault())->entries);
+    TEST_ASSERT_EQUAL(1, getSearchThreads());
+#endif
+}
+
+// Test engines run proof-number searches side by side, each in its own table
+void test_proof_number_engines_search_concurrently(void)
+{
+#if BOARD_SIZE <= 4
+    init_win_masks();
+
+    EngineGame games[4];
+    for (int i = 0; i < 4; i++)
+    {
+        games[i].engine = engineCreate(100000);
+        TEST_ASSERT_NOT_NULL(games[i].engine);
+        engineSetSearchEngine(games[i].engine, ENGINE_PROOF_NUMBER);
+        engineSetSolutionTable(games[i].engine, 0); // Search, even on 3x3
+        engineSetProofNumberMemory(games[i].engine, (size_t)1 << 20);
+    }
+    TEST_ASSERT_EQUAL((size_t)1 << 20, engineGetProofNumberMemory(games[0].engine));
+
+    // The first game, alone, is the reference for the three played at once
+    games[0].moves = play_game(games[0].engine, 'x', games[0].rows, games[0].cols);
+    ThreadHandle handles[3];
+    for (int i = 0; i < 3; i++)
+        TEST_ASSERT_EQUAL(0, thread_create(&handles[i], engineGameMain, &games[i + 1]));
+    for (int i = 0; i < 3; i++)
+        thread_join(handles[i]);
+
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_EQUAL(games[0].moves, games[i].moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(games[0].rows, games[i].rows, games[0].moves);
+        TEST_ASSERT_EQUAL_INT_ARRAY(games[0].cols, games[i].cols, games[0].moves);
+
+        EngineStats stats;
+        engineGetStats(games[i].engine, &stats);
+        TEST_ASSERT_TRUE(stats.searches > 0);
+        engineDestroy(games[i].engine);
+    }
+#endif
+}
+
+// Test the solver, the default root driver from 5x5 up, runs on the parallel
+// driver of every mode when threads are set, with the single-threaded result
+void test_solver_uses_parallel_driver(void)
+{
+#if BOARD_SIZE <= 5
+    init_win_masks();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+    bitboard_make_move(&board, 0, 1, 'x');
+#if BOARD_SIZE >= 5
+    // Two more pieces keep the 5x5 solve short
+    bitboard_make_move(&board, 0, 2, 'o');
+    bitboard_make_move(&board, 2, 2, 'x');
+#endif
+
+    static const ParallelMode modes[] = {PARALLEL_LAZY_SMP, PARALLEL_YBWC, PARALLEL_ROOT_SPLIT};
+    RootMoveScore expected[MAX_MOVES];
+    int expected_count = 0;
+    int expected_row = -1, expected_col = -1;
+    for (int k = -1; k < 3; k++)
+    {
+        HyperPruneEngine *engine = engineCreate(100000);
+        TEST_ASSERT_NOT_NULL(engine);
+#if BOARD_SIZE >= 5
+        TEST_ASSERT_EQUAL(ENGINE_SOLVER, engineGetSearchEngine(engine));
+#endif
+        engineSetSearchEngine(engine, ENGINE_SOLVER);
+        engineSetSolutionTable(engine, 0); // Search, even on 3x3
+        if (k >= 0)
+        {
+            engineSetSearchThreads(engine, 4);
+            engineSetParallelMode(engine, modes[k]);
+        }
+
+        int row, col;
+        TEST_ASSERT_EQUAL(0, engineGetAiMove(engine, board, 'o', &row, &col));
+        RootMoveScore scores[MAX_MOVES];
+        int count = engineGetRootMoveScores(engine, scores, MAX_MOVES);
+        EngineStats stats;
+        engineGetStats(engine, &stats);
+        TEST_ASSERT_EQUAL_UINT64(1, stats.searches);
+        TEST_ASSERT_EQUAL_UINT64((k >= 0) ? 1 : 0, stats.parallel_searches);
+
+        if (k < 0)
+        {
+            expected_row = row;
+            expected_col = col;
+            expected_count = count;
+            for (int i = 0; i < count; i++)
+                expected[i] = scores[i];
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL(expected_row, row);
+            TEST_ASSERT_EQUAL(expected_col, col);
+            TEST_ASSERT_EQUAL(expected_count, count);
+            for (int i = 0; i < count; i++)
+            {
+                // The chosen move's score is exact in every mode
+                if (scores[i].row == row && scores[i].col == col)
+                {
+                    TEST_ASSERT_EQUAL(ROOT_SCORE_EXACT, scores[i].bound);
+                    TEST_ASSERT_EQUAL(expected[i].score, scores[i].score);
+                }
+            }
+        }
+        engineDestroy(engine);
+    }
+#endif
+}
+
+// Test a stop request from another thread ends a running search without storing its root
+void test_stop_request_from_another_thread(void)
+{
+    init_win_masks();
+    EngineMove call = {engineCreate(1 << 16), {0, 0}, -1, -1, 0, 0};
+    TEST_ASSERT_NOT_NULL(call.engine);
+    engineSetSymmetricHashing(call.engine, 0); // Plain keys: the root is found by zobrist_hash_r
+    engineSetSolutionTable(call.engine, 0);    // Search, even on 3x3
+    bitboard_make_move(&call.board, 0, 0, 'x');
+
+    ThreadHandle handle;
+    TEST_ASSERT_EQUAL(0, thread_create(&handle, engineMoveMain, &call));
+
+    // Stop once the search has stored something (it may finish first on small boards)
+    const TranspositionTable *table = engineTranspositionTable(call.engine);
+    size_t i = 0;
+    while (!atomic_load_int(&call.done) && atomic_load_u64(&table->entries[i].data) == 0)
+        i = (i + 1) & table->mask;
+    engineRequestStop(call.engine);
+    thread_join(handle);
+
+    TEST_ASSERT_TRUE(bitboard_is_empty(call.board, call.row, call.col));
+    uint64_t root = zobrist_hash_r(engineZobristKeys(call.engine), call.board, 'o');
+    if (call.stopped)
+        TEST_ASSERT_EQUAL(-1, transposition_table_best_move_r(table, root));
+
+    // A request that came too late is used up by the next call, even one without a search
+    Bitboard over = {0, 0};
+    for (int c = 0; c < BOARD_SIZE; c++)
+        bitboard_make_move(&over, 0, c, 'x');
+    int row, col;
+    engineGetAiMove(call.engine, over, 'o', &row, &col);
+    TEST_ASSERT_EQUAL(0, engineGetAiMove(call.engine, call.board, 'o', &row, &col));
+    TEST_ASSERT_NOT_EQUAL(-1, transposition_table_best_move_r(table, root));
+
+    engineDestroy(call.engine);
+}
+
+void test_parallel_search_suite(void)
+{
+    RUN_TEST(test_search_threads_clamped);
+    RUN_TEST(test_lazy_smp_matches_sequential);
+    RUN_TEST(test_lazy_smp_perfect_play_3x3);
+    RUN_TEST(test_ybwc_matches_sequential);
+    RUN_TEST(test_ybwc_root_win_matches_sequential);
+    RUN_TEST(test_root_split_matches_sequential);
+    RUN_TEST(test_root_move_scores_reported);
+    RUN_TEST(test_batch_matches_get_ai_move);
+    RUN_TEST(test_engines_search_concurrently);
+    RUN_TEST(test_proof_number_engines_search_concurrently);
+    RUN_TEST(test_solver_uses_parallel_driver);
+    RUN_TEST(test_stop_request_from_another_thread);
+}
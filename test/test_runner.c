@@ -9,6 +9,11 @@ void test_correctness_suite(void);
 void test_transposition_table_suite(void);
 void test_game_scenarios_suite(void);
 void test_edge_cases_suite(void);
+void test_parallel_search_suite(void);
+void test_budgeted_search_suite(void);
+void test_mcts_suite(void);
+void test_opening_book_suite(void);
+void test_tablebase_suite(void);
 
 void setUp(void)
 {
@@ -45,5 +50,20 @@ int main(void)
     printf("\n=== Correctness Tests ===\n");
     test_correctness_suite();
 
+    printf("\n=== Parallel Search Tests ===\n");
+    test_parallel_search_suite();
+
+    printf("\n=== Budgeted Search Tests ===\n");
+    test_budgeted_search_suite();
+
+    printf("\n=== MCTS Tests ===\n");
+    test_mcts_suite();
+
+    printf("\n=== Opening Book Tests ===\n");
+    test_opening_book_suite();
+
+    printf("\n=== Tablebase Tests ===\n");
+    test_tablebase_suite();
+
     return UNITY_END();
 }
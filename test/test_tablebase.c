@@ -0,0 +1,221 @@
+#include "unity/unity.h"
+#include <stdio.h>
+#include "../src/MiniMax/mini_max.h"
+#include "../src/MiniMax/tablebase.h"
+#include "../src/MiniMax/transposition.h"
+#include "../src/TicTacToe/tic_tac_toe.h"
+
+#define TABLEBASE_TEST_FILE "test_tablebase.tb"
+
+// Test an empty board is a draw and a won board a loss for the side to move
+void test_tablebase_probe(void)
+{
+#if TABLEBASE_SUPPORTED
+    init_win_masks();
+    TEST_ASSERT_EQUAL(0, tablebase_generate(TABLEBASE_TEST_FILE, 2));
+    TEST_ASSERT_EQUAL(0, tablebase_open(TABLEBASE_TEST_FILE));
+    TEST_ASSERT_TRUE(tablebase_is_open());
+
+    int score = 1;
+    Bitboard empty = {0, 0};
+    TEST_ASSERT_EQUAL(1, tablebase_probe(empty, &score));
+    TEST_ASSERT_EQUAL(0, score);
+
+    // X completes row 0, O has one piece less: O to move has lost
+    Bitboard won = {0, 0};
+    for (int c = 0; c < BOARD_SIZE; c++)
+        bitboard_make_move(&won, 0, c, 'x');
+    for (int c = 0; c < BOARD_SIZE - 1; c++)
+        bitboard_make_move(&won, 1, c, 'o');
+    TEST_ASSERT_EQUAL(1, tablebase_probe(won, &score));
+    TEST_ASSERT_EQUAL(-100, score);
+
+    // O ahead of X cannot be reached
+    Bitboard invalid = {0, 0};
+    bitboard_make_move(&invalid, 0, 0, 'o');
+    TEST_ASSERT_EQUAL(0, tablebase_probe(invalid, &score));
+
+    tablebase_close();
+    TEST_ASSERT_FALSE(tablebase_is_open());
+    TEST_ASSERT_EQUAL(0, tablebase_probe(empty, &score));
+#endif
+}
+
+// Test getAiMove picks the same move and root scores from the table as from the search
+void test_tablebase_matches_search(void)
+{
+#if TABLEBASE_SUPPORTED
+    int solution = getSolutionTable();
+    setSolutionTable(0); // Searched, not read from the 3x3 table
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    int compared = 0;
+    for (int game = 0; game < 20; game++)
+    {
+        // Random opening of 1..MAX_MOVES-2 pieces
+        Bitboard board = {0, 0};
+        char current = 'x';
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int pieces = 1 + (int)((state >> 33) % (MAX_MOVES - 2));
+        for (int k = 0; k < pieces; k++)
+        {
+            int cell;
+            do
+            {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                cell = (int)((state >> 33) % MAX_MOVES);
+            } while (!bitboard_is_empty(board, cell / BOARD_SIZE, cell % BOARD_SIZE));
+            bitboard_make_move(&board, cell / BOARD_SIZE, cell % BOARD_SIZE, current);
+            current = (current == 'x') ? 'o' : 'x';
+        }
+        if (bitboard_has_won(board.x_pieces) || bitboard_has_won(board.o_pieces))
+            continue;
+
+        int search_row, search_col, table_row, table_col;
+        RootMoveScore search_scores[MAX_MOVES], table_scores[MAX_MOVES];
+
+        tablebase_close();
+        getAiMove(board, current, &search_row, &search_col);
+        int search_count = getRootMoveScores(search_scores, MAX_MOVES);
+
+        TEST_ASSERT_EQUAL(0, tablebase_open(TABLEBASE_TEST_FILE));
+        getAiMove(board, current, &table_row, &table_col);
+        int table_count = getRootMoveScores(table_scores, MAX_MOVES);
+
+        TEST_ASSERT_EQUAL(search_row, table_row);
+        TEST_ASSERT_EQUAL(search_col, table_col);
+        TEST_ASSERT_EQUAL(search_count, table_count);
+        for (int i = 0; i < search_count; i++)
+        {
+            TEST_ASSERT_EQUAL(ROOT_SCORE_EXACT, table_scores[i].bound);
+            if (search_scores[i].bound == ROOT_SCORE_EXACT)
+                TEST_ASSERT_EQUAL(search_scores[i].score, table_scores[i].score);
+            else if (search_scores[i].bound == ROOT_SCORE_UPPER_BOUND)
+                TEST_ASSERT_TRUE(table_scores[i].score <= search_scores[i].score);
+        }
+        compared++;
+    }
+    TEST_ASSERT_TRUE(compared > 0);
+
+    tablebase_close();
+    transposition_table_free();
+    setSolutionTable(solution);
+#endif
+}
+
+#if SOLUTION_TABLE_SUPPORTED
+/*
+ * Compare getAiMove with and without the solution table on board and every
+ * position after it. Returns the number of positions compared.
+ */
+static int solutionTableCompare(Bitboard board, char player)
+{
+    int empty = 0;
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+        empty += bitboard_is_empty(board, BIT_TO_ROW(cell), BIT_TO_COL(cell));
+    if (bitboard_has_won(board.x_pieces) || bitboard_has_won(board.o_pieces) || empty <= 1)
+        return 0; // Over, or a single move: answered before either
+
+    int compared = 0;
+    char next = (player == 'x') ? 'o' : 'x';
+    for (int cell = 0; cell < MAX_MOVES; cell++)
+    {
+        if (!bitboard_is_empty(board, BIT_TO_ROW(cell), BIT_TO_COL(cell)))
+            continue;
+        Bitboard child = board;
+        bitboard_make_move(&child, BIT_TO_ROW(cell), BIT_TO_COL(cell), player);
+        compared += solutionTableCompare(child, next);
+    }
+    if (board.x_pieces == 0 && board.o_pieces == 0)
+        return compared; // The empty board is answered before either
+
+    int search_row, search_col, table_row, table_col;
+    RootMoveScore search_scores[MAX_MOVES], table_scores[MAX_MOVES];
+
+    setSolutionTable(0);
+    getAiMove(board, player, &search_row, &search_col);
+    int search_count = getRootMoveScores(search_scores, MAX_MOVES);
+
+    setSolutionTable(1);
+    EngineStats before, after;
+    engineGetStats(engineDefault(), &before);
+    getAiMove(board, player, &table_row, &table_col);
+    engineGetStats(engineDefault(), &after);
+    int table_count = getRootMoveScores(table_scores, MAX_MOVES);
+
+    TEST_ASSERT_EQUAL_UINT64(before.searches, after.searches);
+    TEST_ASSERT_EQUAL_UINT64(before.tablebase_hits, after.tablebase_hits);
+    TEST_ASSERT_EQUAL_UINT64(before.solution_table_hits + 1, after.solution_table_hits);
+    TEST_ASSERT_EQUAL(search_row, table_row);
+    TEST_ASSERT_EQUAL(search_col, table_col);
+    TEST_ASSERT_EQUAL(search_count, table_count);
+    for (int i = 0; i < search_count; i++)
+    {
+        TEST_ASSERT_EQUAL(search_scores[i].row, table_scores[i].row);
+        TEST_ASSERT_EQUAL(search_scores[i].col, table_scores[i].col);
+        TEST_ASSERT_EQUAL(ROOT_SCORE_EXACT, table_scores[i].bound);
+        if (search_scores[i].bound == ROOT_SCORE_EXACT)
+            TEST_ASSERT_EQUAL(search_scores[i].score, table_scores[i].score);
+        else if (search_scores[i].bound == ROOT_SCORE_UPPER_BOUND)
+            TEST_ASSERT_TRUE(table_scores[i].score <= search_scores[i].score);
+    }
+    return compared + 1;
+}
+#endif
+
+// Test the 3x3 solution table plays the searched move in every position, without searching
+void test_solution_table_matches_search(void)
+{
+#if SOLUTION_TABLE_SUPPORTED
+    init_win_masks();
+    zobrist_init();
+    transposition_table_init(100000);
+    int enabled = getSolutionTable();
+
+    TEST_ASSERT_TRUE(solutionTableCompare((Bitboard){0, 0}, 'x') > 4000);
+
+    // Not the side to move by the piece counts: searched
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    EngineStats before, after;
+    engineGetStats(engineDefault(), &before);
+    int row, col;
+    getAiMove(board, 'x', &row, &col);
+    engineGetStats(engineDefault(), &after);
+    TEST_ASSERT_EQUAL_UINT64(before.searches + 1, after.searches);
+    TEST_ASSERT_EQUAL_UINT64(before.solution_table_hits, after.solution_table_hits);
+
+    setSolutionTable(enabled);
+    transposition_table_free();
+#endif
+}
+
+// Test missing, foreign and unsupported files are rejected
+void test_tablebase_rejects_bad_files(void)
+{
+    init_win_masks();
+    TEST_ASSERT_EQUAL(-1, tablebase_open("test_tablebase_missing.tb"));
+
+    FILE *file = fopen(TABLEBASE_TEST_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    fputs("not a tablebase", file);
+    fclose(file);
+    TEST_ASSERT_EQUAL(-1, tablebase_open(TABLEBASE_TEST_FILE));
+    TEST_ASSERT_FALSE(tablebase_is_open());
+
+#if !TABLEBASE_SUPPORTED
+    TEST_ASSERT_EQUAL(-1, tablebase_generate(TABLEBASE_TEST_FILE, 1));
+#endif
+    remove(TABLEBASE_TEST_FILE);
+}
+
+void test_tablebase_suite(void)
+{
+    RUN_TEST(test_tablebase_probe);
+    RUN_TEST(test_tablebase_matches_search);
+    RUN_TEST(test_solution_table_matches_search);
+    RUN_TEST(test_tablebase_rejects_bad_files);
+}
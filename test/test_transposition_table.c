@@ -171,7 +171,7 @@ void test_tt_hash_collision(void)
     transposition_table_free();
 }
 
-// Test different aiPlayer produces different hashes
+// Test different side to move produces different hashes
 void test_zobrist_different_aiplayer(void)
 {
     zobrist_set_seed(42);
@@ -184,7 +184,7 @@ void test_zobrist_different_aiplayer(void)
     uint64_t hash_x = zobrist_hash(board, 'x');
     uint64_t hash_o = zobrist_hash(board, 'o');
 
-    // Same position, different maximizing player -> different hash
+    // Same pieces, different side to move -> different hash
     TEST_ASSERT_NOT_EQUAL_UINT64(hash_x, hash_o);
 }
 
@@ -290,6 +290,110 @@ void test_tt_non_power_of_two_sizes(void)
     transposition_table_free();
 }
 
+// Test depth-limited entries only answer probes of equal or smaller depth
+void test_tt_depth_limited_entries(void)
+{
+    zobrist_set_seed(42);
+    zobrist_init();
+    transposition_table_init(1000);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 1, 1, 'x');
+    uint64_t hash = zobrist_hash(board, 'o');
+
+    int score;
+    transposition_table_store_depth(hash, 3, 7, TRANSPOSITION_TABLE_EXACT);
+
+    TEST_ASSERT_EQUAL(1, transposition_table_probe_depth(hash, 2, -100, 100, &score));
+    TEST_ASSERT_EQUAL(7, score);
+    TEST_ASSERT_EQUAL(1, transposition_table_probe_depth(hash, 3, -100, 100, &score));
+    TEST_ASSERT_EQUAL(0, transposition_table_probe_depth(hash, 4, -100, 100, &score));
+
+    // A full-depth probe never uses a heuristic result
+    TEST_ASSERT_EQUAL(0, transposition_table_probe(hash, -100, 100, &score));
+
+    // A full-depth entry answers every depth
+    transposition_table_store(hash, 0, TRANSPOSITION_TABLE_EXACT);
+    TEST_ASSERT_EQUAL(1, transposition_table_probe_depth(hash, 1, -100, 100, &score));
+    TEST_ASSERT_EQUAL(0, score);
+
+    transposition_table_free();
+}
+
+// Test the best move is stored with an entry and reported even without a cutoff
+void test_tt_best_move(void)
+{
+    zobrist_set_seed(42);
+    zobrist_init();
+    transposition_table_init(1000);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    uint64_t hash = zobrist_hash(board, 'o');
+
+    int score, move;
+    TEST_ASSERT_EQUAL(0, transposition_table_probe_move(hash, 1, -100, 100, &score, &move));
+    TEST_ASSERT_EQUAL(-1, move);
+    TEST_ASSERT_EQUAL(-1, transposition_table_best_move(hash));
+
+    int cell = POS_TO_BIT(BOARD_SIZE - 1, BOARD_SIZE - 1);
+    transposition_table_store_move(hash, 2, 5, TRANSPOSITION_TABLE_LOWERBOUND, cell);
+
+    // Bound does not cut off, draft too shallow: no score, but the move is known
+    TEST_ASSERT_EQUAL(0, transposition_table_probe_move(hash, 2, -100, 100, &score, &move));
+    TEST_ASSERT_EQUAL(cell, move);
+    TEST_ASSERT_EQUAL(0, transposition_table_probe_move(hash, 3, -100, 0, &score, &move));
+    TEST_ASSERT_EQUAL(cell, move);
+    TEST_ASSERT_EQUAL(1, transposition_table_probe_move(hash, 2, -100, 5, &score, &move));
+    TEST_ASSERT_EQUAL(5, score);
+    TEST_ASSERT_EQUAL(cell, transposition_table_best_move(hash));
+
+    // Entries stored without a move report none
+    transposition_table_store_depth(hash, 2, 5, TRANSPOSITION_TABLE_EXACT);
+    TEST_ASSERT_EQUAL(-1, transposition_table_best_move(hash));
+
+    transposition_table_free();
+}
+
+// Test explicit keys match the default keys of the same seed and tables do not share entries
+void test_tt_reentrant_tables(void)
+{
+    zobrist_set_seed(42);
+    zobrist_init();
+    transposition_table_init(1000);
+
+    static ZobristKeys keys;
+    zobrist_set_seed_r(&keys, 42);
+    zobrist_init_r(&keys);
+    TranspositionTable table = {NULL, 0, 0};
+    transposition_table_init_r(&table, 1000);
+    TEST_ASSERT_EQUAL(1024, table.size);
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    uint64_t hash = zobrist_hash(board, 'o');
+    TEST_ASSERT_EQUAL_UINT64(hash, zobrist_hash_r(&keys, board, 'o'));
+    TEST_ASSERT_EQUAL_UINT64(zobrist_toggle_turn(zobrist_toggle(hash, 1, 1, 'o')),
+                             zobrist_toggle_turn_r(&keys, zobrist_toggle_r(&keys, hash, 1, 1, 'o')));
+
+    int score, move;
+    transposition_table_store_move_r(&table, hash, 3, 7, TRANSPOSITION_TABLE_EXACT, 4);
+    TEST_ASSERT_EQUAL(1, transposition_table_probe_move_r(&table, hash, 3, -100, 100, &score, &move));
+    TEST_ASSERT_EQUAL(7, score);
+    TEST_ASSERT_EQUAL(4, move);
+    TEST_ASSERT_EQUAL(0, transposition_table_probe_depth(hash, 3, -100, 100, &score));
+
+    transposition_table_store(hash, -5, TRANSPOSITION_TABLE_EXACT);
+    TEST_ASSERT_EQUAL(1, transposition_table_probe_depth_r(&table, hash, 3, -100, 100, &score));
+    TEST_ASSERT_EQUAL(7, score);
+
+    transposition_table_free_r(&table);
+    TEST_ASSERT_NULL(table.entries);
+    TEST_ASSERT_EQUAL(0, transposition_table_probe_r(&table, hash, -100, 100, &score));
+    TEST_ASSERT_EQUAL(1, transposition_table_probe(hash, -100, 100, &score));
+    transposition_table_free();
+}
+
 void test_transposition_table_suite(void)
 {
     RUN_TEST(test_tt_store_and_probe);
@@ -304,4 +408,7 @@ void test_transposition_table_suite(void)
     RUN_TEST(test_tt_cutoff_equality);
     RUN_TEST(test_tt_multiple_reinit);
     RUN_TEST(test_tt_non_power_of_two_sizes);
+    RUN_TEST(test_tt_depth_limited_entries);
+    RUN_TEST(test_tt_best_move);
+    RUN_TEST(test_tt_reentrant_tables);
 }
@@ -42,6 +42,20 @@ void test_turn_toggle_changes_hash(void)
     TEST_ASSERT_EQUAL_UINT64(hash1, hash3);
 }
 
+// Test a turn toggle hands the move to the other side (shared TT entries)
+void test_turn_toggle_swaps_side(void)
+{
+    zobrist_set_seed(42);
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    bitboard_make_move(&board, 0, 0, 'x');
+    bitboard_make_move(&board, 1, 1, 'o');
+
+    TEST_ASSERT_EQUAL_UINT64(zobrist_hash(board, 'o'), zobrist_toggle_turn(zobrist_hash(board, 'x')));
+    TEST_ASSERT_EQUAL_UINT64(zobrist_hash(board, 'x'), zobrist_toggle_turn(zobrist_hash(board, 'o')));
+}
+
 // Test same position produces same hash
 void test_same_position_same_hash(void)
 {
@@ -107,11 +121,53 @@ void test_zobrist_toggle_symmetry(void)
     TEST_ASSERT_EQUAL_UINT64(original_hash, hash);
 }
 
+// Test symmetric hashes: plain hash first, same canonical key for a rotated board, incremental updates
+void test_symmetric_hash(void)
+{
+    zobrist_set_seed(42);
+    zobrist_init();
+
+    Bitboard board = {0, 0};
+    Bitboard rotated = {0, 0}; // board turned 90 degrees clockwise: (r, c) -> (c, n - r)
+    const int n = BOARD_SIZE - 1;
+    bitboard_make_move(&board, 0, 1, 'x');
+    bitboard_make_move(&rotated, 1, n, 'x');
+    bitboard_make_move(&board, n, n, 'o');
+    bitboard_make_move(&rotated, n, 0, 'o');
+
+    ZobristSymmetricHash hash, rotated_hash;
+    zobrist_symmetric_hash(board, 'x', &hash);
+    zobrist_symmetric_hash(rotated, 'x', &rotated_hash);
+    TEST_ASSERT_EQUAL_UINT64(zobrist_hash(board, 'x'), hash.keys[0]);
+
+    int symmetry, rotated_symmetry;
+    uint64_t key = zobrist_canonical(&hash, &symmetry);
+    TEST_ASSERT_EQUAL_UINT64(key, zobrist_canonical(&rotated_hash, &rotated_symmetry));
+    TEST_ASSERT_NOT_EQUAL(zobrist_hash(board, 'x'), zobrist_hash(rotated, 'x'));
+
+    // A move stored in the canonical frame maps back to the matching cell of each board
+    int cell = POS_TO_BIT(0, 1);
+    int rotated_cell = POS_TO_BIT(1, n);
+    int stored = zobrist_symmetry_map(symmetry, cell);
+    TEST_ASSERT_EQUAL(cell, zobrist_symmetry_unmap(symmetry, stored));
+    TEST_ASSERT_EQUAL(rotated_cell, zobrist_symmetry_unmap(rotated_symmetry, stored));
+    TEST_ASSERT_EQUAL(-1, zobrist_symmetry_map(symmetry, -1));
+
+    // Incremental move (piece + turn) matches a full recomputation
+    zobrist_symmetric_toggle(&hash, 1, 1, 'x', 1);
+    bitboard_make_move(&board, 1, 1, 'x');
+    ZobristSymmetricHash full;
+    zobrist_symmetric_hash(board, 'o', &full);
+    TEST_ASSERT_EQUAL_MEMORY(full.keys, hash.keys, sizeof(full.keys));
+}
+
 void test_zobrist_suite(void)
 {
     RUN_TEST(test_incremental_hash_matches_full);
     RUN_TEST(test_turn_toggle_changes_hash);
+    RUN_TEST(test_turn_toggle_swaps_side);
     RUN_TEST(test_same_position_same_hash);
     RUN_TEST(test_zobrist_seed_boundaries);
     RUN_TEST(test_zobrist_toggle_symmetry);
+    RUN_TEST(test_symmetric_hash);
 }